@@ -0,0 +1,118 @@
+/**
+ * @file pack.c
+ * @author ItsHighNoon
+ * @date 10-17-2026
+ * 
+ * @copyright Copyright (c) 2026
+ */
+
+#include "pack.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "os/file.h"
+#include "util/util.h"
+
+// Everything later lookups trust, so a truncated or foreign file fails here instead of reading out of bounds
+static int check_table(const FA_Pack* pack) {
+    const FA_PackHeader* header = pack->header;
+    if (header->magic != FA_PACK_MAGIC || header->version != FA_PACK_VERSION || header->file_size != pack->size) {
+        return 1;
+    }
+
+    uint64_t entries_end = sizeof(FA_PackHeader) + (uint64_t)header->entry_count * sizeof(FA_PackEntry);
+    if (entries_end > header->names_offset || header->names_offset > pack->size ||
+        header->names_size > pack->size - header->names_offset) {
+        return 1;
+    }
+    if (header->names_size == 0 || pack->names[header->names_size - 1] != '\0') {
+        return 1;
+    }
+
+    for (uint32_t entry_idx = 0; entry_idx < header->entry_count; entry_idx++) {
+        const FA_PackEntry* entry = &pack->entries[entry_idx];
+        if (entry->offset % FA_PACK_ALIGNMENT != 0 || entry->offset > pack->size ||
+            entry->size > pack->size - entry->offset || entry->name_offset >= header->names_size) {
+            return 1;
+        }
+        // Lookups binary search the hashes
+        if (entry_idx > 0 && pack->entries[entry_idx - 1].name_hash >= entry->name_hash) {
+            return 1;
+        }
+        if (entry->type == FA_PACK_MESH &&
+            ((uint64_t)entry->mesh.index_offset + (uint64_t)entry->mesh.index_count * sizeof(uint32_t) > entry->size ||
+             (uint64_t)entry->mesh.vertex_count * entry->mesh.vertex_stride > entry->mesh.index_offset)) {
+            return 1;
+        }
+        if (entry->type == FA_PACK_TEXTURE && (entry->texture.format != FA_PACK_FORMAT_RGBA8_SRGB ||
+                                               (uint64_t)entry->texture.width * entry->texture.height * 4 > entry->size)) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+int fa_pack_open(FA_Pack* pack, const char* path) {
+    memset(pack, 0, sizeof(FA_Pack));
+
+    size_t size;
+    const void* data = _fa_os_map_file(path, &size);
+    if (data == NULL) {
+        printf("Failed to map %s :(\n", path);
+        return 1;
+    }
+    if (size < sizeof(FA_PackHeader)) {
+        printf("%s is not an asset pack :(\n", path);
+        _fa_os_unmap_file(data, size);
+        return 1;
+    }
+
+    pack->data = data;
+    pack->size = size;
+    pack->header = data;
+    pack->entries = (const FA_PackEntry*)(pack->data + sizeof(FA_PackHeader));
+    pack->names = (const char*)(pack->data + pack->header->names_offset);
+    if (check_table(pack) != 0) {
+        printf("%s is not an asset pack of version %d :(\n", path, FA_PACK_VERSION);
+        _fa_os_unmap_file(data, size);
+        memset(pack, 0, sizeof(FA_Pack));
+        return 1;
+    }
+    return 0;
+}
+
+void fa_pack_close(FA_Pack* pack) {
+    if (pack->data != NULL) {
+        _fa_os_unmap_file(pack->data, pack->size);
+    }
+    memset(pack, 0, sizeof(FA_Pack));
+}
+
+const FA_PackEntry* fa_pack_find(const FA_Pack* pack, const char* name) {
+    uint64_t hash = fa_util_hash(name);
+    uint32_t low = 0;
+    uint32_t high = pack->header->entry_count;
+    while (low < high) {
+        uint32_t middle = low + (high - low) / 2;
+        uint64_t middle_hash = pack->entries[middle].name_hash;
+        if (middle_hash < hash) {
+            low = middle + 1;
+        } else if (middle_hash > hash) {
+            high = middle;
+        } else {
+            // The packer rejects colliding names, but a name which is not in the pack can still share a hash
+            const FA_PackEntry* entry = &pack->entries[middle];
+            return strcmp(fa_pack_name(pack, entry), name) == 0 ? entry : NULL;
+        }
+    }
+    return NULL;
+}
+
+const void* fa_pack_data(const FA_Pack* pack, const FA_PackEntry* entry) {
+    return pack->data + entry->offset;
+}
+
+const char* fa_pack_name(const FA_Pack* pack, const FA_PackEntry* entry) {
+    return pack->names + entry->name_offset;
+}
\ No newline at end of file
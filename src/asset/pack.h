@@ -0,0 +1,122 @@
+/**
+ * @file pack.h
+ * @author ItsHighNoon
+ * @date 10-17-2026
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ * Asset packs, single files holding the meshes, textures and shaders of the application. A pack is mapped into memory
+ * as is, so loading an asset means finding its entry and handing out a pointer into the mapping, which can go straight
+ * to the staging ring without being read or parsed first. Packs are written by tools/pack.c.
+ *
+ * The file starts with an FA_PackHeader, followed by the entries sorted by name hash and a table of null terminated
+ * names. Every payload starts on an FA_PACK_ALIGNMENT boundary, so each asset covers whole pages and can be paged in
+ * without touching its neighbours. All fields are host endian, packs are built on the machine they are used on.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// "FAPK" read as a little endian word
+#define FA_PACK_MAGIC 0x4b504146
+#define FA_PACK_VERSION 1
+#define FA_PACK_ALIGNMENT 4096
+
+typedef enum {
+    // Vertices followed by 32 bit indices
+    FA_PACK_MESH = 1,
+    // Tightly packed texels of the first mip level
+    FA_PACK_TEXTURE = 2,
+    // A SPIR-V module
+    FA_PACK_SHADER = 3,
+} FA_PackAssetType;
+
+typedef enum {
+    FA_PACK_FORMAT_RGBA8_SRGB = 1,
+} FA_PackTextureFormat;
+
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t entry_count;
+    uint32_t names_size;
+    // The entries start right after the header
+    uint64_t names_offset;
+    uint64_t file_size;
+} FA_PackHeader;
+
+typedef struct {
+    // fa_util_hash of the name, unique within the pack
+    uint64_t name_hash;
+    // Where the name starts in the name table
+    uint32_t name_offset;
+    // An FA_PackAssetType
+    uint32_t type;
+    // From the start of the file, a multiple of FA_PACK_ALIGNMENT
+    uint64_t offset;
+    uint64_t size;
+    union {
+        struct {
+            uint32_t vertex_count;
+            uint32_t vertex_stride;
+            uint32_t index_count;
+            // From the start of the payload, the indices end the payload
+            uint32_t index_offset;
+        } mesh;
+        struct {
+            uint32_t width;
+            uint32_t height;
+            // An FA_PackTextureFormat
+            uint32_t format;
+            uint32_t padding;
+        } texture;
+    };
+} FA_PackEntry;
+
+typedef struct {
+    const unsigned char* data;
+    size_t size;
+    const FA_PackHeader* header;
+    const FA_PackEntry* entries;
+    const char* names;
+} FA_Pack;
+
+/**
+ * Map a pack and check that its table of contents is well formed. Payloads are not read until they are used.
+ * @param pack Filled in with the pack.
+ * @param path The path of the pack. Assumed to be null terminated.
+ * @return 0 on success, 1 if the file could not be mapped or is not a pack of this version.
+ */
+int fa_pack_open(FA_Pack* pack, const char* path);
+
+/**
+ * Unmap a pack. Pointers into the pack are invalid afterwards.
+ * @param pack The pack to close.
+ */
+void fa_pack_close(FA_Pack* pack);
+
+/**
+ * Look up an asset by name.
+ * @param pack The pack to search.
+ * @param name The name the asset was packed with. Assumed to be null terminated.
+ * @return The entry of the asset, or NULL if the pack does not have it.
+ */
+const FA_PackEntry* fa_pack_find(const FA_Pack* pack, const char* name);
+
+/**
+ * Get the payload of an asset. The pages are read from disk on first access, see _fa_os_prefetch to read them early.
+ * @param pack The pack the entry is from.
+ * @param entry The entry of the asset.
+ * @return A pointer to entry->size bytes, valid until the pack is closed.
+ */
+const void* fa_pack_data(const FA_Pack* pack, const FA_PackEntry* entry);
+
+/**
+ * Get the name of an asset.
+ * @param pack The pack the entry is from.
+ * @param entry The entry of the asset.
+ * @return The null terminated name, valid until the pack is closed.
+ */
+const char* fa_pack_name(const FA_Pack* pack, const FA_PackEntry* entry);
\ No newline at end of file
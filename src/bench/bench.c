@@ -0,0 +1,207 @@
+/**
+ * @file bench.c
+ * @author ItsHighNoon
+ * @date 10-17-2026
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ * Entry point of the benchmarks.
+ *
+ *     fa_bench [--repeat N] [--json PATH] [--compare PATH] [--threshold PERCENT] [GROUP...]
+ *
+ * Runs the named groups, or all of them. Each group runs N times and every benchmark keeps its fastest run, which is
+ * far more stable between runs than an average. --json writes the results, and --compare reads results written by an
+ * earlier run and flags every benchmark which got slower by more than the threshold, 10% by default. The exit status
+ * is 1 if anything regressed and 2 on bad arguments or files, so a script can run the benchmarks of two commits and
+ * compare them.
+ */
+
+#include "bench.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "os/file.h"
+
+#define DEFAULT_THRESHOLD 10.0
+
+struct BenchResult {
+    char name[FA_BENCH_MAX_NAME];
+    double seconds;
+    long iterations;
+};
+
+struct BenchGroup {
+    const char* name;
+    void (*run)();
+};
+
+static const struct BenchGroup GROUPS[] = {
+    { "hash", fa_bench_hash },
+    { "jobs", fa_bench_jobs },
+    { "options", fa_bench_options },
+    { "record", fa_bench_record },
+    { "vk", fa_bench_vk }
+};
+
+static struct BenchResult* results;
+static int results_len;
+static int results_capacity;
+
+static double ns_per_op(const struct BenchResult* result) {
+    return result->seconds * 1e9 / result->iterations;
+}
+
+void fa_bench_report(const char* name, double seconds, long iterations) {
+    printf("%-40s %12.3f ms %12.1f ns/op\n", name, seconds * 1e3, seconds * 1e9 / iterations);
+
+    // Repeated runs of the same benchmark keep the fastest
+    for (int result_idx = 0; result_idx < results_len; result_idx++) {
+        if (strcmp(results[result_idx].name, name) == 0) {
+            if (seconds / iterations < results[result_idx].seconds / results[result_idx].iterations) {
+                results[result_idx].seconds = seconds;
+                results[result_idx].iterations = iterations;
+            }
+            return;
+        }
+    }
+
+    if (results_len == results_capacity) {
+        results_capacity = results_capacity ? results_capacity * 2 : 64;
+        results = realloc(results, results_capacity * sizeof(struct BenchResult));
+    }
+    struct BenchResult* result = &results[results_len++];
+    snprintf(result->name, sizeof(result->name), "%s", name);
+    result->seconds = seconds;
+    result->iterations = iterations;
+}
+
+static int write_json(const char* path) {
+    FILE* file = fopen(path, "w");
+    if (file == NULL) {
+        printf("Failed to open %s :(\n", path);
+        return 1;
+    }
+
+    fprintf(file, "{\"benchmarks\":[\n");
+    for (int result_idx = 0; result_idx < results_len; result_idx++) {
+        fprintf(file, "{\"name\":\"%s\",\"seconds\":%.9g,\"iterations\":%ld,\"ns_per_op\":%.6g}%s\n",
+                results[result_idx].name, results[result_idx].seconds, results[result_idx].iterations,
+                ns_per_op(&results[result_idx]), result_idx + 1 < results_len ? "," : "");
+    }
+    fprintf(file, "]}\n");
+    fclose(file);
+    return 0;
+}
+
+/*
+ * Only reads what write_json writes, so it looks for the name and ns_per_op keys of each entry instead of parsing
+ * JSON properly.
+ */
+static int compare_json(const char* path, double threshold) {
+    size_t size;
+    const char* data = _fa_os_map_file(path, &size);
+    if (data == NULL) {
+        printf("Failed to read %s :(\n", path);
+        return 2;
+    }
+    char* text = malloc(size + 1);
+    memcpy(text, data, size);
+    text[size] = '\0';
+    _fa_os_unmap_file(data, size);
+
+    printf("\n%-40s %12s %12s %9s\n", "compared to baseline", "old ns/op", "new ns/op", "change");
+    int regressions = 0;
+    const char* cursor = text;
+    while ((cursor = strstr(cursor, "\"name\":\"")) != NULL) {
+        cursor += strlen("\"name\":\"");
+        const char* name_end = strchr(cursor, '"');
+        const char* value = strstr(cursor, "\"ns_per_op\":");
+        if (name_end == NULL || value == NULL || name_end - cursor >= FA_BENCH_MAX_NAME) {
+            break;
+        }
+        char name[FA_BENCH_MAX_NAME];
+        memcpy(name, cursor, name_end - cursor);
+        name[name_end - cursor] = '\0';
+        double old_ns = strtod(value + strlen("\"ns_per_op\":"), NULL);
+        cursor = name_end;
+
+        for (int result_idx = 0; result_idx < results_len; result_idx++) {
+            if (strcmp(results[result_idx].name, name) != 0) {
+                continue;
+            }
+
+            double new_ns = ns_per_op(&results[result_idx]);
+            double change = old_ns > 0.0 ? (new_ns - old_ns) * 100.0 / old_ns : 0.0;
+            int regressed = change > threshold;
+            regressions += regressed;
+            printf("%-40s %12.1f %12.1f %+8.1f%%%s\n", name, old_ns, new_ns, change, regressed ? " REGRESSED" : "");
+            break;
+        }
+    }
+    free(text);
+
+    if (regressions > 0) {
+        printf("%d benchmarks regressed by more than %.1f%%\n", regressions, threshold);
+        return 1;
+    }
+    return 0;
+}
+
+static int group_selected(const char* group, int argc, char** argv, int first_group_arg) {
+    if (first_group_arg == argc) {
+        return 1;
+    }
+    for (int arg_idx = first_group_arg; arg_idx < argc; arg_idx++) {
+        if (strcmp(argv[arg_idx], group) == 0) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    int repeat = 1;
+    const char* json_path = NULL;
+    const char* compare_path = NULL;
+    double threshold = DEFAULT_THRESHOLD;
+
+    int arg_idx = 1;
+    for (; arg_idx < argc && strncmp(argv[arg_idx], "--", 2) == 0; arg_idx++) {
+        if (arg_idx + 1 == argc) {
+            printf("Missing value for %s :(\n", argv[arg_idx]);
+            return 2;
+        }
+        if (strcmp(argv[arg_idx], "--repeat") == 0) {
+            repeat = atoi(argv[++arg_idx]);
+        } else if (strcmp(argv[arg_idx], "--json") == 0) {
+            json_path = argv[++arg_idx];
+        } else if (strcmp(argv[arg_idx], "--compare") == 0) {
+            compare_path = argv[++arg_idx];
+        } else if (strcmp(argv[arg_idx], "--threshold") == 0) {
+            threshold = atof(argv[++arg_idx]);
+        } else {
+            printf("Unknown argument %s :(\n", argv[arg_idx]);
+            return 2;
+        }
+    }
+
+    for (int repeat_idx = 0; repeat_idx < repeat; repeat_idx++) {
+        for (int group_idx = 0; group_idx < sizeof(GROUPS) / sizeof(struct BenchGroup); group_idx++) {
+            if (group_selected(GROUPS[group_idx].name, argc, argv, arg_idx)) {
+                GROUPS[group_idx].run();
+            }
+        }
+    }
+
+    int status = 0;
+    if (json_path != NULL && write_json(json_path) != 0) {
+        status = 2;
+    }
+    if (compare_path != NULL && status == 0) {
+        status = compare_json(compare_path, threshold);
+    }
+    free(results);
+    return status;
+}
\ No newline at end of file
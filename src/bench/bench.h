@@ -0,0 +1,32 @@
+/**
+ * @file bench.h
+ * @author ItsHighNoon
+ * @date 10-17-2026
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ * Microbenchmarks for engine subsystems, built as the fa_bench executable.
+ */
+
+#pragma once
+
+// Longer benchmark names are cut off in the results
+#define FA_BENCH_MAX_NAME 64
+
+/**
+ * Report the result of one benchmark. Results are collected for --json and --compare, see bench.c.
+ * @param name The name of the benchmark. Assumed to be null terminated.
+ * @param seconds How long the benchmark took in total.
+ * @param iterations How many operations were timed, used to report the time per operation.
+ */
+void fa_bench_report(const char* name, double seconds, long iterations);
+
+void fa_bench_hash();
+
+void fa_bench_jobs();
+
+void fa_bench_options();
+
+void fa_bench_record();
+
+void fa_bench_vk();
\ No newline at end of file
@@ -0,0 +1,110 @@
+/**
+ * @file bench_hash.c
+ * @author ItsHighNoon
+ * @date 10-17-2026
+ * 
+ * @copyright Copyright (c) 2026
+ */
+
+#include "bench.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "util/util.h"
+
+#define NAMES 65536
+#define NAME_LENGTH 96
+#define HASH_ROUNDS 50
+#define BUCKET_BITS 12
+#define BUCKETS (1 << BUCKET_BITS)
+
+// The byte at a time djb2 fa_util_hash used to be, kept as a baseline
+static unsigned long djb2(const char* string) {
+    unsigned long hash = 5381;
+    char c;
+    while ((c = *string++)) {
+        hash = ((hash << 5) + hash) + c;
+    }
+    return hash;
+}
+
+static char (*make_names())[NAME_LENGTH] {
+    char (*names)[NAME_LENGTH] = malloc(NAMES * sizeof(*names));
+    for (int name_idx = 0; name_idx < NAMES; name_idx++) {
+        // Dotted names with a lot of shared structure, like real option names
+        switch (name_idx % 4) {
+        case 0:
+            sprintf(names[name_idx], "r.%d", name_idx);
+            break;
+        case 1:
+            sprintf(names[name_idx], "window.monitor%d.width", name_idx);
+            break;
+        case 2:
+            sprintf(names[name_idx], "render.pass%d.attachment%d.format", name_idx % 64, name_idx);
+            break;
+        default:
+            sprintf(names[name_idx], "gameplay.entities.archetype%d.components.transform.interpolation", name_idx);
+            break;
+        }
+    }
+    return names;
+}
+
+static void bench_speed(char (*names)[NAME_LENGTH], const char* label, unsigned long (*hash)(const char*)) {
+    // Accumulate so the compiler cannot skip the calls
+    unsigned long sink = 0;
+    double start = fa_util_time();
+    for (int round_idx = 0; round_idx < HASH_ROUNDS; round_idx++) {
+        for (int name_idx = 0; name_idx < NAMES; name_idx++) {
+            sink += hash(names[name_idx]);
+        }
+    }
+    double seconds = fa_util_time() - start;
+
+    char name[64];
+    sprintf(name, "hash/speed/%s", label);
+    fa_bench_report(name, seconds, (long)HASH_ROUNDS * NAMES + (sink & 0));
+}
+
+/*
+ * Reduce every hash to a power of two bucket count by masking, which is what the options index and intern table do,
+ * and compare the bucket loads against a uniform distribution. A chi squared over degrees of freedom near 1 is uniform.
+ */
+static void bench_distribution(char (*names)[NAME_LENGTH], const char* label, unsigned long (*hash)(const char*)) {
+    int* buckets = calloc(BUCKETS, sizeof(int));
+    for (int name_idx = 0; name_idx < NAMES; name_idx++) {
+        buckets[hash(names[name_idx]) & (BUCKETS - 1)]++;
+    }
+
+    double expected = (double)NAMES / BUCKETS;
+    double chi_squared = 0.0;
+    int max_load = 0;
+    int empty = 0;
+    for (int bucket_idx = 0; bucket_idx < BUCKETS; bucket_idx++) {
+        double difference = buckets[bucket_idx] - expected;
+        chi_squared += difference * difference / expected;
+        if (buckets[bucket_idx] > max_load) {
+            max_load = buckets[bucket_idx];
+        }
+        if (buckets[bucket_idx] == 0) {
+            empty++;
+        }
+    }
+    free(buckets);
+
+    printf("hash/distribution/%-21s chi2/dof %8.3f, max load %4d (expected %.0f), %d empty buckets\n",
+        label, chi_squared / (BUCKETS - 1), max_load, expected, empty);
+}
+
+void fa_bench_hash() {
+    char (*names)[NAME_LENGTH] = make_names();
+
+    bench_speed(names, "djb2", djb2);
+    bench_speed(names, "fa_util_hash", fa_util_hash);
+    bench_distribution(names, "djb2", djb2);
+    bench_distribution(names, "fa_util_hash", fa_util_hash);
+
+    free(names);
+}
\ No newline at end of file
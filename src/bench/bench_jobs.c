@@ -0,0 +1,88 @@
+/**
+ * @file bench_jobs.c
+ * @author ItsHighNoon
+ * @date 10-17-2026
+ * 
+ * @copyright Copyright (c) 2026
+ */
+
+#include "bench.h"
+
+#include <stdio.h>
+#include <unistd.h>
+
+#include "util/jobs.h"
+#include "util/options.h"
+#include "util/util.h"
+
+#define JOBS 1000000
+#define JOBS_PER_BATCH 1024
+#define WORK_ROUNDS 2000
+
+static volatile unsigned long sink;
+
+static void empty_job(void* data) {
+}
+
+// A couple of microseconds of arithmetic, roughly the size of a small culling or animation job
+static void work_job(void* data) {
+    unsigned long state = (unsigned long)data;
+    for (int round_idx = 0; round_idx < WORK_ROUNDS; round_idx++) {
+        state = state * 6364136223846793005ul + 1442695040888963407ul;
+    }
+    sink = state;
+}
+
+static void spawn_batch(void* data) {
+    FA_JobCounter* counter = data;
+    for (int job_idx = 0; job_idx < JOBS_PER_BATCH; job_idx++) {
+        fa_jobs_run(work_job, (void*)(unsigned long)job_idx, counter);
+    }
+}
+
+static void bench_threads(int threads) {
+    char name[64];
+    fa_options_set_int("jobs.threads", threads);
+    _fa_jobs_init();
+
+    // Pure scheduling overhead, everything submitted by the main thread and stolen from it
+    double start = fa_util_time();
+    for (int batch_idx = 0; batch_idx < JOBS / JOBS_PER_BATCH; batch_idx++) {
+        FA_JobCounter counter = {0};
+        for (int job_idx = 0; job_idx < JOBS_PER_BATCH; job_idx++) {
+            fa_jobs_run(empty_job, NULL, &counter);
+        }
+        fa_jobs_wait(&counter);
+    }
+    sprintf(name, "jobs/empty/threads_%d", threads);
+    fa_bench_report(name, fa_util_time() - start, JOBS / JOBS_PER_BATCH * JOBS_PER_BATCH);
+
+    // Real work spawned from inside jobs, so every thread has a deque of its own to pop from
+    int spawners = threads * 4;
+    long total = 0;
+    start = fa_util_time();
+    while (total < JOBS) {
+        FA_JobCounter counter = {0};
+        for (int spawner_idx = 0; spawner_idx < spawners; spawner_idx++) {
+            fa_jobs_run(spawn_batch, &counter, &counter);
+        }
+        fa_jobs_wait(&counter);
+        total += (long)spawners * JOBS_PER_BATCH;
+    }
+    double seconds = fa_util_time() - start;
+    sprintf(name, "jobs/work/threads_%d", threads);
+    fa_bench_report(name, seconds, total);
+    printf("%-40s %12.0f jobs/s\n", "", total / seconds);
+
+    _fa_jobs_teardown();
+}
+
+void fa_bench_jobs() {
+    _fa_options_init();
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    for (int threads = 1; threads < cores; threads *= 2) {
+        bench_threads(threads);
+    }
+    bench_threads(cores > 0 ? (int)cores : 1);
+    _fa_options_teardown();
+}
\ No newline at end of file
@@ -0,0 +1,178 @@
+/**
+ * @file bench_options.c
+ * @author ItsHighNoon
+ * @date 10-17-2026
+ * 
+ * @copyright Copyright (c) 2026
+ */
+
+#include "bench.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "util/config.h"
+#include "util/options.h"
+#include "util/util.h"
+
+#define STARTUP_OPTIONS 10000
+#define STARTUP_RUNS 10
+#define CONFIG_PATH "bench_options.cfg"
+#define SNAPSHOT_PATH "bench_options.bin"
+
+#define TABLE_OPERATIONS 1000000
+#define TABLE_NAME_LENGTH 48
+
+#define STRING_VALUES 64
+#define STRING_FRAMES 10000
+#define STRING_SETS_PER_FRAME 100
+
+// A config with a realistic mix of option types
+static void write_config() {
+    FILE* config = fopen(CONFIG_PATH, "w");
+    for (int option_idx = 0; option_idx < STARTUP_OPTIONS; option_idx++) {
+        switch (option_idx % 3) {
+        case 0:
+            fprintf(config, "set bench.subsystem%d.int_option%d %d\n", option_idx % 50, option_idx, option_idx);
+            break;
+        case 1:
+            fprintf(config, "set bench.subsystem%d.float_option%d %f\n", option_idx % 50, option_idx, option_idx * 0.5f);
+            break;
+        default:
+            fprintf(config, "set bench.subsystem%d.string_option%d \"value %d\"\n", option_idx % 50, option_idx, option_idx);
+            break;
+        }
+    }
+    fclose(config);
+
+    _fa_options_init();
+    fa_config_exec(CONFIG_PATH);
+    fa_options_save_snapshot(SNAPSHOT_PATH);
+    _fa_options_teardown();
+}
+
+static void bench_startup() {
+    write_config();
+
+    double text_seconds = 0.0;
+    for (int run_idx = 0; run_idx < STARTUP_RUNS; run_idx++) {
+        _fa_options_init();
+        double start = fa_util_time();
+        fa_config_exec(CONFIG_PATH);
+        text_seconds += fa_util_time() - start;
+        _fa_options_teardown();
+    }
+    fa_bench_report("options/startup/text_10k", text_seconds / STARTUP_RUNS, STARTUP_OPTIONS);
+
+    double snapshot_seconds = 0.0;
+    for (int run_idx = 0; run_idx < STARTUP_RUNS; run_idx++) {
+        _fa_options_init();
+        double start = fa_util_time();
+        fa_options_load_snapshot(SNAPSHOT_PATH);
+        snapshot_seconds += fa_util_time() - start;
+        // Writes the snapshot back, outside of the measurement
+        _fa_options_teardown();
+    }
+    fa_bench_report("options/startup/snapshot_10k", snapshot_seconds / STARTUP_RUNS, STARTUP_OPTIONS);
+
+    remove(CONFIG_PATH);
+    remove(SNAPSHOT_PATH);
+}
+
+// Cycles string options through a fixed set of values, the way a tool streaming map names or labels would
+static void bench_set_string() {
+    char values[STRING_VALUES][64];
+    for (int value_idx = 0; value_idx < STRING_VALUES; value_idx++) {
+        sprintf(values[value_idx], "%s/%d", value_idx % 2 ? "maps/some_long_directory_name/level" : "lbl", value_idx);
+    }
+
+    _fa_options_init();
+    FA_OptionHandle handle = fa_options_register("bench.string");
+    double start = fa_util_time();
+    for (int frame_idx = 0; frame_idx < STRING_FRAMES; frame_idx++) {
+        for (int set_idx = 0; set_idx < STRING_SETS_PER_FRAME; set_idx++) {
+            fa_options_handle_set_string(handle, values[(frame_idx + set_idx) % STRING_VALUES]);
+        }
+        _fa_options_reclaim();
+    }
+    fa_bench_report("options/set_string", fa_util_time() - start, (long)STRING_FRAMES * STRING_SETS_PER_FRAME);
+    _fa_options_teardown();
+}
+
+/*
+ * Time the basic operations on a table already holding size options. Names are visited in a scrambled order so the
+ * lookups miss the cache the way scattered reads from game code would.
+ */
+static void bench_table(int size) {
+    char (*names)[TABLE_NAME_LENGTH] = malloc(size * sizeof(*names));
+    unsigned long* hashes = malloc(size * sizeof(unsigned long));
+    int* order = malloc(TABLE_OPERATIONS * sizeof(int));
+    unsigned int random = 12345;
+    for (int name_idx = 0; name_idx < size; name_idx++) {
+        sprintf(names[name_idx], "bench.subsystem%d.option%d", name_idx % 50, name_idx);
+        hashes[name_idx] = fa_util_hash(names[name_idx]);
+    }
+    for (int operation_idx = 0; operation_idx < TABLE_OPERATIONS; operation_idx++) {
+        random = random * 1103515245 + 12345;
+        order[operation_idx] = (random >> 8) % size;
+    }
+
+    _fa_options_init();
+    for (int name_idx = 0; name_idx < size; name_idx++) {
+        fa_options_set_int(names[name_idx], name_idx);
+    }
+
+    char name[FA_BENCH_MAX_NAME];
+    // Accumulate so the compiler cannot skip the calls
+    int sink = 0;
+    double start = fa_util_time();
+    for (int operation_idx = 0; operation_idx < TABLE_OPERATIONS; operation_idx++) {
+        int name_idx = order[operation_idx];
+        sink += fa_options_get_hashed(names[name_idx], hashes[name_idx]).int_value;
+    }
+    sprintf(name, "options/table_%d/get_hashed", size);
+    fa_bench_report(name, fa_util_time() - start, TABLE_OPERATIONS + (sink & 0));
+
+    start = fa_util_time();
+    for (int operation_idx = 0; operation_idx < TABLE_OPERATIONS; operation_idx++) {
+        int name_idx = order[operation_idx];
+        sink += fa_options_get(names[name_idx]).int_value;
+    }
+    sprintf(name, "options/table_%d/get", size);
+    fa_bench_report(name, fa_util_time() - start, TABLE_OPERATIONS + (sink & 0));
+
+    start = fa_util_time();
+    for (int operation_idx = 0; operation_idx < TABLE_OPERATIONS; operation_idx++) {
+        fa_options_set_int(names[order[operation_idx]], operation_idx);
+    }
+    sprintf(name, "options/table_%d/set_int", size);
+    fa_bench_report(name, fa_util_time() - start, TABLE_OPERATIONS);
+
+    // Every option once, so each unset finds a set option and each set after it fills an unset one
+    start = fa_util_time();
+    for (int name_idx = 0; name_idx < size; name_idx++) {
+        fa_options_unset(names[name_idx]);
+    }
+    sprintf(name, "options/table_%d/unset", size);
+    fa_bench_report(name, fa_util_time() - start, size);
+
+    start = fa_util_time();
+    for (int name_idx = 0; name_idx < size; name_idx++) {
+        fa_options_set_int(names[name_idx], name_idx);
+    }
+    sprintf(name, "options/table_%d/set_unset", size);
+    fa_bench_report(name, fa_util_time() - start, size);
+
+    _fa_options_teardown();
+    free(order);
+    free(hashes);
+    free(names);
+}
+
+void fa_bench_options() {
+    bench_startup();
+    bench_set_string();
+    for (int size = 16; size <= 65536; size *= 16) {
+        bench_table(size);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,221 @@
+/**
+ * @file bench_record.c
+ * @author ItsHighNoon
+ * @date 10-17-2026
+ * 
+ * @copyright Copyright (c) 2026
+ */
+
+#include "bench.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <vulkan/vulkan.h>
+
+#include "render/vk/record.h"
+#include "util/jobs.h"
+#include "util/options.h"
+#include "util/util.h"
+
+#define DRAWS 100000
+#define ITERATIONS 20
+
+static VkInstance instance;
+static VkDevice device;
+static uint32_t graphics_family;
+static VkRenderPass render_pass;
+static VkFramebuffer framebuffer;
+static VkPipelineLayout pipeline_layout;
+
+/*
+ * What a typical draw records, a push constant for the object and the draw. The commands are never submitted, so no
+ * pipeline is bound.
+ */
+static void record_draws(VkCommandBuffer command_buffer, int first, int count, void* data) {
+    for (int draw_idx = first; draw_idx < first + count; draw_idx++) {
+        unsigned int push[4] = { draw_idx, 0, 0, 0 };
+        vkCmdPushConstants(command_buffer, pipeline_layout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(push), push);
+        vkCmdDraw(command_buffer, 36, 1, 0, draw_idx);
+    }
+}
+
+// A device without a surface, and a render pass without attachments so no images are needed
+static int create_device() {
+    VkApplicationInfo app_info;
+    memset(&app_info, 0, sizeof(app_info));
+    app_info.sType = VK_STRUCTURE_TYPE_APPLICATION_INFO;
+    app_info.pApplicationName = "fa_bench";
+    app_info.apiVersion = VK_API_VERSION_1_3;
+
+    VkInstanceCreateInfo instance_info;
+    memset(&instance_info, 0, sizeof(instance_info));
+    instance_info.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
+    instance_info.pApplicationInfo = &app_info;
+    if (vkCreateInstance(&instance_info, NULL, &instance) != VK_SUCCESS) {
+        return 1;
+    }
+
+    uint32_t device_count = 1;
+    VkPhysicalDevice physical_device;
+    VkResult result = vkEnumeratePhysicalDevices(instance, &device_count, &physical_device);
+    if ((result != VK_SUCCESS && result != VK_INCOMPLETE) || device_count == 0) {
+        vkDestroyInstance(instance, NULL);
+        return 1;
+    }
+
+    VkQueueFamilyProperties families[16];
+    uint32_t family_count = 16;
+    vkGetPhysicalDeviceQueueFamilyProperties(physical_device, &family_count, families);
+    graphics_family = family_count;
+    for (int family_idx = 0; family_idx < family_count; family_idx++) {
+        if (families[family_idx].queueFlags & VK_QUEUE_GRAPHICS_BIT) {
+            graphics_family = family_idx;
+            break;
+        }
+    }
+    if (graphics_family == family_count) {
+        vkDestroyInstance(instance, NULL);
+        return 1;
+    }
+
+    float queue_priority = 1.0f;
+    VkDeviceQueueCreateInfo queue_info;
+    memset(&queue_info, 0, sizeof(queue_info));
+    queue_info.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
+    queue_info.queueFamilyIndex = graphics_family;
+    queue_info.queueCount = 1;
+    queue_info.pQueuePriorities = &queue_priority;
+
+    VkDeviceCreateInfo device_info;
+    memset(&device_info, 0, sizeof(device_info));
+    device_info.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+    device_info.queueCreateInfoCount = 1;
+    device_info.pQueueCreateInfos = &queue_info;
+    if (vkCreateDevice(physical_device, &device_info, NULL, &device) != VK_SUCCESS) {
+        vkDestroyInstance(instance, NULL);
+        return 1;
+    }
+
+    VkSubpassDescription subpass;
+    memset(&subpass, 0, sizeof(subpass));
+    subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+
+    VkRenderPassCreateInfo render_pass_info;
+    memset(&render_pass_info, 0, sizeof(render_pass_info));
+    render_pass_info.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+    render_pass_info.subpassCount = 1;
+    render_pass_info.pSubpasses = &subpass;
+    vkCreateRenderPass(device, &render_pass_info, NULL, &render_pass);
+
+    VkFramebufferCreateInfo framebuffer_info;
+    memset(&framebuffer_info, 0, sizeof(framebuffer_info));
+    framebuffer_info.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+    framebuffer_info.renderPass = render_pass;
+    framebuffer_info.width = 64;
+    framebuffer_info.height = 64;
+    framebuffer_info.layers = 1;
+    vkCreateFramebuffer(device, &framebuffer_info, NULL, &framebuffer);
+
+    VkPushConstantRange push_range;
+    memset(&push_range, 0, sizeof(push_range));
+    push_range.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+    push_range.size = 16;
+
+    VkPipelineLayoutCreateInfo layout_info;
+    memset(&layout_info, 0, sizeof(layout_info));
+    layout_info.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    layout_info.pushConstantRangeCount = 1;
+    layout_info.pPushConstantRanges = &push_range;
+    vkCreatePipelineLayout(device, &layout_info, NULL, &pipeline_layout);
+    return 0;
+}
+
+static void destroy_device() {
+    vkDestroyPipelineLayout(device, pipeline_layout, NULL);
+    vkDestroyFramebuffer(device, framebuffer, NULL);
+    vkDestroyRenderPass(device, render_pass, NULL);
+    vkDestroyDevice(device, NULL);
+    vkDestroyInstance(instance, NULL);
+}
+
+static void bench_threads(int threads) {
+    char name[64];
+    fa_options_set_int("jobs.threads", threads);
+    _fa_jobs_init();
+    _fa_vk_record_init(device, graphics_family, 1);
+
+    VkCommandPool primary_pool;
+    VkCommandPoolCreateInfo pool_info;
+    memset(&pool_info, 0, sizeof(pool_info));
+    pool_info.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+    pool_info.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+    pool_info.queueFamilyIndex = graphics_family;
+    vkCreateCommandPool(device, &pool_info, NULL, &primary_pool);
+
+    VkCommandBuffer primary;
+    VkCommandBufferAllocateInfo alloc_info;
+    memset(&alloc_info, 0, sizeof(alloc_info));
+    alloc_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+    alloc_info.commandPool = primary_pool;
+    alloc_info.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    alloc_info.commandBufferCount = 1;
+    vkAllocateCommandBuffers(device, &alloc_info, &primary);
+
+    VkCommandBufferBeginInfo begin_info;
+    memset(&begin_info, 0, sizeof(begin_info));
+    begin_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    begin_info.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+    VkRenderPassBeginInfo render_pass_begin;
+    memset(&render_pass_begin, 0, sizeof(render_pass_begin));
+    render_pass_begin.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+    render_pass_begin.renderPass = render_pass;
+    render_pass_begin.framebuffer = framebuffer;
+    render_pass_begin.renderArea.extent.width = 64;
+    render_pass_begin.renderArea.extent.height = 64;
+
+    VkCommandBufferInheritanceInfo inheritance;
+    memset(&inheritance, 0, sizeof(inheritance));
+    inheritance.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+    inheritance.renderPass = render_pass;
+    inheritance.framebuffer = framebuffer;
+
+    // The first pass allocates the command buffers and warms up the driver's command memory
+    double start = 0.0;
+    for (int iteration_idx = -1; iteration_idx < ITERATIONS; iteration_idx++) {
+        if (iteration_idx == 0) {
+            start = fa_util_time();
+        }
+        _fa_vk_record_begin_frame(0);
+        vkResetCommandPool(device, primary_pool, 0);
+        vkBeginCommandBuffer(primary, &begin_info);
+        vkCmdBeginRenderPass(primary, &render_pass_begin, VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
+        fa_vk_record_parallel(primary, &inheritance, DRAWS, record_draws, NULL);
+        vkCmdEndRenderPass(primary);
+        vkEndCommandBuffer(primary);
+    }
+    double seconds = fa_util_time() - start;
+    sprintf(name, "record/draws_%d/threads_%d", DRAWS, threads);
+    fa_bench_report(name, seconds / ITERATIONS, DRAWS);
+
+    vkDestroyCommandPool(device, primary_pool, NULL);
+    _fa_vk_record_teardown();
+    _fa_jobs_teardown();
+}
+
+void fa_bench_record() {
+    if (create_device() != 0) {
+        printf("%-40s skipped, no Vulkan device\n", "record");
+        return;
+    }
+
+    _fa_options_init();
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    for (int threads = 1; threads < cores; threads *= 2) {
+        bench_threads(threads);
+    }
+    bench_threads(cores > 0 ? (int)cores : 1);
+    _fa_options_teardown();
+    destroy_device();
+}
\ No newline at end of file
@@ -0,0 +1,166 @@
+/**
+ * @file bench_vk.c
+ * @author ItsHighNoon
+ * @date 10-17-2026
+ * 
+ * @copyright Copyright (c) 2026
+ */
+
+#include "bench.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <vulkan/vulkan.h>
+
+#include "os/display.h"
+#include "render/vk/vkboilerplate.h"
+#include "util/jobs.h"
+#include "util/options.h"
+#include "util/profile.h"
+#include "util/util.h"
+
+#define INIT_RUNS 5
+#define WARMUP_FRAMES 10
+#define FRAMES 500
+#define WIDTH 1280
+#define HEIGHT 720
+
+// The zones _fa_vk_init times its phases with
+static const char* INIT_PHASES[] = {
+    "Create instance",
+    "Query device",
+    "Load pipeline cache",
+    "Wait for startup jobs",
+    "Pick physical device",
+    "Create logical device",
+    "Create shader modules",
+    "Create swap chain",
+    "Create pipelines"
+};
+
+// _fa_vk_init exits if it finds no device, so check for one first
+static int device_available() {
+    VkApplicationInfo app_info;
+    memset(&app_info, 0, sizeof(app_info));
+    app_info.sType = VK_STRUCTURE_TYPE_APPLICATION_INFO;
+    app_info.pApplicationName = "fa_bench";
+    app_info.apiVersion = VK_API_VERSION_1_3;
+
+    VkInstanceCreateInfo instance_info;
+    memset(&instance_info, 0, sizeof(instance_info));
+    instance_info.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
+    instance_info.pApplicationInfo = &app_info;
+    VkInstance instance;
+    if (vkCreateInstance(&instance_info, NULL, &instance) != VK_SUCCESS) {
+        return 0;
+    }
+
+    uint32_t device_count = 0;
+    vkEnumeratePhysicalDevices(instance, &device_count, NULL);
+    vkDestroyInstance(instance, NULL);
+    return device_count > 0;
+}
+
+static double zone_time(const char* zone_name) {
+    for (int zone_idx = 0; zone_idx < fa_profile_zone_count(); zone_idx++) {
+        FA_ProfileStats stats;
+        fa_profile_stats(zone_idx, &stats);
+        if (strcmp(stats.name, zone_name) == 0) {
+            return stats.last;
+        }
+    }
+    return 0.0;
+}
+
+/*
+ * The first run starts without a pipeline cache and only reports how long the pipelines took, the others find the cache
+ * it saved and are averaged.
+ */
+static void bench_init() {
+    double phase_seconds[sizeof(INIT_PHASES) / sizeof(char*)];
+    memset(phase_seconds, 0, sizeof(phase_seconds));
+    double total_seconds = 0.0;
+    double cold_pipeline_seconds = 0.0;
+
+    remove(FA_VK_PIPELINE_CACHE_PATH);
+    for (int run_idx = -1; run_idx < INIT_RUNS; run_idx++) {
+        _fa_display_init();
+        _fa_profile_new_frame();
+        double start = fa_util_time();
+        _fa_vk_init_begin();
+        _fa_display_open();
+        _fa_vk_init();
+        double seconds = fa_util_time() - start;
+        _fa_profile_new_frame();
+        if (run_idx < 0) {
+            cold_pipeline_seconds = zone_time("Create pipelines");
+        } else {
+            total_seconds += seconds;
+            for (int phase_idx = 0; phase_idx < sizeof(INIT_PHASES) / sizeof(char*); phase_idx++) {
+                phase_seconds[phase_idx] += zone_time(INIT_PHASES[phase_idx]);
+            }
+        }
+        _fa_vk_teardown();
+        _fa_display_close();
+    }
+
+    char name[FA_BENCH_MAX_NAME];
+    for (int phase_idx = 0; phase_idx < sizeof(INIT_PHASES) / sizeof(char*); phase_idx++) {
+        snprintf(name, sizeof(name), "vk/init/%s", INIT_PHASES[phase_idx]);
+        // Spaces in the zone names would make the results awkward to grep
+        for (char* c = name; *c; c++) {
+            *c = *c == ' ' ? '_' : *c;
+        }
+        fa_bench_report(name, phase_seconds[phase_idx] / INIT_RUNS, 1);
+    }
+    fa_bench_report("vk/init/Create_pipelines_cold", cold_pipeline_seconds, 1);
+    fa_bench_report("vk/init/total", total_seconds / INIT_RUNS, 1);
+}
+
+// The same loop as main, minus input and pacing
+static void bench_frames() {
+    _fa_display_open();
+    _fa_vk_init();
+
+    double start = 0.0;
+    for (int frame_idx = -WARMUP_FRAMES; frame_idx < FRAMES; frame_idx++) {
+        if (frame_idx == 0) {
+            start = fa_util_time();
+        }
+        _fa_profile_new_frame();
+        _fa_vk_begin_frame();
+        _fa_display_poll_and_refresh();
+        _fa_options_dispatch();
+        _fa_vk_draw_frame();
+        _fa_options_reclaim();
+    }
+    double seconds = fa_util_time() - start;
+
+    char name[FA_BENCH_MAX_NAME];
+    snprintf(name, sizeof(name), "vk/headless_frame/%dx%d", WIDTH, HEIGHT);
+    fa_bench_report(name, seconds, FRAMES);
+
+    _fa_vk_teardown();
+    _fa_display_close();
+}
+
+void fa_bench_vk() {
+    if (device_available() == 0) {
+        printf("%-40s skipped, no Vulkan device\n", "vk");
+        return;
+    }
+
+    _fa_options_init();
+    fa_options_set_int("window.headless", 1);
+    fa_options_set_int("window.width", WIDTH);
+    fa_options_set_int("window.height", HEIGHT);
+    _fa_jobs_init();
+    _fa_profile_init();
+
+    bench_init();
+    bench_frames();
+
+    _fa_jobs_teardown();
+    _fa_profile_teardown();
+    _fa_options_teardown();
+}
\ No newline at end of file
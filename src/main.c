@@ -9,24 +9,59 @@
  */
 
 #include "os/display.h"
+#include "os/file.h"
+#include "render/pacer.h"
 #include "render/vk/vkboilerplate.h"
+#include "util/arena.h"
+#include "util/config.h"
+#include "util/jobs.h"
 #include "util/options.h"
+#include "util/profile.h"
+
+#define CONFIG_PATH "autoexec.cfg"
+#define SNAPSHOT_PATH "options.bin"
 
 int main(int argc, char** argv) {
+   _fa_arena_init();
    _fa_options_init();
 
    fa_options_set_string("app.name", "Test Application");
    fa_options_set_int("app.version", VK_MAKE_VERSION(0, 0, 1));
    fa_options_set_int("window.fullscreen", 0);
 
+   // The snapshot is rewritten on every exit, so the config only needs to run again if someone edited it since
+   int snapshot_stale = _fa_os_file_modified_time(SNAPSHOT_PATH) < _fa_os_file_modified_time(CONFIG_PATH);
+   if (fa_options_load_snapshot(SNAPSHOT_PATH) != 0 || snapshot_stale) {
+      fa_config_exec(CONFIG_PATH);
+   }
+   _fa_jobs_init();
+   _fa_profile_init();
+
+   // Instance creation, device queries and the pipeline cache run on the workers while the window opens
+   _fa_display_init();
+   _fa_vk_init_begin();
    _fa_display_open();
    _fa_vk_init();
+   _fa_pacer_init();
    while (!_fa_display_close_requested()) {
+      _fa_arena_new_frame();
+      _fa_profile_new_frame();
+      // Wait for the GPU and for the pacer before sampling input, so neither wait ends up between input and present
+      _fa_vk_begin_frame();
+      _fa_pacer_begin_frame();
       _fa_display_poll_and_refresh();
+      _fa_options_dispatch();
+      _fa_vk_draw_frame();
+      _fa_pacer_end_frame();
+      _fa_options_reclaim();
    }
+   _fa_pacer_teardown();
    _fa_vk_teardown();
    _fa_display_close();
 
+   _fa_jobs_teardown();
+   _fa_profile_teardown();
    _fa_options_teardown();
+   _fa_arena_teardown();
    return 0;
 }
\ No newline at end of file
@@ -8,6 +8,7 @@
 
 #include "display.h"
 
+#include "util/option_names.h"
 #include "util/options.h"
 
 #define FALLBACK_WIDTH 800
@@ -15,18 +16,73 @@
 #define MIN_HEIGHT MIN_WIDTH
 
 static GLFWwindow* window;
+static int window_fullscreen;
+static int framebuffer_resized;
+static int headless;
+static int headless_frames;
+static int headless_frames_left;
+static int initialized;
+
+static void on_window_size_changed(void* user_data) {
+    if (window_fullscreen) {
+        return;
+    }
+
+    FA_OptionValue width_value = fa_options_get_hashed(FA_OPTION_NAME_WINDOW_WIDTH);
+    FA_OptionValue height_value = fa_options_get_hashed(FA_OPTION_NAME_WINDOW_HEIGHT);
+    if (width_value.type == FA_OPTION_INT && width_value.int_value > MIN_WIDTH
+        && height_value.type == FA_OPTION_INT && height_value.int_value > MIN_HEIGHT) {
+        glfwSetWindowSize(window, width_value.int_value, height_value.int_value);
+    }
+}
+
+static void on_framebuffer_resized(GLFWwindow* resized_window, int width, int height) {
+    framebuffer_resized = 1;
+}
+
+static void on_window_resized(GLFWwindow* resized_window, int width, int height) {
+    // Dragged by the user, remember the size for next time. Setting the option calls back into
+    // on_window_size_changed, which does nothing since the size already matches.
+    if (window_fullscreen == 0 && width > MIN_WIDTH && height > MIN_HEIGHT) {
+        fa_options_set_int("window.width", width);
+        fa_options_set_int("window.height", height);
+    }
+}
 
 GLFWwindow* _fa_display_get_handle() {
     return window;
 }
 
+void _fa_display_init() {
+    headless = 0;
+    FA_OptionValue headless_value = fa_options_get_hashed(FA_OPTION_NAME_WINDOW_HEADLESS);
+    if (headless_value.type == FA_OPTION_INT) {
+        headless = headless_value.int_value != 0;
+    } else {
+        fa_options_set_int("window.headless", headless);
+    }
+
+    if (headless) {
+        headless_frames = 0;
+        FA_OptionValue frames_value = fa_options_get_hashed(FA_OPTION_NAME_WINDOW_HEADLESS_FRAMES);
+        if (frames_value.type == FA_OPTION_INT && frames_value.int_value > 0) {
+            headless_frames = frames_value.int_value;
+        }
+        headless_frames_left = headless_frames;
+        window = NULL;
+    } else {
+        glfwInit();
+    }
+    initialized = 1;
+}
+
 void _fa_display_open() {
-    glfwInit();
-    glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
-    glfwWindowHint(GLFW_RESIZABLE, GLFW_FALSE);
+    if (initialized == 0) {
+        _fa_display_init();
+    }
 
     int width = FALLBACK_WIDTH;
-    FA_OptionValue width_value = fa_options_get("window.width");
+    FA_OptionValue width_value = fa_options_get_hashed(FA_OPTION_NAME_WINDOW_WIDTH);
     if (width_value.type == FA_OPTION_INT && width_value.int_value > MIN_WIDTH) {
         width = width_value.int_value;
     } else {
@@ -34,15 +90,23 @@ void _fa_display_open() {
     }
 
     int height = width * 9 / 16;
-    FA_OptionValue height_value = fa_options_get("window.height");
+    FA_OptionValue height_value = fa_options_get_hashed(FA_OPTION_NAME_WINDOW_HEIGHT);
     if (height_value.type == FA_OPTION_INT && height_value.int_value > MIN_HEIGHT) {
         height = height_value.int_value;
     } else {
         fa_options_set_int("window.height", height);
     }
 
+    if (headless) {
+        // Nothing to open, but the renderer still takes its size from the options above
+        return;
+    }
+
+    glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
+    glfwWindowHint(GLFW_RESIZABLE, GLFW_TRUE);
+
     int fullscreen = 0;
-    FA_OptionValue fullscreen_value = fa_options_get("window.fullscreen");
+    FA_OptionValue fullscreen_value = fa_options_get_hashed(FA_OPTION_NAME_WINDOW_FULLSCREEN);
     if (fullscreen_value.type == FA_OPTION_INT) {
         fullscreen = fullscreen_value.int_value;
     } else {
@@ -66,17 +130,53 @@ void _fa_display_open() {
     } else {
         window = glfwCreateWindow(width, height, "Fifth Ace", NULL, NULL);
     }
+    window_fullscreen = fullscreen > 0;
+    framebuffer_resized = 0;
+
+    glfwSetWindowSizeLimits(window, MIN_WIDTH + 1, MIN_HEIGHT + 1, GLFW_DONT_CARE, GLFW_DONT_CARE);
+    glfwSetFramebufferSizeCallback(window, on_framebuffer_resized);
+    glfwSetWindowSizeCallback(window, on_window_resized);
+
+    fa_options_subscribe(fa_options_register_hashed(FA_OPTION_NAME_WINDOW_WIDTH), on_window_size_changed, NULL);
+    fa_options_subscribe(fa_options_register_hashed(FA_OPTION_NAME_WINDOW_HEIGHT), on_window_size_changed, NULL);
 }
 
 void _fa_display_close() {
+    initialized = 0;
+    if (headless) {
+        return;
+    }
+
+    fa_options_unsubscribe(on_window_size_changed, NULL);
     glfwDestroyWindow(window);
     glfwTerminate();
 }
 
 void _fa_display_poll_and_refresh() {
+    if (headless) {
+        if (headless_frames_left > 0) {
+            headless_frames_left--;
+        }
+        return;
+    }
+
     glfwPollEvents();
 }
 
 int _fa_display_close_requested() {
+    if (headless) {
+        return headless_frames > 0 && headless_frames_left == 0;
+    }
+
     return glfwWindowShouldClose(window);
+}
+
+int _fa_display_take_resized() {
+    int resized = framebuffer_resized;
+    framebuffer_resized = 0;
+    return resized;
+}
+
+int _fa_display_headless() {
+    return headless;
 }
\ No newline at end of file
@@ -13,12 +13,38 @@
 #define GLFW_INCLUDE_VULKAN
 #include <GLFW/glfw3.h>
 
+/**
+ * Get the window.
+ * @return The window, or NULL in headless mode.
+ */
 GLFWwindow* _fa_display_get_handle();
 
+/**
+ * Read the display options and start the window system, without opening the window yet. Lets the renderer ask the
+ * window system what it needs while the window opens, see _fa_vk_init_begin.
+ */
+void _fa_display_init();
+
+/**
+ * Open the window. Calls _fa_display_init first if it has not been called.
+ */
 void _fa_display_open();
 
 void _fa_display_close();
 
 void _fa_display_poll_and_refresh();
 
-int _fa_display_close_requested();
\ No newline at end of file
+int _fa_display_close_requested();
+
+/**
+ * Check whether the framebuffer changed size since the last call.
+ * @return Nonzero if it was resized.
+ */
+int _fa_display_take_resized();
+
+/**
+ * Check whether the display was opened without a window, for rendering offscreen. Set by the window.headless option,
+ * and window.headless_frames makes the display ask to close after that many frames.
+ * @return Nonzero if there is no window.
+ */
+int _fa_display_headless();
\ No newline at end of file
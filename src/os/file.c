@@ -0,0 +1,117 @@
+/**
+ * @file file.c
+ * @author ItsHighNoon
+ * @date 10-17-2026
+ * 
+ * @copyright Copyright (c) 2026
+ */
+
+#include "file.h"
+
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+const void* _fa_os_map_file(const char* path, size_t* size) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return NULL;
+    }
+
+    struct stat file_stat;
+    if (fstat(fd, &file_stat) != 0 || file_stat.st_size == 0) {
+        close(fd);
+        return NULL;
+    }
+
+    void* data = mmap(NULL, file_stat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    // The mapping keeps the file alive on its own
+    close(fd);
+    if (data == MAP_FAILED) {
+        return NULL;
+    }
+
+    *size = file_stat.st_size;
+    return data;
+}
+
+long long _fa_os_file_size(const char* path) {
+    struct stat file_stat;
+    if (stat(path, &file_stat) != 0) {
+        return -1;
+    }
+    return file_stat.st_size;
+}
+
+void _fa_os_unmap_file(const void* data, size_t size) {
+    munmap((void*)data, size);
+}
+
+void _fa_os_prefetch(const void* data, size_t size) {
+    if (size == 0) {
+        return;
+    }
+
+    // madvise wants a page aligned start, the mapping itself starts on a page
+    uintptr_t page_size = sysconf(_SC_PAGESIZE);
+    uintptr_t start = (uintptr_t)data & ~(page_size - 1);
+    uintptr_t end = (uintptr_t)data + size;
+    madvise((void*)start, end - start, MADV_WILLNEED);
+
+    // The advice only starts the reads, touching every page waits for them
+    volatile const char* page = (const char*)start;
+    for (uintptr_t offset = 0; offset < end - start; offset += page_size) {
+        (void)page[offset];
+    }
+}
+
+int _fa_os_write_file_atomic(const char* path, const void* data, size_t size) {
+    size_t path_length = strlen(path);
+    char* temp_path = malloc(path_length + sizeof(".tmp"));
+    memcpy(temp_path, path, path_length);
+    memcpy(temp_path + path_length, ".tmp", sizeof(".tmp"));
+
+    int fd = open(temp_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        free(temp_path);
+        return 1;
+    }
+
+    const char* remaining = data;
+    while (size > 0) {
+        ssize_t written = write(fd, remaining, size);
+        if (written <= 0) {
+            close(fd);
+            unlink(temp_path);
+            free(temp_path);
+            return 1;
+        }
+        remaining += written;
+        size -= written;
+    }
+
+    // Make sure the contents hit the disk before the rename does
+    int synced = fsync(fd) == 0;
+    int closed = close(fd) == 0;
+    if (!synced || !closed || rename(temp_path, path) != 0) {
+        unlink(temp_path);
+        free(temp_path);
+        return 1;
+    }
+
+    free(temp_path);
+    return 0;
+}
+
+long long _fa_os_file_modified_time(const char* path) {
+    struct stat file_stat;
+    if (stat(path, &file_stat) != 0) {
+        return -1;
+    }
+    return file_stat.st_mtime;
+}
\ No newline at end of file
@@ -0,0 +1,60 @@
+/**
+ * @file file.h
+ * @author ItsHighNoon
+ * @date 10-17-2026
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ * Interface with the file system of the operating system.
+ */
+
+#pragma once
+
+#include <stddef.h>
+
+/**
+ * Map a whole file into memory, read only.
+ * @param path The path of the file. Assumed to be null terminated.
+ * @param size Set to the size of the file in bytes.
+ * @return A pointer to the contents of the file, or NULL if it could not be mapped. Release with _fa_os_unmap_file.
+ */
+const void* _fa_os_map_file(const char* path, size_t* size);
+
+/**
+ * Get the size of a file.
+ * @param path The path of the file. Assumed to be null terminated.
+ * @return The size of the file in bytes, or -1 if it does not exist.
+ */
+long long _fa_os_file_size(const char* path);
+
+/**
+ * Release a file mapped by _fa_os_map_file.
+ * @param data The pointer returned by _fa_os_map_file.
+ * @param size The size returned by _fa_os_map_file.
+ */
+void _fa_os_unmap_file(const void* data, size_t size);
+
+/**
+ * Read part of a file mapped by _fa_os_map_file into memory, so later accesses do not stall on the disk. Blocks until
+ * every page of the range is resident.
+ * @param data The start of the range, anywhere in the mapping.
+ * @param size The size of the range in bytes.
+ */
+void _fa_os_prefetch(const void* data, size_t size);
+
+/**
+ * Replace the contents of a file so that other processes see either the old contents or the new contents, never a
+ * partially written file. Existing mappings of the old file stay valid.
+ * @param path The path of the file. Assumed to be null terminated.
+ * @param data The new contents of the file.
+ * @param size The size of data in bytes.
+ * @return 0 on success, 1 if the file could not be written.
+ */
+int _fa_os_write_file_atomic(const char* path, const void* data, size_t size);
+
+/**
+ * Get the last time a file was modified.
+ * @param path The path of the file. Assumed to be null terminated.
+ * @return The modification time in seconds since the epoch, or -1 if the file does not exist.
+ */
+long long _fa_os_file_modified_time(const char* path);
\ No newline at end of file
@@ -0,0 +1,94 @@
+/**
+ * @file pacer.c
+ * @author ItsHighNoon
+ * @date 10-17-2026
+ * 
+ * @copyright Copyright (c) 2026
+ */
+
+#include "pacer.h"
+
+#include <string.h>
+
+#include "util/option_names.h"
+#include "util/options.h"
+#include "util/profile.h"
+#include "util/util.h"
+
+// Wake up this much earlier than the estimate says, scheduler jitter is not part of the estimate
+#define WAKE_MARGIN 0.0005
+// How fast the work estimate forgets a slow frame, per frame
+#define ESTIMATE_DECAY 0.05
+#define AVERAGE_WEIGHT 0.1
+
+static double frame_period;
+static double input_time;
+static double last_present_time;
+static double next_present_time;
+static FA_PacerStats stats;
+
+static void on_max_fps_changed(void* user_data) {
+    frame_period = 0.0;
+    FA_OptionValue max_fps_value = fa_options_get_hashed(FA_OPTION_NAME_RENDER_MAX_FPS);
+    if (max_fps_value.type == FA_OPTION_INT && max_fps_value.int_value > 0) {
+        frame_period = 1.0 / max_fps_value.int_value;
+    }
+}
+
+void _fa_pacer_init() {
+    memset(&stats, 0, sizeof(stats));
+    last_present_time = 0.0;
+    next_present_time = 0.0;
+
+    FA_OptionValue max_fps_value = fa_options_get_hashed(FA_OPTION_NAME_RENDER_MAX_FPS);
+    if (max_fps_value.type != FA_OPTION_INT) {
+        // Uncapped
+        fa_options_set_int("render.max_fps", 0);
+    }
+    on_max_fps_changed(NULL);
+    fa_options_subscribe(fa_options_register_hashed(FA_OPTION_NAME_RENDER_MAX_FPS), on_max_fps_changed, NULL);
+}
+
+void _fa_pacer_teardown() {
+    fa_options_unsubscribe(on_max_fps_changed, NULL);
+}
+
+void _fa_pacer_begin_frame() {
+    if (frame_period > 0.0 && next_present_time > 0.0) {
+        fa_profile_begin("Pacer sleep");
+        fa_util_sleep_until(next_present_time - stats.work_estimate - WAKE_MARGIN);
+        fa_profile_end();
+    }
+    input_time = fa_util_time();
+}
+
+void _fa_pacer_end_frame() {
+    double present_time = fa_util_time();
+
+    // Rise immediately and decay slowly, a single slow frame should not make the next one miss its deadline
+    double work = present_time - input_time;
+    if (work > stats.work_estimate) {
+        stats.work_estimate = work;
+    } else {
+        stats.work_estimate += (work - stats.work_estimate) * ESTIMATE_DECAY;
+    }
+    stats.latency += (work - stats.latency) * AVERAGE_WEIGHT;
+    if (last_present_time > 0.0) {
+        stats.frame_time += (present_time - last_present_time - stats.frame_time) * AVERAGE_WEIGHT;
+    }
+    last_present_time = present_time;
+
+    if (frame_period > 0.0) {
+        // Keep a steady cadence, but start over instead of rushing to catch up after falling behind
+        next_present_time += frame_period;
+        if (next_present_time < present_time) {
+            next_present_time = present_time + frame_period;
+        }
+    } else {
+        next_present_time = 0.0;
+    }
+}
+
+void fa_pacer_stats(FA_PacerStats* out) {
+    *out = stats;
+}
\ No newline at end of file
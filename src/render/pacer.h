@@ -0,0 +1,48 @@
+/**
+ * @file pacer.h
+ * @author ItsHighNoon
+ * @date 10-17-2026
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ * Frame pacing. Caps the frame rate at render.max_fps, and instead of sleeping after a frame, sleeps before input is
+ * sampled for the next one. The wait is sized from how long frames took from input to present recently, so input is
+ * read as late as possible while the frame still makes its deadline.
+ *
+ * The main loop brackets every frame, after the GPU is ready for it and before input is polled:
+ *
+ *     _fa_pacer_begin_frame();
+ *     // Poll input, update, record and present
+ *     _fa_pacer_end_frame();
+ */
+
+#pragma once
+
+typedef struct FA_PacerStats {
+    // Smoothed time between presents, in seconds
+    double frame_time;
+    // Smoothed time from sampling input until the frame was handed to the presentation engine, in seconds
+    double latency;
+    // Recent worst case of latency, used to decide when to wake up
+    double work_estimate;
+} FA_PacerStats;
+
+void _fa_pacer_init();
+
+void _fa_pacer_teardown();
+
+/**
+ * Sleep until the latest moment input can be sampled for this frame. Returns immediately if there is no cap.
+ */
+void _fa_pacer_begin_frame();
+
+/**
+ * Call once the frame was presented.
+ */
+void _fa_pacer_end_frame();
+
+/**
+ * Get timings of recent frames.
+ * @param stats Filled in with the timings.
+ */
+void fa_pacer_stats(FA_PacerStats* stats);
\ No newline at end of file
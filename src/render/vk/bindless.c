@@ -0,0 +1,295 @@
+/**
+ * @file bindless.c
+ * @author ItsHighNoon
+ * @date 10-17-2026
+ * 
+ * @copyright Copyright (c) 2026
+ */
+
+#include "bindless.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Upper bounds, lowered to what the device allows
+#define MAX_TEXTURES 65536
+#define MAX_BUFFERS 65536
+
+/*
+ * Hands out descriptor indices. Removed indices wait in the retired ring, oldest first, until no frame in flight can
+ * still read them, and then go on the free stack.
+ */
+struct HandleTable {
+    uint32_t capacity;
+    // Indices from here on were never handed out
+    uint32_t next_unused;
+    uint32_t* free;
+    uint32_t free_len;
+    FA_VkBindlessHandle* retired;
+    uint64_t* retired_serials;
+    uint32_t retired_head;
+    uint32_t retired_len;
+};
+
+static VkDevice device;
+static VkDescriptorSetLayout set_layout;
+static VkDescriptorPool descriptor_pool;
+static VkDescriptorSet descriptor_set;
+static struct HandleTable textures;
+static struct HandleTable buffers;
+static int frames_in_flight;
+static uint64_t frame_serial;
+
+static void create_table(struct HandleTable* table, uint32_t capacity) {
+    memset(table, 0, sizeof(*table));
+    table->capacity = capacity;
+    // Every handle can be free or retired at once, so neither ever has to grow
+    table->free = malloc(capacity * sizeof(uint32_t));
+    table->retired = malloc(capacity * sizeof(FA_VkBindlessHandle));
+    table->retired_serials = malloc(capacity * sizeof(uint64_t));
+}
+
+static void destroy_table(struct HandleTable* table) {
+    free(table->free);
+    free(table->retired);
+    free(table->retired_serials);
+    memset(table, 0, sizeof(*table));
+}
+
+static FA_VkBindlessHandle take_handle(struct HandleTable* table) {
+    if (table->free_len > 0) {
+        return table->free[--table->free_len];
+    }
+    if (table->next_unused < table->capacity) {
+        return table->next_unused++;
+    }
+    return FA_VK_BINDLESS_INVALID_HANDLE;
+}
+
+static void retire_handle(struct HandleTable* table, FA_VkBindlessHandle handle) {
+    if (handle >= table->next_unused) {
+        return;
+    }
+
+    // The frame being recorded may use it too
+    uint32_t slot = (table->retired_head + table->retired_len) % table->capacity;
+    table->retired[slot] = handle;
+    table->retired_serials[slot] = frame_serial + 1;
+    table->retired_len++;
+}
+
+static void reclaim_handles(struct HandleTable* table) {
+    while (table->retired_len > 0 && table->retired_serials[table->retired_head] + frames_in_flight <= frame_serial) {
+        table->free[table->free_len++] = table->retired[table->retired_head];
+        table->retired_head = (table->retired_head + 1) % table->capacity;
+        table->retired_len--;
+    }
+}
+
+static uint32_t min_limit(uint32_t limit, uint32_t device_limit) {
+    return device_limit < limit ? device_limit : limit;
+}
+
+int _fa_vk_bindless_supported(const VkPhysicalDeviceFeatures* features,
+                              const VkPhysicalDeviceVulkan12Features* vulkan12_features) {
+    // Dynamic indexing covers handles from push constants, non uniform indexing covers handles which vary per vertex
+    return features->shaderSampledImageArrayDynamicIndexing
+        && features->shaderStorageBufferArrayDynamicIndexing
+        && vulkan12_features->runtimeDescriptorArray
+        && vulkan12_features->descriptorBindingPartiallyBound
+        && vulkan12_features->descriptorBindingSampledImageUpdateAfterBind
+        && vulkan12_features->descriptorBindingStorageBufferUpdateAfterBind
+        && vulkan12_features->descriptorBindingUpdateUnusedWhilePending
+        && vulkan12_features->shaderSampledImageArrayNonUniformIndexing
+        && vulkan12_features->shaderStorageBufferArrayNonUniformIndexing;
+}
+
+void _fa_vk_bindless_enable_features(VkPhysicalDeviceFeatures* features,
+                                     VkPhysicalDeviceVulkan12Features* vulkan12_features) {
+    features->shaderSampledImageArrayDynamicIndexing = VK_TRUE;
+    features->shaderStorageBufferArrayDynamicIndexing = VK_TRUE;
+    vulkan12_features->runtimeDescriptorArray = VK_TRUE;
+    vulkan12_features->descriptorBindingPartiallyBound = VK_TRUE;
+    vulkan12_features->descriptorBindingSampledImageUpdateAfterBind = VK_TRUE;
+    vulkan12_features->descriptorBindingStorageBufferUpdateAfterBind = VK_TRUE;
+    vulkan12_features->descriptorBindingUpdateUnusedWhilePending = VK_TRUE;
+    vulkan12_features->shaderSampledImageArrayNonUniformIndexing = VK_TRUE;
+    vulkan12_features->shaderStorageBufferArrayNonUniformIndexing = VK_TRUE;
+}
+
+void _fa_vk_bindless_init(VkPhysicalDevice physical_device, VkDevice logical_device, int frames) {
+    device = logical_device;
+    frames_in_flight = frames;
+    frame_serial = 0;
+
+    VkPhysicalDeviceVulkan12Properties vulkan12_properties;
+    memset(&vulkan12_properties, 0, sizeof(vulkan12_properties));
+    vulkan12_properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_PROPERTIES;
+    VkPhysicalDeviceProperties2 properties;
+    memset(&properties, 0, sizeof(properties));
+    properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+    properties.pNext = &vulkan12_properties;
+    vkGetPhysicalDeviceProperties2(physical_device, &properties);
+
+    // Every descriptor is visible to every stage, so the per stage limits apply to the whole table
+    uint32_t texture_count = MAX_TEXTURES;
+    texture_count = min_limit(texture_count, vulkan12_properties.maxDescriptorSetUpdateAfterBindSampledImages);
+    texture_count = min_limit(texture_count, vulkan12_properties.maxDescriptorSetUpdateAfterBindSamplers);
+    texture_count = min_limit(texture_count, vulkan12_properties.maxPerStageDescriptorUpdateAfterBindSampledImages);
+    texture_count = min_limit(texture_count, vulkan12_properties.maxPerStageDescriptorUpdateAfterBindSamplers);
+    uint32_t buffer_count = MAX_BUFFERS;
+    buffer_count = min_limit(buffer_count, vulkan12_properties.maxDescriptorSetUpdateAfterBindStorageBuffers);
+    buffer_count = min_limit(buffer_count, vulkan12_properties.maxPerStageDescriptorUpdateAfterBindStorageBuffers);
+    uint32_t resource_limit = vulkan12_properties.maxPerStageUpdateAfterBindResources;
+    if (texture_count + buffer_count > resource_limit) {
+        texture_count = min_limit(texture_count, resource_limit / 2);
+        buffer_count = resource_limit - texture_count;
+    }
+
+    VkDescriptorSetLayoutBinding bindings[2];
+    memset(bindings, 0, sizeof(bindings));
+    bindings[0].binding = FA_VK_BINDLESS_TEXTURE_BINDING;
+    bindings[0].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    bindings[0].descriptorCount = texture_count;
+    bindings[0].stageFlags = VK_SHADER_STAGE_ALL;
+    bindings[1].binding = FA_VK_BINDLESS_BUFFER_BINDING;
+    bindings[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    bindings[1].descriptorCount = buffer_count;
+    bindings[1].stageFlags = VK_SHADER_STAGE_ALL;
+
+    // Slots nothing was written to are fine as long as shaders never read them
+    VkDescriptorBindingFlags binding_flags[2];
+    for (int binding_idx = 0; binding_idx < 2; binding_idx++) {
+        binding_flags[binding_idx] = VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT
+                                   | VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT
+                                   | VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT;
+    }
+    VkDescriptorSetLayoutBindingFlagsCreateInfo flags_info;
+    memset(&flags_info, 0, sizeof(flags_info));
+    flags_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO;
+    flags_info.bindingCount = 2;
+    flags_info.pBindingFlags = binding_flags;
+
+    VkDescriptorSetLayoutCreateInfo layout_info;
+    memset(&layout_info, 0, sizeof(layout_info));
+    layout_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    layout_info.pNext = &flags_info;
+    layout_info.flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT;
+    layout_info.bindingCount = 2;
+    layout_info.pBindings = bindings;
+    if (vkCreateDescriptorSetLayout(device, &layout_info, NULL, &set_layout) != VK_SUCCESS) {
+        printf("Failed to create bindless descriptor set layout :(\n");
+        exit(1);
+    }
+
+    VkDescriptorPoolSize pool_sizes[2];
+    pool_sizes[0].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    pool_sizes[0].descriptorCount = texture_count;
+    pool_sizes[1].type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    pool_sizes[1].descriptorCount = buffer_count;
+
+    VkDescriptorPoolCreateInfo pool_info;
+    memset(&pool_info, 0, sizeof(pool_info));
+    pool_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    pool_info.flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT;
+    pool_info.maxSets = 1;
+    pool_info.poolSizeCount = 2;
+    pool_info.pPoolSizes = pool_sizes;
+    if (vkCreateDescriptorPool(device, &pool_info, NULL, &descriptor_pool) != VK_SUCCESS) {
+        printf("Failed to create bindless descriptor pool :(\n");
+        exit(1);
+    }
+
+    VkDescriptorSetAllocateInfo alloc_info;
+    memset(&alloc_info, 0, sizeof(alloc_info));
+    alloc_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    alloc_info.descriptorPool = descriptor_pool;
+    alloc_info.descriptorSetCount = 1;
+    alloc_info.pSetLayouts = &set_layout;
+    if (vkAllocateDescriptorSets(device, &alloc_info, &descriptor_set) != VK_SUCCESS) {
+        printf("Failed to allocate bindless descriptor set :(\n");
+        exit(1);
+    }
+
+    create_table(&textures, texture_count);
+    create_table(&buffers, buffer_count);
+}
+
+void _fa_vk_bindless_teardown() {
+    destroy_table(&textures);
+    destroy_table(&buffers);
+    vkDestroyDescriptorPool(device, descriptor_pool, NULL);
+    vkDestroyDescriptorSetLayout(device, set_layout, NULL);
+}
+
+void _fa_vk_bindless_begin_frame(uint64_t serial) {
+    frame_serial = serial;
+    reclaim_handles(&textures);
+    reclaim_handles(&buffers);
+}
+
+VkDescriptorSetLayout fa_vk_bindless_layout() {
+    return set_layout;
+}
+
+void fa_vk_bindless_bind(VkCommandBuffer command_buffer, VkPipelineBindPoint bind_point,
+                         VkPipelineLayout pipeline_layout) {
+    vkCmdBindDescriptorSets(command_buffer, bind_point, pipeline_layout, 0, 1, &descriptor_set, 0, NULL);
+}
+
+FA_VkBindlessHandle fa_vk_bindless_add_texture(VkImageView image_view, VkSampler sampler) {
+    FA_VkBindlessHandle handle = take_handle(&textures);
+    if (handle == FA_VK_BINDLESS_INVALID_HANDLE) {
+        return handle;
+    }
+
+    VkDescriptorImageInfo image_info;
+    image_info.sampler = sampler;
+    image_info.imageView = image_view;
+    image_info.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+    VkWriteDescriptorSet write;
+    memset(&write, 0, sizeof(write));
+    write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    write.dstSet = descriptor_set;
+    write.dstBinding = FA_VK_BINDLESS_TEXTURE_BINDING;
+    write.dstArrayElement = handle;
+    write.descriptorCount = 1;
+    write.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    write.pImageInfo = &image_info;
+    vkUpdateDescriptorSets(device, 1, &write, 0, NULL);
+    return handle;
+}
+
+FA_VkBindlessHandle fa_vk_bindless_add_buffer(VkBuffer buffer, VkDeviceSize offset, VkDeviceSize range) {
+    FA_VkBindlessHandle handle = take_handle(&buffers);
+    if (handle == FA_VK_BINDLESS_INVALID_HANDLE) {
+        return handle;
+    }
+
+    VkDescriptorBufferInfo buffer_info;
+    buffer_info.buffer = buffer;
+    buffer_info.offset = offset;
+    buffer_info.range = range;
+
+    VkWriteDescriptorSet write;
+    memset(&write, 0, sizeof(write));
+    write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    write.dstSet = descriptor_set;
+    write.dstBinding = FA_VK_BINDLESS_BUFFER_BINDING;
+    write.dstArrayElement = handle;
+    write.descriptorCount = 1;
+    write.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    write.pBufferInfo = &buffer_info;
+    vkUpdateDescriptorSets(device, 1, &write, 0, NULL);
+    return handle;
+}
+
+void fa_vk_bindless_remove_texture(FA_VkBindlessHandle handle) {
+    retire_handle(&textures, handle);
+}
+
+void fa_vk_bindless_remove_buffer(FA_VkBindlessHandle handle) {
+    retire_handle(&buffers, handle);
+}
\ No newline at end of file
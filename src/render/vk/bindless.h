@@ -0,0 +1,109 @@
+/**
+ * @file bindless.h
+ * @author ItsHighNoon
+ * @date 10-17-2026
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ * Bindless resources. Every texture and storage buffer lives in one large descriptor set which is bound once per
+ * command buffer, and shaders pick resources by an integer handle, usually passed in push constants or read from
+ * another buffer:
+ *
+ *     FA_VkBindlessHandle material = fa_vk_bindless_add_buffer(material_buffer, 0, VK_WHOLE_SIZE);
+ *     ...
+ *     vkCmdPushConstants(command_buffer, layout, VK_SHADER_STAGE_ALL_GRAPHICS, 0, sizeof(material), &material);
+ *
+ * The set layout matches shader/bindless.glsl. Descriptors are written with update after bind, so adding a resource
+ * never waits for frames in flight, and unwritten slots are left partially bound instead of needing a placeholder.
+ * Removed handles are only reused once every frame which could have used them finished.
+ *
+ * Needs the descriptor indexing features of Vulkan 1.2, see _fa_vk_bindless_supported. Not thread safe, resources are
+ * added and removed on the thread which renders.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <vulkan/vulkan.h>
+
+#define FA_VK_BINDLESS_TEXTURE_BINDING 0
+#define FA_VK_BINDLESS_BUFFER_BINDING 1
+
+typedef uint32_t FA_VkBindlessHandle;
+
+#define FA_VK_BINDLESS_INVALID_HANDLE UINT32_MAX
+
+/**
+ * Check whether a device has every feature bindless resources need.
+ * @param features The Vulkan 1.0 features of the device.
+ * @param vulkan12_features The Vulkan 1.2 features of the device.
+ * @return Nonzero if it does.
+ */
+int _fa_vk_bindless_supported(const VkPhysicalDeviceFeatures* features,
+                              const VkPhysicalDeviceVulkan12Features* vulkan12_features);
+
+/**
+ * Turn on the features bindless resources need.
+ * @param features The Vulkan 1.0 features the device will be created with.
+ * @param vulkan12_features The Vulkan 1.2 features the device will be created with.
+ */
+void _fa_vk_bindless_enable_features(VkPhysicalDeviceFeatures* features,
+                                     VkPhysicalDeviceVulkan12Features* vulkan12_features);
+
+/**
+ * @param frames The number of frames in flight.
+ */
+void _fa_vk_bindless_init(VkPhysicalDevice physical_device, VkDevice device, int frames);
+
+void _fa_vk_bindless_teardown();
+
+/**
+ * Let handles removed frames ago be handed out again. Call once the frame slot about to be reused has finished.
+ * @param frame_serial The number of frames submitted so far.
+ */
+void _fa_vk_bindless_begin_frame(uint64_t frame_serial);
+
+/**
+ * Get the layout of the bindless set, for building pipeline layouts.
+ * @return The layout, to be used as set 0.
+ */
+VkDescriptorSetLayout fa_vk_bindless_layout();
+
+/**
+ * Bind the bindless set as set 0.
+ * @param pipeline_layout A pipeline layout with fa_vk_bindless_layout as set 0.
+ */
+void fa_vk_bindless_bind(VkCommandBuffer command_buffer, VkPipelineBindPoint bind_point,
+                         VkPipelineLayout pipeline_layout);
+
+/**
+ * Make a texture available to shaders.
+ * @param image_view The texture. Has to be in VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL whenever shaders read it.
+ * @param sampler How to sample it.
+ * @return A handle to index the textures of shader/bindless.glsl with, or FA_VK_BINDLESS_INVALID_HANDLE if the table
+ *         is full.
+ */
+FA_VkBindlessHandle fa_vk_bindless_add_texture(VkImageView image_view, VkSampler sampler);
+
+/**
+ * Make a storage buffer available to shaders.
+ * @param buffer The buffer. Must have been created with VK_BUFFER_USAGE_STORAGE_BUFFER_BIT.
+ * @param offset Where the range shaders see starts.
+ * @param range The size of the range, or VK_WHOLE_SIZE.
+ * @return A handle to index the buffers of shader/bindless.glsl with, or FA_VK_BINDLESS_INVALID_HANDLE if the table
+ *         is full.
+ */
+FA_VkBindlessHandle fa_vk_bindless_add_buffer(VkBuffer buffer, VkDeviceSize offset, VkDeviceSize range);
+
+/**
+ * Stop shaders from using a texture. The handle is reused once frames recorded until now have finished, so the texture
+ * has to stay alive until then too.
+ * @param handle A handle returned by fa_vk_bindless_add_texture.
+ */
+void fa_vk_bindless_remove_texture(FA_VkBindlessHandle handle);
+
+/**
+ * Stop shaders from using a buffer, see fa_vk_bindless_remove_texture.
+ * @param handle A handle returned by fa_vk_bindless_add_buffer.
+ */
+void fa_vk_bindless_remove_buffer(FA_VkBindlessHandle handle);
\ No newline at end of file
@@ -0,0 +1,235 @@
+/**
+ * @file compute.c
+ * @author ItsHighNoon
+ * @date 10-17-2026
+ * 
+ * @copyright Copyright (c) 2026
+ */
+
+#include "compute.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define INITIAL_COMMAND_BUFFERS 4
+
+/*
+ * The command pool of one frame slot and the command buffers allocated from it. Buffers are handed out again after the
+ * pool is reset instead of being freed.
+ */
+struct ComputeFrame {
+    VkCommandPool command_pool;
+    VkCommandBuffer* command_buffers;
+    int command_buffers_len;
+    int command_buffers_used;
+    // The compute timeline reaches this once everything recorded from the pool has finished
+    uint64_t last_value;
+};
+
+static VkDevice device;
+static VkQueue queue;
+static uint32_t families[2];
+static int families_len;
+static int frame_count;
+static int current_frame;
+static struct ComputeFrame* frames;
+
+static VkSemaphore compute_timeline;
+static uint64_t compute_value;
+static VkSemaphore graphics_timeline;
+static uint64_t graphics_value;
+
+// What the frame being recorded waits for, 0 if nothing
+static uint64_t frame_wait_value;
+static VkPipelineStageFlags frame_wait_stage;
+
+static VkSemaphore create_timeline(const char* name) {
+    VkSemaphoreTypeCreateInfo type_info;
+    memset(&type_info, 0, sizeof(type_info));
+    type_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+    type_info.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+    type_info.initialValue = 0;
+
+    VkSemaphoreCreateInfo semaphore_info;
+    memset(&semaphore_info, 0, sizeof(semaphore_info));
+    semaphore_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+    semaphore_info.pNext = &type_info;
+    VkSemaphore semaphore;
+    if (vkCreateSemaphore(device, &semaphore_info, NULL, &semaphore) != VK_SUCCESS) {
+        printf("Failed to create %s semaphore :(\n", name);
+        exit(1);
+    }
+    return semaphore;
+}
+
+static void wait_for_value(uint64_t value) {
+    VkSemaphoreWaitInfo wait_info;
+    memset(&wait_info, 0, sizeof(wait_info));
+    wait_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+    wait_info.semaphoreCount = 1;
+    wait_info.pSemaphores = &compute_timeline;
+    wait_info.pValues = &value;
+    vkWaitSemaphores(device, &wait_info, UINT64_MAX);
+}
+
+void _fa_vk_compute_init(VkDevice logical_device, uint32_t compute_family, VkQueue compute_queue,
+                         uint32_t graphics_family, int frames_in_flight) {
+    device = logical_device;
+    queue = compute_queue;
+    families[0] = graphics_family;
+    families[1] = compute_family;
+    families_len = compute_family != graphics_family ? 2 : 1;
+    frame_count = frames_in_flight;
+    current_frame = 0;
+
+    compute_timeline = create_timeline("compute");
+    compute_value = 0;
+    graphics_timeline = create_timeline("graphics");
+    graphics_value = 0;
+    frame_wait_value = 0;
+    frame_wait_stage = 0;
+
+    frames = malloc(frame_count * sizeof(struct ComputeFrame));
+    for (int frame_idx = 0; frame_idx < frame_count; frame_idx++) {
+        memset(&frames[frame_idx], 0, sizeof(struct ComputeFrame));
+
+        VkCommandPoolCreateInfo pool_info;
+        memset(&pool_info, 0, sizeof(pool_info));
+        pool_info.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+        pool_info.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+        pool_info.queueFamilyIndex = compute_family;
+        if (vkCreateCommandPool(device, &pool_info, NULL, &frames[frame_idx].command_pool) != VK_SUCCESS) {
+            printf("Failed to create compute command pool :(\n");
+            exit(1);
+        }
+    }
+}
+
+void _fa_vk_compute_teardown() {
+    wait_for_value(compute_value);
+
+    for (int frame_idx = 0; frame_idx < frame_count; frame_idx++) {
+        // Frees the command buffers too
+        vkDestroyCommandPool(device, frames[frame_idx].command_pool, NULL);
+        free(frames[frame_idx].command_buffers);
+    }
+    free(frames);
+    frames = NULL;
+    vkDestroySemaphore(device, compute_timeline, NULL);
+    vkDestroySemaphore(device, graphics_timeline, NULL);
+}
+
+void _fa_vk_compute_begin_frame(int frame) {
+    current_frame = frame;
+    struct ComputeFrame* compute_frame = &frames[frame];
+    if (compute_frame->command_buffers_used > 0) {
+        // Nothing has to wait for compute work, so the fence of the frame does not cover it
+        wait_for_value(compute_frame->last_value);
+        vkResetCommandPool(device, compute_frame->command_pool, 0);
+        compute_frame->command_buffers_used = 0;
+    }
+}
+
+VkSemaphore _fa_vk_compute_acquire(uint64_t* wait_value, VkPipelineStageFlags* wait_stage) {
+    *wait_value = frame_wait_value;
+    *wait_stage = frame_wait_stage;
+    frame_wait_value = 0;
+    frame_wait_stage = 0;
+    return *wait_value > 0 ? compute_timeline : VK_NULL_HANDLE;
+}
+
+VkSemaphore _fa_vk_compute_frame_signal(uint64_t* signal_value) {
+    *signal_value = ++graphics_value;
+    return graphics_timeline;
+}
+
+int fa_vk_compute_async() {
+    return families_len == 2;
+}
+
+int fa_vk_compute_families(uint32_t out_families[2]) {
+    memcpy(out_families, families, families_len * sizeof(uint32_t));
+    return families_len;
+}
+
+VkCommandBuffer fa_vk_compute_begin() {
+    struct ComputeFrame* frame = &frames[current_frame];
+    if (frame->command_buffers_used == frame->command_buffers_len) {
+        int new_len = frame->command_buffers_len > 0 ? frame->command_buffers_len * 2 : INITIAL_COMMAND_BUFFERS;
+        frame->command_buffers = realloc(frame->command_buffers, new_len * sizeof(VkCommandBuffer));
+
+        VkCommandBufferAllocateInfo alloc_info;
+        memset(&alloc_info, 0, sizeof(alloc_info));
+        alloc_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        alloc_info.commandPool = frame->command_pool;
+        alloc_info.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        alloc_info.commandBufferCount = new_len - frame->command_buffers_len;
+        if (vkAllocateCommandBuffers(device, &alloc_info, &frame->command_buffers[frame->command_buffers_len])
+            != VK_SUCCESS) {
+            printf("Failed to allocate compute command buffers :(\n");
+            exit(1);
+        }
+        frame->command_buffers_len = new_len;
+    }
+    VkCommandBuffer command_buffer = frame->command_buffers[frame->command_buffers_used++];
+
+    VkCommandBufferBeginInfo begin_info;
+    memset(&begin_info, 0, sizeof(begin_info));
+    begin_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    begin_info.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    if (vkBeginCommandBuffer(command_buffer, &begin_info) != VK_SUCCESS) {
+        printf("Failed to begin compute command buffer :(\n");
+        exit(1);
+    }
+    return command_buffer;
+}
+
+uint64_t fa_vk_compute_submit(VkCommandBuffer command_buffer, uint64_t wait_value) {
+    if (vkEndCommandBuffer(command_buffer) != VK_SUCCESS) {
+        printf("Failed to record compute command buffer :(\n");
+        exit(1);
+    }
+
+    uint64_t signal_value = ++compute_value;
+    VkPipelineStageFlags wait_stage = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+
+    VkTimelineSemaphoreSubmitInfo timeline_info;
+    memset(&timeline_info, 0, sizeof(timeline_info));
+    timeline_info.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+    timeline_info.waitSemaphoreValueCount = wait_value > 0 ? 1 : 0;
+    timeline_info.pWaitSemaphoreValues = &wait_value;
+    timeline_info.signalSemaphoreValueCount = 1;
+    timeline_info.pSignalSemaphoreValues = &signal_value;
+
+    VkSubmitInfo submit_info;
+    memset(&submit_info, 0, sizeof(submit_info));
+    submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submit_info.pNext = &timeline_info;
+    submit_info.waitSemaphoreCount = wait_value > 0 ? 1 : 0;
+    submit_info.pWaitSemaphores = &graphics_timeline;
+    submit_info.pWaitDstStageMask = &wait_stage;
+    submit_info.commandBufferCount = 1;
+    submit_info.pCommandBuffers = &command_buffer;
+    submit_info.signalSemaphoreCount = 1;
+    submit_info.pSignalSemaphores = &compute_timeline;
+    if (vkQueueSubmit(queue, 1, &submit_info, VK_NULL_HANDLE) != VK_SUCCESS) {
+        printf("Failed to submit compute command buffer :(\n");
+        exit(1);
+    }
+
+    frames[current_frame].last_value = signal_value;
+    return signal_value;
+}
+
+uint64_t fa_vk_compute_graphics_value() {
+    return graphics_value;
+}
+
+void fa_vk_compute_wait(uint64_t value, VkPipelineStageFlags stage) {
+    // The timeline only counts up, so waiting for the latest value covers the earlier ones
+    if (value > frame_wait_value) {
+        frame_wait_value = value;
+    }
+    frame_wait_stage |= stage;
+}
\ No newline at end of file
@@ -0,0 +1,97 @@
+/**
+ * @file compute.h
+ * @author ItsHighNoon
+ * @date 10-17-2026
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ * Submits compute work to the async compute queue, which runs next to the graphics queue on devices with a compute
+ * family of its own. Elsewhere the compute queue is the graphics queue, and the same calls still work, the work just
+ * runs in order with the frames.
+ *
+ * Both queues count their progress on a timeline semaphore. Compute work can wait for a frame which was already
+ * submitted, and the frame being recorded can wait for compute work:
+ *     VkCommandBuffer command_buffer = fa_vk_compute_begin();
+ *     // Simulate particles written by the previous frame
+ *     uint64_t simulated = fa_vk_compute_submit(command_buffer, fa_vk_compute_graphics_value());
+ *     fa_vk_compute_wait(simulated, VK_PIPELINE_STAGE_VERTEX_SHADER_BIT);
+ * Resources used on both queues need VK_SHARING_MODE_CONCURRENT with the families from fa_vk_compute_families. Not
+ * thread safe, call everything from the thread which renders.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <vulkan/vulkan.h>
+
+/**
+ * @param compute_family The queue family of compute_queue. May be the same as graphics_family.
+ * @param compute_queue The queue to run compute work on.
+ * @param graphics_family The queue family which renders.
+ * @param frames The number of frames in flight.
+ */
+void _fa_vk_compute_init(VkDevice device, uint32_t compute_family, VkQueue compute_queue, uint32_t graphics_family,
+                         int frames);
+
+void _fa_vk_compute_teardown();
+
+/**
+ * Wait for the compute work submitted the last time this frame slot was used, and reuse its command buffers.
+ * @param frame The index of the frame in flight.
+ */
+void _fa_vk_compute_begin_frame(int frame);
+
+/**
+ * Take the compute work the frame being recorded waits for.
+ * @param wait_value Set to the value of the compute semaphore to wait for.
+ * @param wait_stage Set to the stages which wait.
+ * @return The semaphore to wait for before the frame runs, or VK_NULL_HANDLE if the frame waits for nothing.
+ */
+VkSemaphore _fa_vk_compute_acquire(uint64_t* wait_value, VkPipelineStageFlags* wait_stage);
+
+/**
+ * Advance the graphics timeline. Called right before the frame is submitted.
+ * @param signal_value Set to the value the frame has to signal.
+ * @return The semaphore the frame has to signal.
+ */
+VkSemaphore _fa_vk_compute_frame_signal(uint64_t* signal_value);
+
+/**
+ * @return 1 if compute work runs on a queue of its own, 0 if it shares the graphics queue.
+ */
+int fa_vk_compute_async();
+
+/**
+ * Get the queue families of the graphics and compute queues, for resources used on both.
+ * @param families Filled in with the distinct families.
+ * @return The number of families, 1 if compute shares the graphics family and 2 otherwise.
+ */
+int fa_vk_compute_families(uint32_t families[2]);
+
+/**
+ * Start recording compute work. The command buffer belongs to the current frame slot.
+ * @return A primary command buffer for the compute queue, already begun.
+ */
+VkCommandBuffer fa_vk_compute_begin();
+
+/**
+ * End and submit a command buffer from fa_vk_compute_begin.
+ * @param command_buffer The command buffer to submit.
+ * @param graphics_value The work waits at the compute shader stage until the graphics timeline reaches this value, see
+ *        fa_vk_compute_graphics_value. 0 to not wait.
+ * @return The value the compute timeline reaches once the work has finished.
+ */
+uint64_t fa_vk_compute_submit(VkCommandBuffer command_buffer, uint64_t graphics_value);
+
+/**
+ * @return The value the graphics timeline reaches once the last submitted frame has finished, or 0 before the first.
+ *         Only submitted frames can be waited for, otherwise a single queue would wait for itself.
+ */
+uint64_t fa_vk_compute_graphics_value();
+
+/**
+ * Make the frame being recorded wait for compute work.
+ * @param value A value returned by fa_vk_compute_submit.
+ * @param stage The stages of the frame which use the results.
+ */
+void fa_vk_compute_wait(uint64_t value, VkPipelineStageFlags stage);
\ No newline at end of file
@@ -0,0 +1,488 @@
+/**
+ * @file cull.c
+ * @author ItsHighNoon
+ * @date 10-17-2026
+ * 
+ * @copyright Copyright (c) 2026
+ */
+
+#include "cull.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "render/vk/bindless.h"
+#include "render/vk/draw_queue.h"
+#include "render/vk/memory.h"
+#include "render/vk/shaders.h"
+
+// Matches local_size_x of shader/cull.comp and shader/cull_compact.comp
+#define CULL_GROUP_SIZE 64
+// Matches the local size of shader/depth_pyramid.comp
+#define PYRAMID_GROUP_SIZE 8
+// Powers of two, so every level halves exactly
+#define PYRAMID_WIDTH 512
+#define PYRAMID_HEIGHT 256
+#define PYRAMID_LEVELS 10
+
+// Matches FA_CullViewBuffer in shader/cull.glsl
+struct CullView {
+    float planes[6][4];
+    float pyramid_view_projection[16];
+    float pyramid_size[2];
+    uint32_t pyramid_levels;
+    uint32_t occlusion;
+};
+
+// Matches shader/cull.comp
+struct CullConstants {
+    FA_VkBindlessHandle view;
+    FA_VkBindlessHandle objects;
+    FA_VkBindlessHandle commands;
+    FA_VkBindlessHandle visible;
+    FA_VkBindlessHandle instances;
+    FA_VkBindlessHandle pyramid;
+    uint32_t object_count;
+};
+
+// Matches shader/cull_compact.comp
+struct CompactConstants {
+    FA_VkBindlessHandle commands;
+    FA_VkBindlessHandle targets;
+    FA_VkBindlessHandle visible;
+    FA_VkBindlessHandle culled_commands;
+    FA_VkBindlessHandle counts;
+    uint32_t command_count;
+};
+
+// Matches shader/depth_pyramid.comp
+struct PyramidConstants {
+    FA_VkBindlessHandle depth;
+    uint32_t level;
+    uint32_t source_size[2];
+    uint32_t target_size[2];
+};
+
+struct ViewBuffer {
+    VkBuffer buffer;
+    FA_VkAllocation allocation;
+    FA_VkBindlessHandle handle;
+};
+
+static VkDevice device;
+static VkPipelineLayout cull_layout;
+static VkPipeline cull_pipeline;
+static VkPipeline compact_pipeline;
+
+static VkDescriptorSetLayout pyramid_set_layout;
+static VkDescriptorPool pyramid_pool;
+static VkDescriptorSet pyramid_sets[PYRAMID_LEVELS];
+static VkPipelineLayout pyramid_layout;
+static VkPipeline pyramid_pipeline;
+static VkImage pyramid_image;
+static FA_VkAllocation pyramid_allocation;
+static VkImageView pyramid_view;
+static VkImageView pyramid_level_views[PYRAMID_LEVELS];
+static FA_VkBindlessHandle pyramid_handle;
+static VkSampler sampler;
+// Whether the pyramid was built, and what with
+static int pyramid_built;
+static float pyramid_view_projection[16];
+
+static FA_VkBindlessHandle depth_handle;
+static VkExtent2D depth_extent;
+
+static struct ViewBuffer* view_buffers;
+static int frames_in_flight;
+static int frame_index;
+static float view_projection[16];
+
+static void set_identity(float matrix[16]) {
+    memset(matrix, 0, 16 * sizeof(float));
+    matrix[0] = 1.0f;
+    matrix[5] = 1.0f;
+    matrix[10] = 1.0f;
+    matrix[15] = 1.0f;
+}
+
+// Gribb and Hartmann, the planes are sums of the rows of the matrix. Left unnormalized, the shader scales the radius.
+static void extract_planes(const float matrix[16], float planes[6][4]) {
+    for (int column_idx = 0; column_idx < 4; column_idx++) {
+        const float* column = &matrix[column_idx * 4];
+        planes[0][column_idx] = column[3] + column[0];
+        planes[1][column_idx] = column[3] - column[0];
+        planes[2][column_idx] = column[3] + column[1];
+        planes[3][column_idx] = column[3] - column[1];
+        // Depth starts at 0 rather than -1
+        planes[4][column_idx] = column[2];
+        planes[5][column_idx] = column[3] - column[2];
+    }
+}
+
+static void compute_barrier(VkCommandBuffer command_buffer, VkPipelineStageFlags src_stage, VkAccessFlags src_access,
+                            VkPipelineStageFlags dst_stage, VkAccessFlags dst_access) {
+    VkMemoryBarrier barrier;
+    memset(&barrier, 0, sizeof(barrier));
+    barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    barrier.srcAccessMask = src_access;
+    barrier.dstAccessMask = dst_access;
+    vkCmdPipelineBarrier(command_buffer, src_stage, dst_stage, 0, 1, &barrier, 0, NULL, 0, NULL);
+}
+
+static void pyramid_barrier(VkCommandBuffer command_buffer, VkImageLayout old_layout, VkImageLayout new_layout,
+                            VkAccessFlags src_access, VkAccessFlags dst_access) {
+    VkImageMemoryBarrier barrier;
+    memset(&barrier, 0, sizeof(barrier));
+    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barrier.srcAccessMask = src_access;
+    barrier.dstAccessMask = dst_access;
+    barrier.oldLayout = old_layout;
+    barrier.newLayout = new_layout;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image = pyramid_image;
+    barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    barrier.subresourceRange.levelCount = PYRAMID_LEVELS;
+    barrier.subresourceRange.layerCount = 1;
+    vkCmdPipelineBarrier(command_buffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0,
+                         0, NULL, 0, NULL, 1, &barrier);
+}
+
+static VkPipelineLayout create_layout(int set_layouts_len, const VkDescriptorSetLayout* set_layouts,
+                                      uint32_t push_size) {
+    VkPushConstantRange push_range;
+    memset(&push_range, 0, sizeof(push_range));
+    push_range.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    push_range.size = push_size;
+
+    VkPipelineLayoutCreateInfo layout_info;
+    memset(&layout_info, 0, sizeof(layout_info));
+    layout_info.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    layout_info.setLayoutCount = set_layouts_len;
+    layout_info.pSetLayouts = set_layouts;
+    layout_info.pushConstantRangeCount = 1;
+    layout_info.pPushConstantRanges = &push_range;
+
+    VkPipelineLayout layout;
+    if (vkCreatePipelineLayout(device, &layout_info, NULL, &layout) != VK_SUCCESS) {
+        printf("Failed to create cull pipeline layout :(\n");
+        exit(1);
+    }
+    return layout;
+}
+
+static VkImageView create_pyramid_view(uint32_t base_level, uint32_t level_count) {
+    VkImageViewCreateInfo create_info;
+    memset(&create_info, 0, sizeof(create_info));
+    create_info.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+    create_info.image = pyramid_image;
+    create_info.viewType = VK_IMAGE_VIEW_TYPE_2D;
+    create_info.format = VK_FORMAT_R32_SFLOAT;
+    create_info.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    create_info.subresourceRange.baseMipLevel = base_level;
+    create_info.subresourceRange.levelCount = level_count;
+    create_info.subresourceRange.layerCount = 1;
+
+    VkImageView view;
+    if (vkCreateImageView(device, &create_info, NULL, &view) != VK_SUCCESS) {
+        printf("Failed to create depth pyramid view :(\n");
+        exit(1);
+    }
+    return view;
+}
+
+static void create_pyramid() {
+    VkImageCreateInfo create_info;
+    memset(&create_info, 0, sizeof(create_info));
+    create_info.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    create_info.imageType = VK_IMAGE_TYPE_2D;
+    create_info.format = VK_FORMAT_R32_SFLOAT;
+    create_info.extent.width = PYRAMID_WIDTH;
+    create_info.extent.height = PYRAMID_HEIGHT;
+    create_info.extent.depth = 1;
+    create_info.mipLevels = PYRAMID_LEVELS;
+    create_info.arrayLayers = 1;
+    create_info.samples = VK_SAMPLE_COUNT_1_BIT;
+    create_info.tiling = VK_IMAGE_TILING_OPTIMAL;
+    create_info.usage = VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+    create_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    create_info.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    if (fa_vk_memory_create_image(&create_info, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, &pyramid_image,
+                                  &pyramid_allocation) != 0) {
+        printf("Failed to create depth pyramid :(\n");
+        exit(1);
+    }
+
+    // Shaders only ever fetch texels, but combined image samplers need a sampler anyway
+    VkSamplerCreateInfo sampler_info;
+    memset(&sampler_info, 0, sizeof(sampler_info));
+    sampler_info.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+    sampler_info.magFilter = VK_FILTER_NEAREST;
+    sampler_info.minFilter = VK_FILTER_NEAREST;
+    sampler_info.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+    sampler_info.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    sampler_info.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    sampler_info.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    sampler_info.maxLod = VK_LOD_CLAMP_NONE;
+    if (vkCreateSampler(device, &sampler_info, NULL, &sampler) != VK_SUCCESS) {
+        printf("Failed to create depth pyramid sampler :(\n");
+        exit(1);
+    }
+
+    pyramid_view = create_pyramid_view(0, PYRAMID_LEVELS);
+    pyramid_handle = fa_vk_bindless_add_texture(pyramid_view, sampler);
+    for (int level_idx = 0; level_idx < PYRAMID_LEVELS; level_idx++) {
+        pyramid_level_views[level_idx] = create_pyramid_view(level_idx, 1);
+    }
+
+    // Each level reads the one above it, level 0 reads the depth buffer and gets itself as a placeholder
+    VkDescriptorSetLayoutBinding bindings[2];
+    memset(bindings, 0, sizeof(bindings));
+    for (int binding_idx = 0; binding_idx < 2; binding_idx++) {
+        bindings[binding_idx].binding = binding_idx;
+        bindings[binding_idx].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+        bindings[binding_idx].descriptorCount = 1;
+        bindings[binding_idx].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    }
+    VkDescriptorSetLayoutCreateInfo layout_info;
+    memset(&layout_info, 0, sizeof(layout_info));
+    layout_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    layout_info.bindingCount = 2;
+    layout_info.pBindings = bindings;
+    if (vkCreateDescriptorSetLayout(device, &layout_info, NULL, &pyramid_set_layout) != VK_SUCCESS) {
+        printf("Failed to create depth pyramid descriptor set layout :(\n");
+        exit(1);
+    }
+
+    VkDescriptorPoolSize pool_size;
+    pool_size.type = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+    pool_size.descriptorCount = 2 * PYRAMID_LEVELS;
+    VkDescriptorPoolCreateInfo pool_info;
+    memset(&pool_info, 0, sizeof(pool_info));
+    pool_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    pool_info.maxSets = PYRAMID_LEVELS;
+    pool_info.poolSizeCount = 1;
+    pool_info.pPoolSizes = &pool_size;
+    if (vkCreateDescriptorPool(device, &pool_info, NULL, &pyramid_pool) != VK_SUCCESS) {
+        printf("Failed to create depth pyramid descriptor pool :(\n");
+        exit(1);
+    }
+
+    VkDescriptorSetLayout set_layouts[PYRAMID_LEVELS];
+    for (int level_idx = 0; level_idx < PYRAMID_LEVELS; level_idx++) {
+        set_layouts[level_idx] = pyramid_set_layout;
+    }
+    VkDescriptorSetAllocateInfo alloc_info;
+    memset(&alloc_info, 0, sizeof(alloc_info));
+    alloc_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    alloc_info.descriptorPool = pyramid_pool;
+    alloc_info.descriptorSetCount = PYRAMID_LEVELS;
+    alloc_info.pSetLayouts = set_layouts;
+    if (vkAllocateDescriptorSets(device, &alloc_info, pyramid_sets) != VK_SUCCESS) {
+        printf("Failed to allocate depth pyramid descriptor sets :(\n");
+        exit(1);
+    }
+
+    VkDescriptorImageInfo image_infos[2 * PYRAMID_LEVELS];
+    VkWriteDescriptorSet writes[2 * PYRAMID_LEVELS];
+    memset(writes, 0, sizeof(writes));
+    for (int level_idx = 0; level_idx < PYRAMID_LEVELS; level_idx++) {
+        for (int binding_idx = 0; binding_idx < 2; binding_idx++) {
+            int write_idx = level_idx * 2 + binding_idx;
+            int view_idx = binding_idx == 0 && level_idx > 0 ? level_idx - 1 : level_idx;
+            image_infos[write_idx].sampler = VK_NULL_HANDLE;
+            image_infos[write_idx].imageView = pyramid_level_views[view_idx];
+            image_infos[write_idx].imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+            writes[write_idx].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            writes[write_idx].dstSet = pyramid_sets[level_idx];
+            writes[write_idx].dstBinding = binding_idx;
+            writes[write_idx].descriptorCount = 1;
+            writes[write_idx].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+            writes[write_idx].pImageInfo = &image_infos[write_idx];
+        }
+    }
+    vkUpdateDescriptorSets(device, 2 * PYRAMID_LEVELS, writes, 0, NULL);
+}
+
+void _fa_vk_cull_init(VkDevice logical_device, VkPipelineCache pipeline_cache, int frames) {
+    device = logical_device;
+    frames_in_flight = frames;
+    frame_index = 0;
+    pyramid_built = 0;
+    depth_handle = FA_VK_BINDLESS_INVALID_HANDLE;
+    set_identity(view_projection);
+    set_identity(pyramid_view_projection);
+
+    create_pyramid();
+
+    VkDescriptorSetLayout set_layouts[2] = { fa_vk_bindless_layout(), pyramid_set_layout };
+    uint32_t cull_push_size = sizeof(struct CullConstants);
+    if (sizeof(struct CompactConstants) > cull_push_size) {
+        cull_push_size = sizeof(struct CompactConstants);
+    }
+    cull_layout = create_layout(1, set_layouts, cull_push_size);
+    pyramid_layout = create_layout(2, set_layouts, sizeof(struct PyramidConstants));
+    cull_pipeline = _fa_vk_shader_create_compute_pipeline(device, pipeline_cache, "cull.comp", cull_layout);
+    compact_pipeline = _fa_vk_shader_create_compute_pipeline(device, pipeline_cache, "cull_compact.comp",
+                                                             cull_layout);
+    pyramid_pipeline = _fa_vk_shader_create_compute_pipeline(device, pipeline_cache, "depth_pyramid.comp",
+                                                             pyramid_layout);
+
+    view_buffers = malloc(frames * sizeof(struct ViewBuffer));
+    for (int frame_idx = 0; frame_idx < frames; frame_idx++) {
+        VkBufferCreateInfo create_info;
+        memset(&create_info, 0, sizeof(create_info));
+        create_info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+        create_info.size = sizeof(struct CullView);
+        create_info.usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
+        create_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        if (fa_vk_memory_create_buffer(&create_info, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT
+                                       | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                                       &view_buffers[frame_idx].buffer, &view_buffers[frame_idx].allocation) != 0) {
+            printf("Failed to create cull view buffer :(\n");
+            exit(1);
+        }
+        view_buffers[frame_idx].handle = fa_vk_bindless_add_buffer(view_buffers[frame_idx].buffer, 0, VK_WHOLE_SIZE);
+    }
+}
+
+void _fa_vk_cull_teardown() {
+    for (int frame_idx = 0; frame_idx < frames_in_flight; frame_idx++) {
+        fa_vk_bindless_remove_buffer(view_buffers[frame_idx].handle);
+        fa_vk_memory_destroy_buffer(view_buffers[frame_idx].buffer, &view_buffers[frame_idx].allocation);
+    }
+    free(view_buffers);
+    vkDestroyPipeline(device, pyramid_pipeline, NULL);
+    vkDestroyPipeline(device, compact_pipeline, NULL);
+    vkDestroyPipeline(device, cull_pipeline, NULL);
+    vkDestroyPipelineLayout(device, pyramid_layout, NULL);
+    vkDestroyPipelineLayout(device, cull_layout, NULL);
+    vkDestroyDescriptorPool(device, pyramid_pool, NULL);
+    vkDestroyDescriptorSetLayout(device, pyramid_set_layout, NULL);
+
+    fa_vk_bindless_remove_texture(depth_handle);
+    fa_vk_bindless_remove_texture(pyramid_handle);
+    for (int level_idx = 0; level_idx < PYRAMID_LEVELS; level_idx++) {
+        vkDestroyImageView(device, pyramid_level_views[level_idx], NULL);
+    }
+    vkDestroyImageView(device, pyramid_view, NULL);
+    vkDestroySampler(device, sampler, NULL);
+    fa_vk_memory_destroy_image(pyramid_image, &pyramid_allocation);
+}
+
+void _fa_vk_cull_begin_frame(int frame) {
+    frame_index = frame;
+}
+
+void _fa_vk_cull_set_depth(VkImageView depth_view, VkExtent2D extent) {
+    // Frames in flight may still build from the old one
+    if (depth_handle != FA_VK_BINDLESS_INVALID_HANDLE) {
+        fa_vk_bindless_remove_texture(depth_handle);
+    }
+    depth_handle = fa_vk_bindless_add_texture(depth_view, sampler);
+    depth_extent = extent;
+}
+
+void _fa_vk_cull_record(VkCommandBuffer command_buffer) {
+    FA_VkDrawQueueCullBuffers buffers;
+    _fa_vk_draw_queue_cull_buffers(&buffers);
+    if (buffers.object_count == 0) {
+        return;
+    }
+
+    struct CullView* view = view_buffers[frame_index].allocation.mapped;
+    extract_planes(view_projection, view->planes);
+    memcpy(view->pyramid_view_projection, pyramid_view_projection, sizeof(view->pyramid_view_projection));
+    view->pyramid_size[0] = PYRAMID_WIDTH;
+    view->pyramid_size[1] = PYRAMID_HEIGHT;
+    view->pyramid_levels = PYRAMID_LEVELS;
+    view->occlusion = pyramid_built;
+
+    // Both are added to, the other outputs are overwritten
+    vkCmdFillBuffer(command_buffer, buffers.visible_buffer, 0, buffers.command_count * sizeof(uint32_t), 0);
+    vkCmdFillBuffer(command_buffer, buffers.counts_buffer, 0, buffers.batch_count * sizeof(uint32_t), 0);
+    compute_barrier(command_buffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT,
+                    VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT);
+
+    struct CullConstants cull_constants;
+    cull_constants.view = view_buffers[frame_index].handle;
+    cull_constants.objects = buffers.objects;
+    cull_constants.commands = buffers.commands;
+    cull_constants.visible = buffers.visible;
+    cull_constants.instances = buffers.instances;
+    cull_constants.pyramid = pyramid_handle;
+    cull_constants.object_count = buffers.object_count;
+    vkCmdBindPipeline(command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE, cull_pipeline);
+    fa_vk_bindless_bind(command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE, cull_layout);
+    vkCmdPushConstants(command_buffer, cull_layout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(cull_constants),
+                       &cull_constants);
+    vkCmdDispatch(command_buffer, (buffers.object_count + CULL_GROUP_SIZE - 1) / CULL_GROUP_SIZE, 1, 1);
+    compute_barrier(command_buffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT,
+                    VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT);
+
+    struct CompactConstants compact_constants;
+    compact_constants.commands = buffers.commands;
+    compact_constants.targets = buffers.targets;
+    compact_constants.visible = buffers.visible;
+    compact_constants.culled_commands = buffers.culled_commands;
+    compact_constants.counts = buffers.counts;
+    compact_constants.command_count = buffers.command_count;
+    vkCmdBindPipeline(command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE, compact_pipeline);
+    vkCmdPushConstants(command_buffer, cull_layout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(compact_constants),
+                       &compact_constants);
+    vkCmdDispatch(command_buffer, (buffers.command_count + CULL_GROUP_SIZE - 1) / CULL_GROUP_SIZE, 1, 1);
+
+    // The commands and counts are read as indirect arguments, the instances by the vertex shader
+    compute_barrier(command_buffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT,
+                    VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT,
+                    VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_SHADER_READ_BIT);
+}
+
+void _fa_vk_cull_build_depth_pyramid(VkCommandBuffer command_buffer) {
+    if (depth_handle == FA_VK_BINDLESS_INVALID_HANDLE) {
+        return;
+    }
+
+    // Every level is rewritten, so the last frame's contents can go
+    pyramid_barrier(command_buffer, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_GENERAL, 0, VK_ACCESS_SHADER_WRITE_BIT);
+    vkCmdBindPipeline(command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE, pyramid_pipeline);
+    fa_vk_bindless_bind(command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE, pyramid_layout);
+
+    struct PyramidConstants constants;
+    constants.depth = depth_handle;
+    constants.source_size[0] = depth_extent.width;
+    constants.source_size[1] = depth_extent.height;
+    for (int level_idx = 0; level_idx < PYRAMID_LEVELS; level_idx++) {
+        uint32_t width = PYRAMID_WIDTH >> level_idx;
+        uint32_t height = PYRAMID_HEIGHT >> level_idx;
+        constants.level = level_idx;
+        constants.target_size[0] = width > 0 ? width : 1;
+        constants.target_size[1] = height > 0 ? height : 1;
+
+        vkCmdBindDescriptorSets(command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE, pyramid_layout, 1, 1,
+                                &pyramid_sets[level_idx], 0, NULL);
+        vkCmdPushConstants(command_buffer, pyramid_layout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(constants),
+                           &constants);
+        vkCmdDispatch(command_buffer, (constants.target_size[0] + PYRAMID_GROUP_SIZE - 1) / PYRAMID_GROUP_SIZE,
+                      (constants.target_size[1] + PYRAMID_GROUP_SIZE - 1) / PYRAMID_GROUP_SIZE, 1);
+        if (level_idx + 1 < PYRAMID_LEVELS) {
+            compute_barrier(command_buffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT,
+                            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT);
+        }
+
+        constants.source_size[0] = constants.target_size[0];
+        constants.source_size[1] = constants.target_size[1];
+    }
+
+    // Read by the cull pass of the next frame
+    pyramid_barrier(command_buffer, VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                    VK_ACCESS_SHADER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT);
+    memcpy(pyramid_view_projection, view_projection, sizeof(pyramid_view_projection));
+    pyramid_built = 1;
+}
+
+void fa_vk_cull_set_view(const float matrix[16]) {
+    memcpy(view_projection, matrix, sizeof(view_projection));
+}
\ No newline at end of file
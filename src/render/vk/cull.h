@@ -0,0 +1,61 @@
+/**
+ * @file cull.h
+ * @author ItsHighNoon
+ * @date 10-17-2026
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ * GPU culling of the draw queue, see render/vk/draw_queue.h. Before the main pass a compute pass tests the bounding
+ * sphere of every queued draw against the view frustum and against a depth pyramid of the previous frame, and writes
+ * the instances which survive into the commands the main pass draws. Where the device has drawIndirectCount, commands
+ * left without instances are compacted away, otherwise they are drawn with none.
+ *
+ * The depth pyramid has a fixed size, so it outlives resizes. Each texel holds the farthest depth of the part of the
+ * screen it covers, so a sphere is hidden if its nearest point is behind every texel it touches. Occlusion is tested
+ * with the view projection the pyramid was drawn with, so an object which comes out from behind something shows up a
+ * frame late at worst.
+ */
+
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+/**
+ * Call after _fa_vk_draw_queue_init.
+ * @param pipeline_cache The cache to create the compute pipelines through, or VK_NULL_HANDLE.
+ * @param frames The number of frames in flight.
+ */
+void _fa_vk_cull_init(VkDevice device, VkPipelineCache pipeline_cache, int frames);
+
+void _fa_vk_cull_teardown();
+
+/**
+ * Call once the frame slot about to be reused has finished.
+ * @param frame The index of the frame in flight.
+ */
+void _fa_vk_cull_begin_frame(int frame);
+
+/**
+ * Point the depth pyramid at the depth buffer of the main pass, whenever it is created.
+ * @param depth_view A view of the depth aspect. The image is in VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL once the main
+ *        pass ends, and has to stay alive until the frames recorded until now finished.
+ * @param extent The size of the depth buffer.
+ */
+void _fa_vk_cull_set_depth(VkImageView depth_view, VkExtent2D extent);
+
+/**
+ * Record the cull pass, outside any render pass, after _fa_vk_draw_queue_build.
+ */
+void _fa_vk_cull_record(VkCommandBuffer command_buffer);
+
+/**
+ * Record the depth pyramid build for the next frame, outside any render pass, after the main pass.
+ */
+void _fa_vk_cull_build_depth_pyramid(VkCommandBuffer command_buffer);
+
+/**
+ * Set the camera to cull against, starting with the next frame recorded. The identity until set, so positions are in
+ * clip space.
+ * @param view_projection The view projection matrix, column major like GLSL. Depth is 0 to 1 from near to far.
+ */
+void fa_vk_cull_set_view(const float view_projection[16]);
\ No newline at end of file
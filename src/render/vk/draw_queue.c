@@ -0,0 +1,462 @@
+/**
+ * @file draw_queue.c
+ * @author ItsHighNoon
+ * @date 10-17-2026
+ * 
+ * @copyright Copyright (c) 2026
+ */
+
+#include "draw_queue.h"
+
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "render/vk/bindless.h"
+#include "render/vk/memory.h"
+
+// Per frame, submissions past this are dropped
+#define MAX_DRAWS 65536
+#define MAX_PIPELINES (1 << FA_VK_DRAW_PIPELINE_BITS)
+#define RADIX_BITS 8
+#define RADIX_BUCKETS (1 << RADIX_BITS)
+// A command target whose command keeps its place instead of being compacted, matches shader/cull.glsl
+#define NOT_COMPACTED UINT32_MAX
+
+struct SortEntry {
+    uint64_t key;
+    uint32_t draw;
+};
+
+struct RegisteredPipeline {
+    VkPipeline pipeline;
+    VkPipelineLayout layout;
+};
+
+// One per queued draw, matches CullObject in shader/cull.glsl
+struct CullObject {
+    float bounds[4];
+    // The command it is an instance of
+    uint32_t command;
+    uint32_t instance;
+    uint32_t padding[2];
+};
+
+// Where the cull pass writes a command, matches CommandTarget in shader/cull.glsl
+struct CommandTarget {
+    // The count of the batch the command is appended to, or NOT_COMPACTED to write it where it is
+    uint32_t count_slot;
+    uint32_t first_command;
+};
+
+// Draws sharing a pass and pipeline, drawn by one indirect call
+struct Batch {
+    uint32_t pass;
+    uint32_t pipeline;
+    uint32_t first_command;
+    uint32_t command_count;
+};
+
+struct FrameBuffer {
+    VkBuffer buffer;
+    FA_VkAllocation allocation;
+    FA_VkBindlessHandle handle;
+};
+
+// Written every frame and read by the GPU, so each frame in flight has its own
+struct FrameBuffers {
+    // Written by the CPU
+    struct FrameBuffer objects;
+    struct FrameBuffer commands;
+    struct FrameBuffer targets;
+    // Written by the cull pass
+    struct FrameBuffer visible;
+    struct FrameBuffer instances;
+    struct FrameBuffer culled_commands;
+    struct FrameBuffer counts;
+};
+
+static VkDevice device;
+static int multi_draw_indirect;
+static int draw_indirect_count;
+static uint32_t max_draw_indirect_count;
+
+static struct RegisteredPipeline pipelines[MAX_PIPELINES];
+static uint32_t pipelines_len;
+
+static FA_VkDraw* draws;
+static atomic_int draws_len;
+static struct SortEntry* sorted;
+static struct SortEntry* sort_scratch;
+static struct Batch* batches;
+static int batches_len;
+static uint32_t objects_len;
+static uint32_t commands_len;
+
+static struct FrameBuffers* frame_buffers;
+static int frames_in_flight;
+static int frame_index;
+
+static void create_frame_buffer(VkDeviceSize size, VkBufferUsageFlags usage, int host_written,
+                                struct FrameBuffer* buffer) {
+    VkBufferCreateInfo create_info;
+    memset(&create_info, 0, sizeof(create_info));
+    create_info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    create_info.size = size;
+    create_info.usage = usage | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
+    create_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    VkMemoryPropertyFlags required = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+    VkMemoryPropertyFlags preferred = 0;
+    if (host_written) {
+        // Written straight from the CPU, ideally into device local memory where the device has some mappable
+        required = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+        preferred = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+    }
+    if (fa_vk_memory_create_buffer(&create_info, required, preferred, &buffer->buffer, &buffer->allocation) != 0) {
+        printf("Failed to create draw queue buffers :(\n");
+        exit(1);
+    }
+    buffer->handle = fa_vk_bindless_add_buffer(buffer->buffer, 0, VK_WHOLE_SIZE);
+}
+
+static void destroy_frame_buffer(struct FrameBuffer* buffer) {
+    fa_vk_bindless_remove_buffer(buffer->handle);
+    fa_vk_memory_destroy_buffer(buffer->buffer, &buffer->allocation);
+}
+
+// Batches whose count the GPU can read are compacted, the others are drawn with every command
+static int batch_compacted(const struct Batch* batch) {
+    return draw_indirect_count && batch->command_count <= max_draw_indirect_count;
+}
+
+// Least significant digit first, skipping digits every key shares, which the pass and pipeline usually are
+static void sort_entries(int count) {
+    uint64_t all_ones = ~0ull;
+    uint64_t all_zeros = 0;
+    for (int entry_idx = 0; entry_idx < count; entry_idx++) {
+        all_ones &= sorted[entry_idx].key;
+        all_zeros |= sorted[entry_idx].key;
+    }
+    uint64_t varying = all_ones ^ all_zeros;
+
+    for (int shift = 0; shift < 64; shift += RADIX_BITS) {
+        if (((varying >> shift) & (RADIX_BUCKETS - 1)) == 0) {
+            continue;
+        }
+
+        int offsets[RADIX_BUCKETS];
+        memset(offsets, 0, sizeof(offsets));
+        for (int entry_idx = 0; entry_idx < count; entry_idx++) {
+            offsets[(sorted[entry_idx].key >> shift) & (RADIX_BUCKETS - 1)]++;
+        }
+        int total = 0;
+        for (int bucket_idx = 0; bucket_idx < RADIX_BUCKETS; bucket_idx++) {
+            int bucket_count = offsets[bucket_idx];
+            offsets[bucket_idx] = total;
+            total += bucket_count;
+        }
+        for (int entry_idx = 0; entry_idx < count; entry_idx++) {
+            sort_scratch[offsets[(sorted[entry_idx].key >> shift) & (RADIX_BUCKETS - 1)]++] = sorted[entry_idx];
+        }
+
+        struct SortEntry* swap = sorted;
+        sorted = sort_scratch;
+        sort_scratch = swap;
+    }
+}
+
+// Same mesh, then the same key, which leaves only depth to differ, then the order the draws were queued in
+static int compare_meshes(const void* a, const void* b) {
+    const struct SortEntry* entry_a = a;
+    const struct SortEntry* entry_b = b;
+    const FA_VkMesh* mesh_a = &draws[entry_a->draw].mesh;
+    const FA_VkMesh* mesh_b = &draws[entry_b->draw].mesh;
+    if (mesh_a->first_index != mesh_b->first_index) {
+        return mesh_a->first_index < mesh_b->first_index ? -1 : 1;
+    }
+    if (mesh_a->index_count != mesh_b->index_count) {
+        return mesh_a->index_count < mesh_b->index_count ? -1 : 1;
+    }
+    if (mesh_a->vertex_offset != mesh_b->vertex_offset) {
+        return mesh_a->vertex_offset < mesh_b->vertex_offset ? -1 : 1;
+    }
+    if (entry_a->key != entry_b->key) {
+        return entry_a->key < entry_b->key ? -1 : 1;
+    }
+    return entry_a->draw < entry_b->draw ? -1 : entry_a->draw > entry_b->draw;
+}
+
+/*
+ * Depth is the lowest part of the key, so different meshes sharing a material end up interleaved. Pull each mesh
+ * together within every run of the same pass, pipeline and material, so it becomes one instanced command.
+ */
+static void group_meshes(int count) {
+    int run_start = 0;
+    while (run_start < count) {
+        uint64_t run_key = sorted[run_start].key >> FA_VK_DRAW_DEPTH_BITS;
+        const FA_VkMesh* first_mesh = &draws[sorted[run_start].draw].mesh;
+        int mixed = 0;
+        int run_end = run_start + 1;
+        while (run_end < count && sorted[run_end].key >> FA_VK_DRAW_DEPTH_BITS == run_key) {
+            const FA_VkMesh* mesh = &draws[sorted[run_end].draw].mesh;
+            mixed |= mesh->first_index != first_mesh->first_index || mesh->index_count != first_mesh->index_count
+                || mesh->vertex_offset != first_mesh->vertex_offset;
+            run_end++;
+        }
+        if (mixed) {
+            qsort(&sorted[run_start], run_end - run_start, sizeof(struct SortEntry), compare_meshes);
+        }
+        run_start = run_end;
+    }
+}
+
+int _fa_vk_draw_queue_supported(const VkPhysicalDeviceFeatures* features) {
+    // Instance data is found through firstInstance
+    return features->drawIndirectFirstInstance;
+}
+
+void _fa_vk_draw_queue_enable_features(const VkPhysicalDeviceFeatures* supported,
+                                       const VkPhysicalDeviceVulkan12Features* supported_vulkan12,
+                                       VkPhysicalDeviceFeatures* features,
+                                       VkPhysicalDeviceVulkan12Features* vulkan12_features) {
+    features->drawIndirectFirstInstance = VK_TRUE;
+    // Without these a batch takes one call per command instead of one call in total
+    multi_draw_indirect = supported->multiDrawIndirect;
+    features->multiDrawIndirect = supported->multiDrawIndirect;
+    draw_indirect_count = supported_vulkan12->drawIndirectCount;
+    vulkan12_features->drawIndirectCount = supported_vulkan12->drawIndirectCount;
+}
+
+void _fa_vk_draw_queue_init(VkPhysicalDevice physical_device, VkDevice logical_device, int frames) {
+    device = logical_device;
+    frames_in_flight = frames;
+    frame_index = 0;
+    pipelines_len = 0;
+    batches_len = 0;
+    objects_len = 0;
+    commands_len = 0;
+    atomic_store(&draws_len, 0);
+
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(physical_device, &properties);
+    max_draw_indirect_count = multi_draw_indirect ? properties.limits.maxDrawIndirectCount : 1;
+
+    draws = malloc(MAX_DRAWS * sizeof(FA_VkDraw));
+    sorted = malloc(MAX_DRAWS * sizeof(struct SortEntry));
+    sort_scratch = malloc(MAX_DRAWS * sizeof(struct SortEntry));
+    batches = malloc(MAX_DRAWS * sizeof(struct Batch));
+
+    frame_buffers = malloc(frames * sizeof(struct FrameBuffers));
+    for (int frame_idx = 0; frame_idx < frames; frame_idx++) {
+        struct FrameBuffers* buffers = &frame_buffers[frame_idx];
+        create_frame_buffer(MAX_DRAWS * sizeof(struct CullObject), 0, 1, &buffers->objects);
+        create_frame_buffer(MAX_DRAWS * sizeof(VkDrawIndexedIndirectCommand), 0, 1, &buffers->commands);
+        create_frame_buffer(MAX_DRAWS * sizeof(struct CommandTarget), 0, 1, &buffers->targets);
+        create_frame_buffer(MAX_DRAWS * sizeof(uint32_t), VK_BUFFER_USAGE_TRANSFER_DST_BIT, 0, &buffers->visible);
+        create_frame_buffer(MAX_DRAWS * sizeof(uint32_t), 0, 0, &buffers->instances);
+        create_frame_buffer(MAX_DRAWS * sizeof(VkDrawIndexedIndirectCommand), VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT, 0,
+                            &buffers->culled_commands);
+        create_frame_buffer(MAX_DRAWS * sizeof(uint32_t), VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT
+                            | VK_BUFFER_USAGE_TRANSFER_DST_BIT, 0, &buffers->counts);
+    }
+}
+
+void _fa_vk_draw_queue_teardown() {
+    for (int frame_idx = 0; frame_idx < frames_in_flight; frame_idx++) {
+        struct FrameBuffers* buffers = &frame_buffers[frame_idx];
+        destroy_frame_buffer(&buffers->objects);
+        destroy_frame_buffer(&buffers->commands);
+        destroy_frame_buffer(&buffers->targets);
+        destroy_frame_buffer(&buffers->visible);
+        destroy_frame_buffer(&buffers->instances);
+        destroy_frame_buffer(&buffers->culled_commands);
+        destroy_frame_buffer(&buffers->counts);
+    }
+    free(frame_buffers);
+    free(draws);
+    free(sorted);
+    free(sort_scratch);
+    free(batches);
+}
+
+void _fa_vk_draw_queue_begin_frame(int frame) {
+    frame_index = frame;
+    batches_len = 0;
+    objects_len = 0;
+    commands_len = 0;
+    atomic_store(&draws_len, 0);
+}
+
+void _fa_vk_draw_queue_build() {
+    int count = atomic_load(&draws_len);
+    if (count > MAX_DRAWS) {
+        printf("Dropped %d draws, the draw queue is full\n", count - MAX_DRAWS);
+        count = MAX_DRAWS;
+    }
+
+    for (int draw_idx = 0; draw_idx < count; draw_idx++) {
+        sorted[draw_idx].key = draws[draw_idx].key;
+        sorted[draw_idx].draw = draw_idx;
+    }
+    sort_entries(count);
+    group_meshes(count);
+
+    struct FrameBuffers* buffers = &frame_buffers[frame_index];
+    struct CullObject* objects = buffers->objects.allocation.mapped;
+    VkDrawIndexedIndirectCommand* commands = buffers->commands.allocation.mapped;
+    struct CommandTarget* targets = buffers->targets.allocation.mapped;
+    objects_len = 0;
+    commands_len = 0;
+    batches_len = 0;
+    const FA_VkDraw* previous = NULL;
+    for (int sorted_idx = 0; sorted_idx < count; sorted_idx++) {
+        const FA_VkDraw* draw = &draws[sorted[sorted_idx].draw];
+        uint32_t pass = draw->key >> (64 - FA_VK_DRAW_PASS_BITS);
+        uint32_t pipeline = (draw->key >> (FA_VK_DRAW_MATERIAL_BITS + FA_VK_DRAW_DEPTH_BITS)) & (MAX_PIPELINES - 1);
+        if (pipeline >= pipelines_len) {
+            continue;
+        }
+
+        struct Batch* batch = batches_len > 0 ? &batches[batches_len - 1] : NULL;
+        if (batch == NULL || batch->pass != pass || batch->pipeline != pipeline) {
+            batch = &batches[batches_len++];
+            batch->pass = pass;
+            batch->pipeline = pipeline;
+            batch->first_command = commands_len;
+            batch->command_count = 0;
+            previous = NULL;
+        }
+
+        // Instances of one command are consecutive, and group_meshes put every draw of a mesh next to each other
+        if (previous != NULL && previous->mesh.index_count == draw->mesh.index_count
+            && previous->mesh.first_index == draw->mesh.first_index
+            && previous->mesh.vertex_offset == draw->mesh.vertex_offset) {
+            commands[commands_len - 1].instanceCount++;
+        } else {
+            VkDrawIndexedIndirectCommand* command = &commands[commands_len++];
+            command->indexCount = draw->mesh.index_count;
+            command->instanceCount = 1;
+            command->firstIndex = draw->mesh.first_index;
+            command->vertexOffset = draw->mesh.vertex_offset;
+            command->firstInstance = objects_len;
+            batch->command_count++;
+        }
+        previous = draw;
+
+        // The cull pass writes the instances which survive, starting at the command's firstInstance
+        struct CullObject* object = &objects[objects_len++];
+        memcpy(object->bounds, draw->bounds, sizeof(object->bounds));
+        object->command = commands_len - 1;
+        object->instance = draw->instance;
+    }
+
+    for (int batch_idx = 0; batch_idx < batches_len; batch_idx++) {
+        const struct Batch* batch = &batches[batch_idx];
+        uint32_t count_slot = batch_compacted(batch) ? batch_idx : NOT_COMPACTED;
+        for (uint32_t command_idx = 0; command_idx < batch->command_count; command_idx++) {
+            targets[batch->first_command + command_idx].count_slot = count_slot;
+            targets[batch->first_command + command_idx].first_command = batch->first_command;
+        }
+    }
+}
+
+void _fa_vk_draw_queue_cull_buffers(FA_VkDrawQueueCullBuffers* cull_buffers) {
+    struct FrameBuffers* buffers = &frame_buffers[frame_index];
+    cull_buffers->object_count = objects_len;
+    cull_buffers->command_count = commands_len;
+    cull_buffers->batch_count = batches_len;
+    cull_buffers->objects = buffers->objects.handle;
+    cull_buffers->commands = buffers->commands.handle;
+    cull_buffers->targets = buffers->targets.handle;
+    cull_buffers->visible = buffers->visible.handle;
+    cull_buffers->instances = buffers->instances.handle;
+    cull_buffers->culled_commands = buffers->culled_commands.handle;
+    cull_buffers->counts = buffers->counts.handle;
+    cull_buffers->visible_buffer = buffers->visible.buffer;
+    cull_buffers->counts_buffer = buffers->counts.buffer;
+}
+
+uint32_t fa_vk_draw_queue_add_pipeline(VkPipeline pipeline, VkPipelineLayout layout) {
+    if (pipelines_len == MAX_PIPELINES) {
+        printf("Too many pipelines in the draw queue :(\n");
+        exit(1);
+    }
+
+    pipelines[pipelines_len].pipeline = pipeline;
+    pipelines[pipelines_len].layout = layout;
+    return pipelines_len++;
+}
+
+uint64_t fa_vk_draw_key(uint32_t pass, uint32_t pipeline, uint32_t material, float depth) {
+    // Flipping the sign bit of positive floats and every bit of negative ones makes them sort like integers
+    uint32_t depth_bits;
+    memcpy(&depth_bits, &depth, sizeof(depth_bits));
+    depth_bits = depth_bits & 0x80000000u ? ~depth_bits : depth_bits | 0x80000000u;
+
+    uint64_t key = pass & ((1u << FA_VK_DRAW_PASS_BITS) - 1);
+    key = (key << FA_VK_DRAW_PIPELINE_BITS) | (pipeline & ((1u << FA_VK_DRAW_PIPELINE_BITS) - 1));
+    key = (key << FA_VK_DRAW_MATERIAL_BITS) | (material & ((1u << FA_VK_DRAW_MATERIAL_BITS) - 1));
+    key = (key << FA_VK_DRAW_DEPTH_BITS) | depth_bits;
+    return key;
+}
+
+int fa_vk_draw_queue_submit(const FA_VkDraw* draw) {
+    int draw_idx = atomic_fetch_add_explicit(&draws_len, 1, memory_order_relaxed);
+    if (draw_idx >= MAX_DRAWS) {
+        return 1;
+    }
+
+    draws[draw_idx] = *draw;
+    return 0;
+}
+
+int fa_vk_draw_queue_pass_batches(uint32_t pass, int* first) {
+    // Batches are sorted by pass
+    int batch_idx = 0;
+    while (batch_idx < batches_len && batches[batch_idx].pass < pass) {
+        batch_idx++;
+    }
+    *first = batch_idx;
+    while (batch_idx < batches_len && batches[batch_idx].pass == pass) {
+        batch_idx++;
+    }
+    return batch_idx - *first;
+}
+
+void fa_vk_draw_queue_record(VkCommandBuffer command_buffer, int first, int count, void* data) {
+    struct FrameBuffers* buffers = &frame_buffers[frame_index];
+    vkCmdBindIndexBuffer(command_buffer, *(VkBuffer*)data, 0, VK_INDEX_TYPE_UINT32);
+
+    uint32_t bound_pipeline = MAX_PIPELINES;
+    for (int batch_idx = first; batch_idx < first + count; batch_idx++) {
+        const struct Batch* batch = &batches[batch_idx];
+        if (batch->pipeline != bound_pipeline) {
+            const struct RegisteredPipeline* pipeline = &pipelines[batch->pipeline];
+            vkCmdBindPipeline(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline->pipeline);
+            fa_vk_bindless_bind(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline->layout);
+            vkCmdPushConstants(command_buffer, pipeline->layout, VK_SHADER_STAGE_ALL_GRAPHICS, 0,
+                               sizeof(FA_VkBindlessHandle), &buffers->instances.handle);
+            bound_pipeline = batch->pipeline;
+        }
+
+        VkDeviceSize offset = batch->first_command * sizeof(VkDrawIndexedIndirectCommand);
+        if (batch_compacted(batch)) {
+            // The cull pass counted the commands left with any instances
+            vkCmdDrawIndexedIndirectCount(command_buffer, buffers->culled_commands.buffer, offset,
+                                          buffers->counts.buffer, batch_idx * sizeof(uint32_t), batch->command_count,
+                                          sizeof(VkDrawIndexedIndirectCommand));
+            continue;
+        }
+        // Culled commands are still drawn, with no instances
+        for (uint32_t command_idx = 0; command_idx < batch->command_count; command_idx += max_draw_indirect_count) {
+            uint32_t draw_count = batch->command_count - command_idx;
+            if (draw_count > max_draw_indirect_count) {
+                draw_count = max_draw_indirect_count;
+            }
+            vkCmdDrawIndexedIndirect(command_buffer, buffers->culled_commands.buffer,
+                                     offset + command_idx * sizeof(VkDrawIndexedIndirectCommand), draw_count,
+                                     sizeof(VkDrawIndexedIndirectCommand));
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,166 @@
+/**
+ * @file draw_queue.h
+ * @author ItsHighNoon
+ * @date 10-17-2026
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ * Sorted draw submission. Any thread queues draws for the frame being built, each with a 64 bit key made from its
+ * pass, pipeline, material and depth. Once everything is queued the render thread sorts the draws by key, merges the
+ * draws of each mesh sharing a pass, pipeline and material into one instanced command, and writes the commands to a
+ * buffer on the GPU. Every run of draws sharing a pass and pipeline then costs one bind and one indirect draw call,
+ * however many objects it holds. Before anything is drawn, the cull pass of render/vk/cull.h drops the instances whose
+ * bounds can't be seen.
+ *
+ *     FA_VkDraw draw;
+ *     draw.key = fa_vk_draw_key(FA_VK_PASS_MAIN, pipeline_id, material, view_depth);
+ *     draw.mesh = rock_mesh;
+ *     draw.instance = rock_object_handle;
+ *     memcpy(draw.bounds, rock_sphere, sizeof(draw.bounds));
+ *     fa_vk_draw_queue_submit(&draw);
+ *
+ * Shaders find the instance value of each object at fa_uint_buffers[instances].data[gl_InstanceIndex], where instances
+ * is the handle pushed in the first 4 bytes of push constants, see shader/bindless.glsl. Meshes all live in one index
+ * buffer, and vertices are pulled from storage buffers by the shaders.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <vulkan/vulkan.h>
+
+#include "render/vk/bindless.h"
+
+// Passes sort before pipelines, which sort before materials, which sort before depth
+#define FA_VK_DRAW_PASS_BITS 4
+#define FA_VK_DRAW_PIPELINE_BITS 12
+#define FA_VK_DRAW_MATERIAL_BITS 16
+#define FA_VK_DRAW_DEPTH_BITS 32
+
+#define FA_VK_PASS_MAIN 0
+
+typedef struct {
+    uint32_t index_count;
+    uint32_t first_index;
+    int32_t vertex_offset;
+} FA_VkMesh;
+
+typedef struct {
+    // Made by fa_vk_draw_key
+    uint64_t key;
+    FA_VkMesh mesh;
+    // Handed to the shader for this instance, usually a handle to the object's data
+    uint32_t instance;
+    // Bounding sphere in world space, the center then the radius. Never culled if the radius is negative.
+    float bounds[4];
+} FA_VkDraw;
+
+// The buffers of the frame being built, as bindless handles unless noted otherwise
+typedef struct {
+    uint32_t object_count;
+    uint32_t command_count;
+    uint32_t batch_count;
+    // Read by the cull pass, see shader/cull.glsl
+    FA_VkBindlessHandle objects;
+    FA_VkBindlessHandle commands;
+    FA_VkBindlessHandle targets;
+    // Written by the cull pass, and drawn from
+    FA_VkBindlessHandle visible;
+    FA_VkBindlessHandle instances;
+    FA_VkBindlessHandle culled_commands;
+    FA_VkBindlessHandle counts;
+    // Zeroed before the cull pass adds to them
+    VkBuffer visible_buffer;
+    VkBuffer counts_buffer;
+} FA_VkDrawQueueCullBuffers;
+
+/**
+ * Check whether a device can run the draw queue.
+ * @param features The Vulkan 1.0 features of the device.
+ * @return Nonzero if it can.
+ */
+int _fa_vk_draw_queue_supported(const VkPhysicalDeviceFeatures* features);
+
+/**
+ * Turn on the features the draw queue needs, and the ones it can use if the device has them.
+ * @param supported The Vulkan 1.0 features of the device.
+ * @param supported_vulkan12 The Vulkan 1.2 features of the device.
+ * @param features The Vulkan 1.0 features the device will be created with.
+ * @param vulkan12_features The Vulkan 1.2 features the device will be created with.
+ */
+void _fa_vk_draw_queue_enable_features(const VkPhysicalDeviceFeatures* supported,
+                                       const VkPhysicalDeviceVulkan12Features* supported_vulkan12,
+                                       VkPhysicalDeviceFeatures* features,
+                                       VkPhysicalDeviceVulkan12Features* vulkan12_features);
+
+/**
+ * Call after _fa_vk_bindless_init and _fa_vk_draw_queue_enable_features.
+ * @param frames The number of frames in flight.
+ */
+void _fa_vk_draw_queue_init(VkPhysicalDevice physical_device, VkDevice device, int frames);
+
+void _fa_vk_draw_queue_teardown();
+
+/**
+ * Start collecting draws for a frame. Call on the render thread once the frame slot has finished on the GPU.
+ * @param frame The index of the frame in flight.
+ */
+void _fa_vk_draw_queue_begin_frame(int frame);
+
+/**
+ * Sort the draws queued this frame and write their commands. Call on the render thread after every submission for the
+ * frame has returned.
+ */
+void _fa_vk_draw_queue_build();
+
+/**
+ * Get the buffers of the frame being built, for the cull pass.
+ * @param buffers Filled in with the buffers, valid until the next _fa_vk_draw_queue_begin_frame.
+ */
+void _fa_vk_draw_queue_cull_buffers(FA_VkDrawQueueCullBuffers* buffers);
+
+/**
+ * Register a pipeline for draw keys to refer to.
+ * @param pipeline The pipeline.
+ * @param layout Its layout. Has to start with fa_vk_bindless_layout as set 0 and a 4 byte push constant for the
+ *        instance buffer handle, visible to every graphics stage.
+ * @return The id to pass to fa_vk_draw_key.
+ */
+uint32_t fa_vk_draw_queue_add_pipeline(VkPipeline pipeline, VkPipelineLayout layout);
+
+/**
+ * Pack the sort key of a draw. Each part is cut to its number of bits.
+ * @param pass The pass the draw belongs to, such as FA_VK_PASS_MAIN.
+ * @param pipeline An id from fa_vk_draw_queue_add_pipeline.
+ * @param material Anything draws should be grouped by within a pipeline, usually the material's bindless handle.
+ * @param depth Distance from the camera. Draws of the same mesh and material nearer the camera come first, negate it
+ *        to draw back to front. Different meshes sharing a material are not ordered by depth.
+ * @return The key.
+ */
+uint64_t fa_vk_draw_key(uint32_t pass, uint32_t pipeline, uint32_t material, float depth);
+
+/**
+ * Queue a draw for the current frame. Thread safe.
+ * @param draw The draw. Copied before this returns.
+ * @return 0 on success, 1 if the queue is full for this frame.
+ */
+int fa_vk_draw_queue_submit(const FA_VkDraw* draw);
+
+/**
+ * Find the batches of a pass, after _fa_vk_draw_queue_build.
+ * @param pass The pass.
+ * @param first Set to the first batch of the pass.
+ * @return The number of batches in the pass.
+ */
+int fa_vk_draw_queue_pass_batches(uint32_t pass, int* first);
+
+/**
+ * Record a range of batches. Matches FA_VkRecordFunction, with data pointing at the index buffer, so batches can be
+ * spread over threads with fa_vk_record_parallel. Draws what the cull pass left, so the cull pass has to be recorded
+ * first.
+ * @param command_buffer A command buffer inside the render pass of the batches' pass.
+ * @param first The first batch to record.
+ * @param count The number of batches to record.
+ * @param data Points at the VkBuffer holding the indices of every mesh.
+ */
+void fa_vk_draw_queue_record(VkCommandBuffer command_buffer, int first, int count, void* data);
\ No newline at end of file
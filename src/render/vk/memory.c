@@ -0,0 +1,608 @@
+/**
+ * @file memory.c
+ * @author ItsHighNoon
+ * @date 10-17-2026
+ * 
+ * @copyright Copyright (c) 2026
+ */
+
+#include "memory.h"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define BLOCK_SIZE (64ull * 1024 * 1024)
+// Smaller heaps, like the 256MiB host visible device local heap on many GPUs, get proportionally smaller blocks
+#define BLOCK_HEAP_FRACTION 8
+#define MIN_ALIGNMENT 16
+#define NODE_CHUNK 256
+
+// Two level segregated fit. Each power of two size range is split into SL_COUNT linear steps.
+#define SL_BITS 4
+#define SL_COUNT (1 << SL_BITS)
+#define FL_COUNT 64
+
+// Buffers and linear images in one class, optimally tiled images in the other
+#define RESOURCE_CLASSES 2
+
+struct FA_VkMemoryNodeStruct {
+    VkDeviceSize offset;
+    VkDeviceSize size;
+    int free;
+    struct FA_VkMemoryNodeStruct* prev_physical;
+    struct FA_VkMemoryNodeStruct* next_physical;
+    struct FA_VkMemoryNodeStruct* prev_free;
+    struct FA_VkMemoryNodeStruct* next_free;
+};
+
+struct FA_VkMemoryBlockStruct {
+    VkDeviceMemory memory;
+    VkDeviceSize size;
+    void* mapped;
+    uint32_t memory_type;
+    int resource_class;
+    // Holds exactly one resource which was too big to share a block
+    int dedicated;
+    VkDeviceSize used;
+    int allocation_count;
+    // The node at offset zero, which is never merged away
+    FA_VkMemoryNode* first_node;
+
+    uint64_t fl_map;
+    uint32_t sl_map[FL_COUNT];
+    FA_VkMemoryNode* free_lists[FL_COUNT][SL_COUNT];
+
+    struct FA_VkMemoryBlockStruct* prev;
+    struct FA_VkMemoryBlockStruct* next;
+};
+
+typedef struct NodeChunkStruct {
+    struct NodeChunkStruct* next;
+    FA_VkMemoryNode nodes[NODE_CHUNK];
+} NodeChunk;
+
+static VkDevice device;
+static VkPhysicalDeviceMemoryProperties memory_properties;
+static VkDeviceSize buffer_image_granularity;
+
+static pthread_mutex_t memory_lock = PTHREAD_MUTEX_INITIALIZER;
+static FA_VkMemoryBlock* blocks[VK_MAX_MEMORY_TYPES][RESOURCE_CLASSES];
+static NodeChunk* node_chunks;
+static FA_VkMemoryNode* spare_nodes;
+
+static VkDeviceSize align_up(VkDeviceSize value, VkDeviceSize alignment) {
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+static FA_VkMemoryNode* new_node() {
+    if (spare_nodes == NULL) {
+        NodeChunk* chunk = malloc(sizeof(NodeChunk));
+        chunk->next = node_chunks;
+        node_chunks = chunk;
+        for (int node_idx = 0; node_idx < NODE_CHUNK; node_idx++) {
+            chunk->nodes[node_idx].next_free = spare_nodes;
+            spare_nodes = &chunk->nodes[node_idx];
+        }
+    }
+
+    FA_VkMemoryNode* node = spare_nodes;
+    spare_nodes = node->next_free;
+    memset(node, 0, sizeof(FA_VkMemoryNode));
+    return node;
+}
+
+static void delete_node(FA_VkMemoryNode* node) {
+    node->next_free = spare_nodes;
+    spare_nodes = node;
+}
+
+static void mapping_insert(VkDeviceSize size, int* fl, int* sl) {
+    // Sizes are multiples of MIN_ALIGNMENT, so the top bit is always at least SL_BITS
+    int bit = 63 - __builtin_clzll(size);
+    *fl = bit - SL_BITS;
+    *sl = (int)(size >> (bit - SL_BITS)) - SL_COUNT;
+}
+
+// Round up to the next list boundary, so every node in the list found is big enough
+static void mapping_search(VkDeviceSize size, int* fl, int* sl) {
+    int bit = 63 - __builtin_clzll(size);
+    size += (1ull << (bit - SL_BITS)) - 1;
+    mapping_insert(size, fl, sl);
+}
+
+static void insert_free(FA_VkMemoryBlock* block, FA_VkMemoryNode* node) {
+    int fl;
+    int sl;
+    mapping_insert(node->size, &fl, &sl);
+
+    node->free = 1;
+    node->prev_free = NULL;
+    node->next_free = block->free_lists[fl][sl];
+    if (node->next_free != NULL) {
+        node->next_free->prev_free = node;
+    }
+    block->free_lists[fl][sl] = node;
+    block->fl_map |= 1ull << fl;
+    block->sl_map[fl] |= 1u << sl;
+}
+
+static void remove_free(FA_VkMemoryBlock* block, FA_VkMemoryNode* node) {
+    int fl;
+    int sl;
+    mapping_insert(node->size, &fl, &sl);
+
+    if (node->prev_free != NULL) {
+        node->prev_free->next_free = node->next_free;
+    } else {
+        block->free_lists[fl][sl] = node->next_free;
+    }
+    if (node->next_free != NULL) {
+        node->next_free->prev_free = node->prev_free;
+    }
+
+    if (block->free_lists[fl][sl] == NULL) {
+        block->sl_map[fl] &= ~(1u << sl);
+        if (block->sl_map[fl] == 0) {
+            block->fl_map &= ~(1ull << fl);
+        }
+    }
+    node->free = 0;
+}
+
+static FA_VkMemoryNode* find_free(FA_VkMemoryBlock* block, VkDeviceSize size) {
+    int fl;
+    int sl;
+    mapping_search(size, &fl, &sl);
+    if (fl >= FL_COUNT) {
+        return NULL;
+    }
+
+    uint32_t sl_map = block->sl_map[fl] & (~0u << sl);
+    if (sl_map == 0) {
+        uint64_t fl_map = fl + 1 < FL_COUNT ? block->fl_map & (~0ull << (fl + 1)) : 0;
+        if (fl_map == 0) {
+            return NULL;
+        }
+        fl = __builtin_ctzll(fl_map);
+        sl_map = block->sl_map[fl];
+    }
+    sl = __builtin_ctz(sl_map);
+    return block->free_lists[fl][sl];
+}
+
+// Split the end off a node, keeping size bytes in the node itself
+static void split_after(FA_VkMemoryBlock* block, FA_VkMemoryNode* node, VkDeviceSize size) {
+    FA_VkMemoryNode* rest = new_node();
+    rest->offset = node->offset + size;
+    rest->size = node->size - size;
+    rest->prev_physical = node;
+    rest->next_physical = node->next_physical;
+    if (rest->next_physical != NULL) {
+        rest->next_physical->prev_physical = rest;
+    }
+    node->next_physical = rest;
+    node->size = size;
+    insert_free(block, rest);
+}
+
+static FA_VkMemoryNode* block_allocate(FA_VkMemoryBlock* block, VkDeviceSize size, VkDeviceSize alignment) {
+    // Offsets are always multiples of MIN_ALIGNMENT, so this is the most padding alignment can take
+    VkDeviceSize padding_bound = alignment > MIN_ALIGNMENT ? alignment - MIN_ALIGNMENT : 0;
+    FA_VkMemoryNode* node = find_free(block, size + padding_bound);
+    if (node == NULL) {
+        return NULL;
+    }
+    remove_free(block, node);
+
+    VkDeviceSize padding = align_up(node->offset, alignment) - node->offset;
+    if (padding > 0) {
+        // The node before is in use, free neighbours are always merged, so the padding becomes a node of its own
+        split_after(block, node, padding);
+        FA_VkMemoryNode* padding_node = node;
+        node = node->next_physical;
+        remove_free(block, node);
+        insert_free(block, padding_node);
+    }
+    if (node->size - size >= MIN_ALIGNMENT) {
+        split_after(block, node, size);
+    }
+
+    block->used += node->size;
+    block->allocation_count++;
+    return node;
+}
+
+static void block_free(FA_VkMemoryBlock* block, FA_VkMemoryNode* node) {
+    block->used -= node->size;
+    block->allocation_count--;
+
+    FA_VkMemoryNode* prev = node->prev_physical;
+    if (prev != NULL && prev->free) {
+        remove_free(block, prev);
+        prev->size += node->size;
+        prev->next_physical = node->next_physical;
+        if (node->next_physical != NULL) {
+            node->next_physical->prev_physical = prev;
+        }
+        delete_node(node);
+        node = prev;
+    }
+
+    FA_VkMemoryNode* next = node->next_physical;
+    if (next != NULL && next->free) {
+        remove_free(block, next);
+        node->size += next->size;
+        node->next_physical = next->next_physical;
+        if (next->next_physical != NULL) {
+            next->next_physical->prev_physical = node;
+        }
+        delete_node(next);
+    }
+
+    insert_free(block, node);
+}
+
+static VkDeviceSize block_size_for_type(uint32_t memory_type) {
+    VkDeviceSize heap_size = memory_properties.memoryHeaps[memory_properties.memoryTypes[memory_type].heapIndex].size;
+    VkDeviceSize size = BLOCK_SIZE;
+    if (heap_size / BLOCK_HEAP_FRACTION < size) {
+        size = align_up(heap_size / BLOCK_HEAP_FRACTION, MIN_ALIGNMENT);
+    }
+    return size;
+}
+
+static FA_VkMemoryBlock* create_block(uint32_t memory_type, int resource_class, VkDeviceSize size, int dedicated) {
+    VkMemoryAllocateInfo alloc_info;
+    memset(&alloc_info, 0, sizeof(alloc_info));
+    alloc_info.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    alloc_info.allocationSize = size;
+    alloc_info.memoryTypeIndex = memory_type;
+
+    VkDeviceMemory memory;
+    if (vkAllocateMemory(device, &alloc_info, NULL, &memory) != VK_SUCCESS) {
+        return NULL;
+    }
+
+    // Host visible blocks stay mapped for their whole life, mapping is not free on every driver
+    void* mapped = NULL;
+    if (memory_properties.memoryTypes[memory_type].propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) {
+        if (vkMapMemory(device, memory, 0, VK_WHOLE_SIZE, 0, &mapped) != VK_SUCCESS) {
+            vkFreeMemory(device, memory, NULL);
+            return NULL;
+        }
+    }
+
+    FA_VkMemoryBlock* block = calloc(1, sizeof(FA_VkMemoryBlock));
+    block->memory = memory;
+    block->size = size;
+    block->mapped = mapped;
+    block->memory_type = memory_type;
+    block->resource_class = resource_class;
+    block->dedicated = dedicated;
+
+    FA_VkMemoryNode* node = new_node();
+    node->size = size;
+    insert_free(block, node);
+    block->first_node = node;
+
+    block->next = blocks[memory_type][resource_class];
+    if (block->next != NULL) {
+        block->next->prev = block;
+    }
+    blocks[memory_type][resource_class] = block;
+    return block;
+}
+
+static void destroy_block(FA_VkMemoryBlock* block) {
+    if (block->prev != NULL) {
+        block->prev->next = block->next;
+    } else {
+        blocks[block->memory_type][block->resource_class] = block->next;
+    }
+    if (block->next != NULL) {
+        block->next->prev = block->prev;
+    }
+
+    FA_VkMemoryNode* node = block->first_node;
+    while (node != NULL) {
+        FA_VkMemoryNode* next = node->next_physical;
+        delete_node(node);
+        node = next;
+    }
+
+    if (block->mapped != NULL) {
+        vkUnmapMemory(device, block->memory);
+    }
+    vkFreeMemory(device, block->memory, NULL);
+    free(block);
+}
+
+static int allocate_from_type(uint32_t memory_type, int resource_class, VkDeviceSize size, VkDeviceSize alignment,
+                              FA_VkAllocation* allocation) {
+    VkDeviceSize block_size = block_size_for_type(memory_type);
+    FA_VkMemoryBlock* block = NULL;
+    FA_VkMemoryNode* node = NULL;
+
+    if (size > block_size / 2) {
+        // Would waste most of a block, give it memory of its own
+        block = create_block(memory_type, resource_class, size, 1);
+        if (block != NULL) {
+            // The one node is exactly size bytes, which find_free would round past, and offset zero is always aligned
+            node = block->first_node;
+            remove_free(block, node);
+            block->used += node->size;
+            block->allocation_count++;
+        }
+    } else {
+        for (block = blocks[memory_type][resource_class]; block != NULL; block = block->next) {
+            if (!block->dedicated && (node = block_allocate(block, size, alignment)) != NULL) {
+                break;
+            }
+        }
+        if (node == NULL) {
+            block = create_block(memory_type, resource_class, block_size, 0);
+            if (block != NULL) {
+                node = block_allocate(block, size, alignment);
+                if (node == NULL) {
+                    // Padded past the end of a whole block, no point keeping it around empty
+                    destroy_block(block);
+                }
+            }
+        }
+    }
+
+    if (node == NULL) {
+        return 1;
+    }
+
+    allocation->memory = block->memory;
+    allocation->offset = node->offset;
+    allocation->size = size;
+    allocation->mapped = block->mapped != NULL ? (char*)block->mapped + node->offset : NULL;
+    allocation->block = block;
+    allocation->node = node;
+    return 0;
+}
+
+void _fa_vk_memory_init(VkPhysicalDevice physical_device, VkDevice logical_device) {
+    device = logical_device;
+    vkGetPhysicalDeviceMemoryProperties(physical_device, &memory_properties);
+
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(physical_device, &properties);
+    buffer_image_granularity = properties.limits.bufferImageGranularity;
+}
+
+void _fa_vk_memory_teardown() {
+    for (int type_idx = 0; type_idx < VK_MAX_MEMORY_TYPES; type_idx++) {
+        for (int class_idx = 0; class_idx < RESOURCE_CLASSES; class_idx++) {
+            while (blocks[type_idx][class_idx] != NULL) {
+                destroy_block(blocks[type_idx][class_idx]);
+            }
+        }
+    }
+
+    while (node_chunks != NULL) {
+        NodeChunk* next = node_chunks->next;
+        free(node_chunks);
+        node_chunks = next;
+    }
+    spare_nodes = NULL;
+}
+
+int fa_vk_memory_find_type(uint32_t type_bits, VkMemoryPropertyFlags required, VkMemoryPropertyFlags preferred) {
+    VkMemoryPropertyFlags wanted[] = { required | preferred, required };
+    for (int pass_idx = 0; pass_idx < 2; pass_idx++) {
+        for (uint32_t type_idx = 0; type_idx < memory_properties.memoryTypeCount; type_idx++) {
+            if ((type_bits & (1u << type_idx))
+                && (memory_properties.memoryTypes[type_idx].propertyFlags & wanted[pass_idx]) == wanted[pass_idx]) {
+                return type_idx;
+            }
+        }
+    }
+    return -1;
+}
+
+int fa_vk_memory_allocate(const VkMemoryRequirements* requirements, VkMemoryPropertyFlags required,
+                          VkMemoryPropertyFlags preferred, int optimal_image, FA_VkAllocation* allocation) {
+    VkDeviceSize size = align_up(requirements->size, MIN_ALIGNMENT);
+    VkDeviceSize alignment = requirements->alignment > MIN_ALIGNMENT ? requirements->alignment : MIN_ALIGNMENT;
+    int resource_class = optimal_image && buffer_image_granularity > 1;
+
+    pthread_mutex_lock(&memory_lock);
+
+    // Every type which fits, best first, so a full heap falls back to the next one instead of failing
+    int result = 1;
+    uint32_t tried = 0;
+    VkMemoryPropertyFlags wanted[] = { required | preferred, required };
+    for (int pass_idx = 0; pass_idx < 2 && result != 0; pass_idx++) {
+        for (uint32_t type_idx = 0; type_idx < memory_properties.memoryTypeCount && result != 0; type_idx++) {
+            if ((requirements->memoryTypeBits & (1u << type_idx)) == 0 || (tried & (1u << type_idx))
+                || (memory_properties.memoryTypes[type_idx].propertyFlags & wanted[pass_idx]) != wanted[pass_idx]) {
+                continue;
+            }
+            tried |= 1u << type_idx;
+            result = allocate_from_type(type_idx, resource_class, size, alignment, allocation);
+        }
+    }
+
+    pthread_mutex_unlock(&memory_lock);
+    return result;
+}
+
+void fa_vk_memory_free(FA_VkAllocation* allocation) {
+    if (allocation->block == NULL) {
+        return;
+    }
+
+    pthread_mutex_lock(&memory_lock);
+    FA_VkMemoryBlock* block = allocation->block;
+    block_free(block, allocation->node);
+
+    // Keep one empty block around per list, so a resource which comes and goes does not allocate every time
+    if (block->allocation_count == 0
+        && (block->dedicated || block->prev != NULL || block->next != NULL)) {
+        destroy_block(block);
+    }
+    pthread_mutex_unlock(&memory_lock);
+
+    memset(allocation, 0, sizeof(FA_VkAllocation));
+}
+
+int fa_vk_memory_create_buffer(const VkBufferCreateInfo* create_info, VkMemoryPropertyFlags required,
+                               VkMemoryPropertyFlags preferred, VkBuffer* buffer, FA_VkAllocation* allocation) {
+    if (vkCreateBuffer(device, create_info, NULL, buffer) != VK_SUCCESS) {
+        return 1;
+    }
+
+    VkMemoryRequirements requirements;
+    vkGetBufferMemoryRequirements(device, *buffer, &requirements);
+    if (fa_vk_memory_allocate(&requirements, required, preferred, 0, allocation) != 0) {
+        vkDestroyBuffer(device, *buffer, NULL);
+        return 1;
+    }
+
+    if (vkBindBufferMemory(device, *buffer, allocation->memory, allocation->offset) != VK_SUCCESS) {
+        fa_vk_memory_destroy_buffer(*buffer, allocation);
+        return 1;
+    }
+    return 0;
+}
+
+void fa_vk_memory_destroy_buffer(VkBuffer buffer, FA_VkAllocation* allocation) {
+    vkDestroyBuffer(device, buffer, NULL);
+    fa_vk_memory_free(allocation);
+}
+
+int fa_vk_memory_create_image(const VkImageCreateInfo* create_info, VkMemoryPropertyFlags required, VkImage* image,
+                              FA_VkAllocation* allocation) {
+    if (vkCreateImage(device, create_info, NULL, image) != VK_SUCCESS) {
+        return 1;
+    }
+
+    VkMemoryRequirements requirements;
+    vkGetImageMemoryRequirements(device, *image, &requirements);
+    int optimal_image = create_info->tiling == VK_IMAGE_TILING_OPTIMAL;
+    if (fa_vk_memory_allocate(&requirements, required, 0, optimal_image, allocation) != 0) {
+        vkDestroyImage(device, *image, NULL);
+        return 1;
+    }
+
+    if (vkBindImageMemory(device, *image, allocation->memory, allocation->offset) != VK_SUCCESS) {
+        fa_vk_memory_destroy_image(*image, allocation);
+        return 1;
+    }
+    return 0;
+}
+
+void fa_vk_memory_destroy_image(VkImage image, FA_VkAllocation* allocation) {
+    vkDestroyImage(device, image, NULL);
+    fa_vk_memory_free(allocation);
+}
+
+int fa_vk_memory_create_linear_pool(FA_VkLinearPool* pool, VkDeviceSize size, uint32_t type_bits,
+                                    VkMemoryPropertyFlags required) {
+    memset(pool, 0, sizeof(FA_VkLinearPool));
+    int memory_type = fa_vk_memory_find_type(type_bits, required, 0);
+    if (memory_type < 0) {
+        return 1;
+    }
+
+    VkMemoryAllocateInfo alloc_info;
+    memset(&alloc_info, 0, sizeof(alloc_info));
+    alloc_info.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    alloc_info.allocationSize = size;
+    alloc_info.memoryTypeIndex = memory_type;
+    if (vkAllocateMemory(device, &alloc_info, NULL, &pool->memory) != VK_SUCCESS) {
+        return 1;
+    }
+
+    if (memory_properties.memoryTypes[memory_type].propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) {
+        if (vkMapMemory(device, pool->memory, 0, VK_WHOLE_SIZE, 0, &pool->mapped) != VK_SUCCESS) {
+            vkFreeMemory(device, pool->memory, NULL);
+            pool->memory = VK_NULL_HANDLE;
+            return 1;
+        }
+    }
+
+    pool->memory_type = memory_type;
+    pool->size = size;
+    return 0;
+}
+
+void fa_vk_memory_destroy_linear_pool(FA_VkLinearPool* pool) {
+    if (pool->memory == VK_NULL_HANDLE) {
+        return;
+    }
+    if (pool->mapped != NULL) {
+        vkUnmapMemory(device, pool->memory);
+    }
+    vkFreeMemory(device, pool->memory, NULL);
+    memset(pool, 0, sizeof(FA_VkLinearPool));
+}
+
+int fa_vk_memory_linear_allocate(FA_VkLinearPool* pool, const VkMemoryRequirements* requirements,
+                                 FA_VkAllocation* allocation) {
+    if ((requirements->memoryTypeBits & (1u << pool->memory_type)) == 0) {
+        return 1;
+    }
+
+    /*
+     * Linear pools hold buffers and images side by side, so stay a granularity apart. Transient resources are few and
+     * large, the padding does not add up to much.
+     */
+    VkDeviceSize alignment = requirements->alignment > buffer_image_granularity
+        ? requirements->alignment : buffer_image_granularity;
+    VkDeviceSize offset = align_up(pool->used, alignment);
+    if (offset + requirements->size > pool->size) {
+        return 1;
+    }
+    pool->used = offset + requirements->size;
+
+    allocation->memory = pool->memory;
+    allocation->offset = offset;
+    allocation->size = requirements->size;
+    allocation->mapped = pool->mapped != NULL ? (char*)pool->mapped + offset : NULL;
+    allocation->block = NULL;
+    allocation->node = NULL;
+    return 0;
+}
+
+void fa_vk_memory_reset_linear_pool(FA_VkLinearPool* pool) {
+    pool->used = 0;
+}
+
+void fa_vk_memory_stats(int memory_type, FA_VkMemoryStats* stats) {
+    memset(stats, 0, sizeof(FA_VkMemoryStats));
+
+    pthread_mutex_lock(&memory_lock);
+    for (int type_idx = 0; type_idx < VK_MAX_MEMORY_TYPES; type_idx++) {
+        if (memory_type >= 0 && type_idx != memory_type) {
+            continue;
+        }
+        for (int class_idx = 0; class_idx < RESOURCE_CLASSES; class_idx++) {
+            for (FA_VkMemoryBlock* block = blocks[type_idx][class_idx]; block != NULL; block = block->next) {
+                stats->bytes_reserved += block->size;
+                stats->bytes_in_use += block->used;
+                stats->block_count++;
+                stats->allocation_count += block->allocation_count;
+                for (int fl = 0; fl < FL_COUNT; fl++) {
+                    if ((block->fl_map & (1ull << fl)) == 0) {
+                        continue;
+                    }
+                    for (int sl = 0; sl < SL_COUNT; sl++) {
+                        for (FA_VkMemoryNode* node = block->free_lists[fl][sl]; node != NULL; node = node->next_free) {
+                            stats->free_range_count++;
+                            if (node->size > stats->largest_free_range) {
+                                stats->largest_free_range = node->size;
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+    pthread_mutex_unlock(&memory_lock);
+}
\ No newline at end of file
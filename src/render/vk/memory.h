@@ -0,0 +1,157 @@
+/**
+ * @file memory.h
+ * @author ItsHighNoon
+ * @date 10-17-2026
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ * Device memory management. Memory is allocated from the driver in large blocks and split up with a TLSF allocator, so
+ * the number of driver allocations stays far below maxMemoryAllocationCount no matter how many resources there are.
+ *
+ * Buffers and optimally tiled images are kept in separate blocks whenever the device has a bufferImageGranularity
+ * above one, so neighbouring allocations can never alias on the same page.
+ *
+ * Resources which only live for a frame or two can come from a linear pool instead, which allocates by bumping an
+ * offset and frees everything at once.
+ */
+
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+typedef struct FA_VkMemoryBlockStruct FA_VkMemoryBlock;
+typedef struct FA_VkMemoryNodeStruct FA_VkMemoryNode;
+
+typedef struct {
+    VkDeviceMemory memory;
+    VkDeviceSize offset;
+    VkDeviceSize size;
+    // Points at offset if the memory is host visible, NULL otherwise
+    void* mapped;
+
+    FA_VkMemoryBlock* block;
+    FA_VkMemoryNode* node;
+} FA_VkAllocation;
+
+typedef struct {
+    VkDeviceMemory memory;
+    uint32_t memory_type;
+    VkDeviceSize size;
+    VkDeviceSize used;
+    void* mapped;
+} FA_VkLinearPool;
+
+typedef struct {
+    // Memory allocated from the driver
+    VkDeviceSize bytes_reserved;
+    // Memory handed out to resources, including alignment padding
+    VkDeviceSize bytes_in_use;
+    int block_count;
+    int allocation_count;
+    int free_range_count;
+    VkDeviceSize largest_free_range;
+} FA_VkMemoryStats;
+
+void _fa_vk_memory_init(VkPhysicalDevice physical_device, VkDevice device);
+
+void _fa_vk_memory_teardown();
+
+/**
+ * Find a memory type for a resource.
+ * @param type_bits VkMemoryRequirements::memoryTypeBits of the resource.
+ * @param required Properties the memory type must have.
+ * @param preferred Properties the memory type should have if possible, in addition to required.
+ * @return The index of the memory type, or -1 if no memory type has the required properties.
+ */
+int fa_vk_memory_find_type(uint32_t type_bits, VkMemoryPropertyFlags required, VkMemoryPropertyFlags preferred);
+
+/**
+ * Allocate memory for a resource. Thread safe.
+ * @param requirements The memory requirements of the resource.
+ * @param required Properties the memory must have.
+ * @param preferred Properties the memory should have if possible.
+ * @param optimal_image Whether the memory is for an image with VK_IMAGE_TILING_OPTIMAL.
+ * @param allocation Filled in with the allocation.
+ * @return 0 on success, 1 if there is not enough memory.
+ */
+int fa_vk_memory_allocate(const VkMemoryRequirements* requirements, VkMemoryPropertyFlags required,
+                          VkMemoryPropertyFlags preferred, int optimal_image, FA_VkAllocation* allocation);
+
+/**
+ * Free memory allocated by fa_vk_memory_allocate. Thread safe.
+ * @param allocation The allocation to free.
+ */
+void fa_vk_memory_free(FA_VkAllocation* allocation);
+
+/**
+ * Create a buffer and bind memory to it.
+ * @param create_info How to create the buffer.
+ * @param required Properties the memory must have.
+ * @param preferred Properties the memory should have if possible.
+ * @param buffer Set to the buffer.
+ * @param allocation Filled in with the memory of the buffer.
+ * @return 0 on success, 1 on failure.
+ */
+int fa_vk_memory_create_buffer(const VkBufferCreateInfo* create_info, VkMemoryPropertyFlags required,
+                               VkMemoryPropertyFlags preferred, VkBuffer* buffer, FA_VkAllocation* allocation);
+
+/**
+ * Destroy a buffer created by fa_vk_memory_create_buffer and free its memory.
+ * @param buffer The buffer.
+ * @param allocation The memory of the buffer.
+ */
+void fa_vk_memory_destroy_buffer(VkBuffer buffer, FA_VkAllocation* allocation);
+
+/**
+ * Create an image and bind memory to it.
+ * @param create_info How to create the image.
+ * @param required Properties the memory must have.
+ * @param image Set to the image.
+ * @param allocation Filled in with the memory of the image.
+ * @return 0 on success, 1 on failure.
+ */
+int fa_vk_memory_create_image(const VkImageCreateInfo* create_info, VkMemoryPropertyFlags required, VkImage* image,
+                              FA_VkAllocation* allocation);
+
+/**
+ * Destroy an image created by fa_vk_memory_create_image and free its memory.
+ * @param image The image.
+ * @param allocation The memory of the image.
+ */
+void fa_vk_memory_destroy_image(VkImage image, FA_VkAllocation* allocation);
+
+/**
+ * Create a linear pool for transient resources. Not thread safe, each pool belongs to one user.
+ * @param pool The pool to create.
+ * @param size The size of the pool in bytes.
+ * @param type_bits Memory types the resources in the pool can use.
+ * @param required Properties the memory must have.
+ * @return 0 on success, 1 if there is not enough memory.
+ */
+int fa_vk_memory_create_linear_pool(FA_VkLinearPool* pool, VkDeviceSize size, uint32_t type_bits,
+                                    VkMemoryPropertyFlags required);
+
+void fa_vk_memory_destroy_linear_pool(FA_VkLinearPool* pool);
+
+/**
+ * Allocate memory from a linear pool.
+ * @param pool The pool to allocate from.
+ * @param requirements The memory requirements of the resource.
+ * @param allocation Filled in with the allocation. Freed by resetting the pool, never by fa_vk_memory_free.
+ * @return 0 on success, 1 if the pool is full or has the wrong memory type.
+ */
+int fa_vk_memory_linear_allocate(FA_VkLinearPool* pool, const VkMemoryRequirements* requirements,
+                                 FA_VkAllocation* allocation);
+
+/**
+ * Free everything allocated from a linear pool. The GPU must be done with all of it.
+ * @param pool The pool to reset.
+ */
+void fa_vk_memory_reset_linear_pool(FA_VkLinearPool* pool);
+
+/**
+ * Get statistics about allocated memory.
+ * @param memory_type The memory type to get statistics of, or -1 for all memory types combined.
+ * @param stats Filled in with the statistics.
+ */
+void fa_vk_memory_stats(int memory_type, FA_VkMemoryStats* stats);
\ No newline at end of file
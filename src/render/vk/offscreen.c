@@ -0,0 +1,173 @@
+/**
+ * @file offscreen.c
+ * @author ItsHighNoon
+ * @date 10-17-2026
+ * 
+ * @copyright Copyright (c) 2026
+ */
+
+#include "offscreen.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "os/file.h"
+#include "render/vk/memory.h"
+
+static VkDevice device;
+static VkFormat image_format;
+static VkExtent2D image_extent;
+static VkImage* images;
+static FA_VkAllocation* allocations;
+static int images_len;
+
+void _fa_vk_offscreen_create(VkDevice logical_device, VkFormat format, VkExtent2D extent, int count, VkImage* out_images) {
+    device = logical_device;
+    image_format = format;
+    image_extent = extent;
+    images_len = count;
+    images = malloc(count * sizeof(VkImage));
+    allocations = malloc(count * sizeof(FA_VkAllocation));
+
+    VkImageCreateInfo create_info;
+    memset(&create_info, 0, sizeof(create_info));
+    create_info.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    create_info.imageType = VK_IMAGE_TYPE_2D;
+    create_info.format = format;
+    create_info.extent.width = extent.width;
+    create_info.extent.height = extent.height;
+    create_info.extent.depth = 1;
+    create_info.mipLevels = 1;
+    create_info.arrayLayers = 1;
+    create_info.samples = VK_SAMPLE_COUNT_1_BIT;
+    create_info.tiling = VK_IMAGE_TILING_OPTIMAL;
+    create_info.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+    create_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    create_info.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+    for (int image_idx = 0; image_idx < count; image_idx++) {
+        if (fa_vk_memory_create_image(&create_info, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, &images[image_idx],
+                                      &allocations[image_idx]) != 0) {
+            printf("Failed to create offscreen image %d :(\n", image_idx);
+            exit(1);
+        }
+        out_images[image_idx] = images[image_idx];
+    }
+}
+
+void _fa_vk_offscreen_destroy() {
+    for (int image_idx = 0; image_idx < images_len; image_idx++) {
+        fa_vk_memory_destroy_image(images[image_idx], &allocations[image_idx]);
+    }
+    free(images);
+    free(allocations);
+    images = NULL;
+    allocations = NULL;
+    images_len = 0;
+}
+
+int _fa_vk_offscreen_readback(VkQueue queue, VkCommandPool command_pool, int image, const char* path) {
+    VkDeviceSize size = (VkDeviceSize)image_extent.width * image_extent.height * 4;
+
+    VkBufferCreateInfo buffer_info;
+    memset(&buffer_info, 0, sizeof(buffer_info));
+    buffer_info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    buffer_info.size = size;
+    buffer_info.usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+    buffer_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    VkBuffer buffer;
+    FA_VkAllocation allocation;
+    if (fa_vk_memory_create_buffer(&buffer_info, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT
+                                   | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, VK_MEMORY_PROPERTY_HOST_CACHED_BIT, &buffer,
+                                   &allocation) != 0) {
+        printf("Failed to create readback buffer :(\n");
+        return 1;
+    }
+
+    VkCommandBufferAllocateInfo alloc_info;
+    memset(&alloc_info, 0, sizeof(alloc_info));
+    alloc_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+    alloc_info.commandPool = command_pool;
+    alloc_info.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    alloc_info.commandBufferCount = 1;
+    VkCommandBuffer command_buffer;
+    vkAllocateCommandBuffers(device, &alloc_info, &command_buffer);
+
+    VkCommandBufferBeginInfo begin_info;
+    memset(&begin_info, 0, sizeof(begin_info));
+    begin_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    begin_info.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    vkBeginCommandBuffer(command_buffer, &begin_info);
+
+    // The render pass left the image in the right layout, but its writes still have to be made visible to the copy
+    VkImageMemoryBarrier image_barrier;
+    memset(&image_barrier, 0, sizeof(image_barrier));
+    image_barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    image_barrier.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+    image_barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+    image_barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+    image_barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+    image_barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    image_barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    image_barrier.image = images[image];
+    image_barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    image_barrier.subresourceRange.levelCount = 1;
+    image_barrier.subresourceRange.layerCount = 1;
+    vkCmdPipelineBarrier(command_buffer, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                         0, 0, NULL, 0, NULL, 1, &image_barrier);
+
+    VkBufferImageCopy region;
+    memset(&region, 0, sizeof(region));
+    region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    region.imageSubresource.layerCount = 1;
+    region.imageExtent.width = image_extent.width;
+    region.imageExtent.height = image_extent.height;
+    region.imageExtent.depth = 1;
+    vkCmdCopyImageToBuffer(command_buffer, images[image], VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, buffer, 1, &region);
+
+    VkBufferMemoryBarrier buffer_barrier;
+    memset(&buffer_barrier, 0, sizeof(buffer_barrier));
+    buffer_barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+    buffer_barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    buffer_barrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+    buffer_barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    buffer_barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    buffer_barrier.buffer = buffer;
+    buffer_barrier.size = VK_WHOLE_SIZE;
+    vkCmdPipelineBarrier(command_buffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT, 0, 0, NULL, 1,
+                         &buffer_barrier, 0, NULL);
+    vkEndCommandBuffer(command_buffer);
+
+    VkSubmitInfo submit_info;
+    memset(&submit_info, 0, sizeof(submit_info));
+    submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submit_info.commandBufferCount = 1;
+    submit_info.pCommandBuffers = &command_buffer;
+    vkQueueSubmit(queue, 1, &submit_info, VK_NULL_HANDLE);
+    vkQueueWaitIdle(queue);
+    vkFreeCommandBuffers(device, command_pool, 1, &command_buffer);
+
+    // PPM wants RGB without alpha
+    int swizzle = image_format == VK_FORMAT_B8G8R8A8_SRGB || image_format == VK_FORMAT_B8G8R8A8_UNORM;
+    char header[64];
+    int header_len = snprintf(header, sizeof(header), "P6\n%u %u\n255\n", image_extent.width, image_extent.height);
+    size_t file_size = header_len + (size_t)image_extent.width * image_extent.height * 3;
+    unsigned char* file = malloc(file_size);
+    memcpy(file, header, header_len);
+    const unsigned char* pixels = allocation.mapped;
+    unsigned char* out = file + header_len;
+    for (size_t pixel_idx = 0; pixel_idx < (size_t)image_extent.width * image_extent.height; pixel_idx++) {
+        out[pixel_idx * 3 + 0] = pixels[pixel_idx * 4 + (swizzle ? 2 : 0)];
+        out[pixel_idx * 3 + 1] = pixels[pixel_idx * 4 + 1];
+        out[pixel_idx * 3 + 2] = pixels[pixel_idx * 4 + (swizzle ? 0 : 2)];
+    }
+
+    int result = _fa_os_write_file_atomic(path, file, file_size);
+    if (result != 0) {
+        printf("Failed to write %s :(\n", path);
+    }
+    free(file);
+    fa_vk_memory_destroy_buffer(buffer, &allocation);
+    return result;
+}
\ No newline at end of file
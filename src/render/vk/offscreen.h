@@ -0,0 +1,37 @@
+/**
+ * @file offscreen.h
+ * @author ItsHighNoon
+ * @date 10-17-2026
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ * Images which stand in for the swapchain in headless mode, and reading them back to disk so frames can be compared
+ * against reference images.
+ */
+
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+/**
+ * Create images to render to. They can be used as color attachments and copied from.
+ * @param count The number of images to create.
+ * @param images Filled in with count images.
+ */
+void _fa_vk_offscreen_create(VkDevice logical_device, VkFormat format, VkExtent2D extent, int count, VkImage* images);
+
+/**
+ * Destroy the images from _fa_vk_offscreen_create.
+ */
+void _fa_vk_offscreen_destroy();
+
+/**
+ * Copy an image to the host and write it as a binary PPM. Waits for the queue to go idle. The image has to be in
+ * VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, written by color attachment writes, and in a 4 byte BGRA or RGBA format.
+ * @param queue A queue of the family command_pool belongs to.
+ * @param command_pool A command pool to allocate a temporary command buffer from.
+ * @param image The index of the image to read.
+ * @param path Where to write the image.
+ * @return 0 on success, nonzero if the file could not be written.
+ */
+int _fa_vk_offscreen_readback(VkQueue queue, VkCommandPool command_pool, int image, const char* path);
\ No newline at end of file
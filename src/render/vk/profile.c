@@ -0,0 +1,217 @@
+/**
+ * @file profile.c
+ * @author ItsHighNoon
+ * @date 10-17-2026
+ * 
+ * @copyright Copyright (c) 2026
+ */
+
+#include "profile.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "util/arena.h"
+#include "util/profile.h"
+#include "util/util.h"
+
+#define MAX_FRAMES 8
+#define MAX_ZONES 64
+#define MAX_DEPTH 16
+
+/*
+ * The zones of one frame slot. Zone i uses query 2i for its start and 2i + 1 for its end, in the range of queries
+ * belonging to the slot.
+ */
+struct FrameZones {
+    const char* names[MAX_ZONES];
+    int zones_len;
+    double submit_time;
+    int submitted;
+};
+
+static VkDevice device;
+static VkQueryPool query_pool;
+static int enabled;
+static int frame_count;
+static int current_frame;
+static struct FrameZones frame_zones[MAX_FRAMES];
+static int open_zones[MAX_DEPTH];
+static int depth;
+
+// Nanoseconds per tick
+static double timestamp_period;
+static uint64_t timestamp_mask;
+static PFN_vkGetCalibratedTimestampsEXT get_calibrated_timestamps;
+
+int _fa_vk_profile_calibration_supported(VkInstance instance, VkPhysicalDevice physical_device) {
+    uint32_t extension_count = 0;
+    vkEnumerateDeviceExtensionProperties(physical_device, NULL, &extension_count, NULL);
+    FA_ArenaScope scratch = fa_arena_scratch_begin();
+    VkExtensionProperties* extensions = fa_arena_push(scratch.arena, extension_count * sizeof(VkExtensionProperties));
+    vkEnumerateDeviceExtensionProperties(physical_device, NULL, &extension_count, extensions);
+    int found = 0;
+    for (int extension_idx = 0; extension_idx < extension_count; extension_idx++) {
+        found = found || strcmp(extensions[extension_idx].extensionName,
+                                VK_EXT_CALIBRATED_TIMESTAMPS_EXTENSION_NAME) == 0;
+    }
+    fa_arena_scratch_end(scratch);
+    if (found == 0) {
+        return 0;
+    }
+
+    // Both clocks have to be readable together, fa_util_time uses CLOCK_MONOTONIC
+    PFN_vkGetPhysicalDeviceCalibrateableTimeDomainsEXT get_time_domains =
+        (PFN_vkGetPhysicalDeviceCalibrateableTimeDomainsEXT)vkGetInstanceProcAddr(
+            instance, "vkGetPhysicalDeviceCalibrateableTimeDomainsEXT");
+    if (get_time_domains == NULL) {
+        return 0;
+    }
+    VkTimeDomainEXT domains[8];
+    uint32_t domain_count = 8;
+    get_time_domains(physical_device, &domain_count, domains);
+    int found_device = 0;
+    int found_monotonic = 0;
+    for (int domain_idx = 0; domain_idx < domain_count; domain_idx++) {
+        found_device = found_device || domains[domain_idx] == VK_TIME_DOMAIN_DEVICE_EXT;
+        found_monotonic = found_monotonic || domains[domain_idx] == VK_TIME_DOMAIN_CLOCK_MONOTONIC_EXT;
+    }
+    return found_device && found_monotonic;
+}
+
+void _fa_vk_profile_init(VkPhysicalDevice physical_device, VkDevice logical_device, uint32_t queue_family, int frames,
+                         int calibrated) {
+    device = logical_device;
+    frame_count = frames < MAX_FRAMES ? frames : MAX_FRAMES;
+    memset(frame_zones, 0, sizeof(frame_zones));
+    depth = 0;
+
+    uint32_t family_count = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(physical_device, &family_count, NULL);
+    FA_ArenaScope scratch = fa_arena_scratch_begin();
+    VkQueueFamilyProperties* families = fa_arena_push(scratch.arena, family_count * sizeof(VkQueueFamilyProperties));
+    vkGetPhysicalDeviceQueueFamilyProperties(physical_device, &family_count, families);
+    uint32_t valid_bits = families[queue_family].timestampValidBits;
+    fa_arena_scratch_end(scratch);
+
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(physical_device, &properties);
+    timestamp_period = properties.limits.timestampPeriod;
+
+    enabled = valid_bits > 0 && timestamp_period > 0.0;
+    if (enabled == 0) {
+        printf("GPU timestamps are not supported, GPU zones will be empty\n");
+        return;
+    }
+    timestamp_mask = valid_bits >= 64 ? UINT64_MAX : (1ull << valid_bits) - 1;
+
+    get_calibrated_timestamps = NULL;
+    if (calibrated) {
+        get_calibrated_timestamps = (PFN_vkGetCalibratedTimestampsEXT)vkGetDeviceProcAddr(
+            device, "vkGetCalibratedTimestampsEXT");
+    }
+
+    VkQueryPoolCreateInfo pool_info;
+    memset(&pool_info, 0, sizeof(pool_info));
+    pool_info.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+    pool_info.queryType = VK_QUERY_TYPE_TIMESTAMP;
+    pool_info.queryCount = frame_count * MAX_ZONES * 2;
+    if (vkCreateQueryPool(device, &pool_info, NULL, &query_pool) != VK_SUCCESS) {
+        printf("Failed to create timestamp query pool :(\n");
+        exit(1);
+    }
+}
+
+void _fa_vk_profile_teardown() {
+    if (enabled) {
+        vkDestroyQueryPool(device, query_pool, NULL);
+    }
+}
+
+// Seconds on the CPU clock at GPU tick zero
+static double calibrate(struct FrameZones* zones, uint64_t first_tick) {
+    if (get_calibrated_timestamps != NULL) {
+        VkCalibratedTimestampInfoEXT infos[2];
+        memset(infos, 0, sizeof(infos));
+        infos[0].sType = VK_STRUCTURE_TYPE_CALIBRATED_TIMESTAMP_INFO_EXT;
+        infos[0].timeDomain = VK_TIME_DOMAIN_DEVICE_EXT;
+        infos[1].sType = VK_STRUCTURE_TYPE_CALIBRATED_TIMESTAMP_INFO_EXT;
+        infos[1].timeDomain = VK_TIME_DOMAIN_CLOCK_MONOTONIC_EXT;
+        uint64_t timestamps[2];
+        uint64_t max_deviation;
+        if (get_calibrated_timestamps(device, 2, infos, timestamps, &max_deviation) == VK_SUCCESS) {
+            return timestamps[1] * 1e-9 - (timestamps[0] & timestamp_mask) * timestamp_period * 1e-9;
+        }
+    }
+
+    return zones->submit_time - first_tick * timestamp_period * 1e-9;
+}
+
+void _fa_vk_profile_begin_frame(VkCommandBuffer command_buffer, int frame) {
+    if (enabled == 0) {
+        return;
+    }
+    current_frame = frame;
+    depth = 0;
+
+    struct FrameZones* zones = &frame_zones[frame];
+    uint32_t first_query = frame * MAX_ZONES * 2;
+    if (zones->submitted && zones->zones_len > 0) {
+        uint64_t ticks[MAX_ZONES * 2];
+        // The slot's fence was waited on, so the results are there without VK_QUERY_RESULT_WAIT_BIT
+        if (vkGetQueryPoolResults(device, query_pool, first_query, zones->zones_len * 2, sizeof(ticks), ticks,
+                                  sizeof(uint64_t), VK_QUERY_RESULT_64_BIT) == VK_SUCCESS) {
+            double offset = calibrate(zones, ticks[0] & timestamp_mask);
+            for (int zone_idx = 0; zone_idx < zones->zones_len; zone_idx++) {
+                double start = (ticks[zone_idx * 2] & timestamp_mask) * timestamp_period * 1e-9 + offset;
+                double end = (ticks[zone_idx * 2 + 1] & timestamp_mask) * timestamp_period * 1e-9 + offset;
+                _fa_profile_add_gpu_zone(zones->names[zone_idx], start, end);
+            }
+        }
+    }
+
+    zones->zones_len = 0;
+    zones->submitted = 0;
+    vkCmdResetQueryPool(command_buffer, query_pool, first_query, MAX_ZONES * 2);
+}
+
+void _fa_vk_profile_submit() {
+    if (enabled == 0) {
+        return;
+    }
+    frame_zones[current_frame].submit_time = fa_util_time();
+    frame_zones[current_frame].submitted = 1;
+}
+
+void fa_vk_profile_begin(VkCommandBuffer command_buffer, const char* name) {
+    if (enabled == 0) {
+        return;
+    }
+
+    // Zones past the limits are not recorded, but still count towards the depth so begin and end stay balanced
+    struct FrameZones* zones = &frame_zones[current_frame];
+    int zone = -1;
+    if (depth < MAX_DEPTH && zones->zones_len < MAX_ZONES) {
+        zone = zones->zones_len++;
+        zones->names[zone] = name;
+        vkCmdWriteTimestamp(command_buffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, query_pool,
+                            current_frame * MAX_ZONES * 2 + zone * 2);
+    }
+    if (depth < MAX_DEPTH) {
+        open_zones[depth] = zone;
+    }
+    depth++;
+}
+
+void fa_vk_profile_end(VkCommandBuffer command_buffer) {
+    if (enabled == 0) {
+        return;
+    }
+
+    depth--;
+    if (depth < MAX_DEPTH && open_zones[depth] >= 0) {
+        vkCmdWriteTimestamp(command_buffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, query_pool,
+                            current_frame * MAX_ZONES * 2 + open_zones[depth] * 2 + 1);
+    }
+}
\ No newline at end of file
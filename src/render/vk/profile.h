@@ -0,0 +1,57 @@
+/**
+ * @file profile.h
+ * @author ItsHighNoon
+ * @date 10-17-2026
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ * GPU zones, timed with timestamp queries written into each frame's command buffer. Results are read back once the
+ * frame slot comes around again, converted to CPU time and handed to util/profile.h, so they show up in the same
+ * statistics and traces as CPU zones.
+ *
+ * Converting needs VK_EXT_calibrated_timestamps with the CLOCK_MONOTONIC time domain. Without it the start of the GPU
+ * frame is assumed to line up with its submission, so durations are right but GPU zones may be drawn early.
+ */
+
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+/**
+ * Check whether GPU timestamps can be calibrated against fa_util_time.
+ * @return Nonzero if VK_EXT_calibrated_timestamps should be enabled on the device.
+ */
+int _fa_vk_profile_calibration_supported(VkInstance instance, VkPhysicalDevice physical_device);
+
+/**
+ * @param queue_family The queue family the profiled command buffers run on.
+ * @param frames The number of frames in flight.
+ * @param calibrated Whether VK_EXT_calibrated_timestamps was enabled.
+ */
+void _fa_vk_profile_init(VkPhysicalDevice physical_device, VkDevice device, uint32_t queue_family, int frames,
+                         int calibrated);
+
+void _fa_vk_profile_teardown();
+
+/**
+ * Read back the zones the frame slot recorded last time and reset its queries. Call right after beginning the frame's
+ * command buffer, outside any render pass, once the GPU has finished the slot.
+ * @param frame The index of the frame in flight.
+ */
+void _fa_vk_profile_begin_frame(VkCommandBuffer command_buffer, int frame);
+
+/**
+ * Call right before submitting the frame's command buffer.
+ */
+void _fa_vk_profile_submit();
+
+/**
+ * Start a GPU zone. Only on the main thread, in the frame's primary command buffer.
+ * @param name The name of the zone, see fa_profile_begin.
+ */
+void fa_vk_profile_begin(VkCommandBuffer command_buffer, const char* name);
+
+/**
+ * End the innermost GPU zone.
+ */
+void fa_vk_profile_end(VkCommandBuffer command_buffer);
\ No newline at end of file
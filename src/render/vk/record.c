@@ -0,0 +1,189 @@
+/**
+ * @file record.c
+ * @author ItsHighNoon
+ * @date 10-17-2026
+ * 
+ * @copyright Copyright (c) 2026
+ */
+
+#include "record.h"
+
+#include <stdalign.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "util/arena.h"
+#include "util/jobs.h"
+#include "util/profile.h"
+
+#define CACHE_LINE 64
+// Fewer items than this are not worth a command buffer of their own
+#define MIN_CHUNK_ITEMS 512
+// More chunks than threads, so a thread which got a slow chunk does not hold up the rest
+#define CHUNKS_PER_THREAD 4
+
+/*
+ * The command pool of one thread for one frame, and the secondary command buffers allocated from it. Buffers are
+ * handed out again after the pool is reset instead of being freed.
+ */
+typedef struct {
+    alignas(CACHE_LINE) VkCommandPool command_pool;
+    VkCommandBuffer* command_buffers;
+    int command_buffers_len;
+    int command_buffers_used;
+} ThreadPool;
+
+struct RecordContext {
+    const VkCommandBufferInheritanceInfo* inheritance;
+    FA_VkRecordFunction function;
+    void* data;
+};
+
+struct RecordChunk {
+    struct RecordContext* context;
+    int first;
+    int count;
+    VkCommandBuffer command_buffer;
+};
+
+static VkDevice device;
+static int thread_count;
+static int frame_count;
+static int current_frame;
+static ThreadPool* pools;
+
+static VkCommandBuffer take_command_buffer(ThreadPool* pool) {
+    if (pool->command_buffers_used == pool->command_buffers_len) {
+        int new_len = pool->command_buffers_len > 0 ? pool->command_buffers_len * 2 : CHUNKS_PER_THREAD;
+        pool->command_buffers = realloc(pool->command_buffers, new_len * sizeof(VkCommandBuffer));
+
+        VkCommandBufferAllocateInfo alloc_info;
+        memset(&alloc_info, 0, sizeof(alloc_info));
+        alloc_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        alloc_info.commandPool = pool->command_pool;
+        alloc_info.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+        alloc_info.commandBufferCount = new_len - pool->command_buffers_len;
+        if (vkAllocateCommandBuffers(device, &alloc_info, &pool->command_buffers[pool->command_buffers_len])
+            != VK_SUCCESS) {
+            printf("Failed to allocate secondary command buffers :(\n");
+            exit(1);
+        }
+        pool->command_buffers_len = new_len;
+    }
+
+    return pool->command_buffers[pool->command_buffers_used++];
+}
+
+static void record_chunk(void* data) {
+    struct RecordChunk* chunk = data;
+    fa_profile_begin("Record chunk");
+    ThreadPool* pool = &pools[current_frame * thread_count + fa_jobs_thread_index()];
+    chunk->command_buffer = take_command_buffer(pool);
+
+    VkCommandBufferBeginInfo begin_info;
+    memset(&begin_info, 0, sizeof(begin_info));
+    begin_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    begin_info.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT | VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
+    begin_info.pInheritanceInfo = chunk->context->inheritance;
+    if (vkBeginCommandBuffer(chunk->command_buffer, &begin_info) != VK_SUCCESS) {
+        printf("Failed to begin secondary command buffer :(\n");
+        exit(1);
+    }
+
+    chunk->context->function(chunk->command_buffer, chunk->first, chunk->count, chunk->context->data);
+
+    if (vkEndCommandBuffer(chunk->command_buffer) != VK_SUCCESS) {
+        printf("Failed to record secondary command buffer :(\n");
+        exit(1);
+    }
+    fa_profile_end();
+}
+
+void _fa_vk_record_init(VkDevice logical_device, uint32_t queue_family, int frames) {
+    device = logical_device;
+    thread_count = fa_jobs_thread_count();
+    frame_count = frames;
+    current_frame = 0;
+
+    pools = aligned_alloc(alignof(ThreadPool), frame_count * thread_count * sizeof(ThreadPool));
+    for (int pool_idx = 0; pool_idx < frame_count * thread_count; pool_idx++) {
+        memset(&pools[pool_idx], 0, sizeof(ThreadPool));
+
+        VkCommandPoolCreateInfo pool_info;
+        memset(&pool_info, 0, sizeof(pool_info));
+        pool_info.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+        pool_info.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+        pool_info.queueFamilyIndex = queue_family;
+        if (vkCreateCommandPool(device, &pool_info, NULL, &pools[pool_idx].command_pool) != VK_SUCCESS) {
+            printf("Failed to create recording command pool :(\n");
+            exit(1);
+        }
+    }
+}
+
+void _fa_vk_record_teardown() {
+    for (int pool_idx = 0; pool_idx < frame_count * thread_count; pool_idx++) {
+        // Frees the command buffers too
+        vkDestroyCommandPool(device, pools[pool_idx].command_pool, NULL);
+        free(pools[pool_idx].command_buffers);
+    }
+    free(pools);
+    pools = NULL;
+}
+
+void _fa_vk_record_begin_frame(int frame) {
+    current_frame = frame;
+    for (int thread_idx = 0; thread_idx < thread_count; thread_idx++) {
+        ThreadPool* pool = &pools[frame * thread_count + thread_idx];
+        if (pool->command_buffers_used > 0) {
+            vkResetCommandPool(device, pool->command_pool, 0);
+            pool->command_buffers_used = 0;
+        }
+    }
+}
+
+void fa_vk_record_parallel(VkCommandBuffer primary, const VkCommandBufferInheritanceInfo* inheritance, int item_count,
+                           FA_VkRecordFunction function, void* data) {
+    int chunk_count = (item_count + MIN_CHUNK_ITEMS - 1) / MIN_CHUNK_ITEMS;
+    if (chunk_count > thread_count * CHUNKS_PER_THREAD) {
+        chunk_count = thread_count * CHUNKS_PER_THREAD;
+    }
+    if (chunk_count < 1) {
+        chunk_count = 1;
+    }
+
+    struct RecordContext context;
+    context.inheritance = inheritance;
+    context.function = function;
+    context.data = data;
+
+    FA_ArenaScope scratch = fa_arena_scratch_begin();
+    struct RecordChunk* chunks = fa_arena_push(scratch.arena, chunk_count * sizeof(struct RecordChunk));
+    VkCommandBuffer* command_buffers = fa_arena_push(scratch.arena, chunk_count * sizeof(VkCommandBuffer));
+
+    FA_JobCounter counter = {0};
+    int first = 0;
+    for (int chunk_idx = 0; chunk_idx < chunk_count; chunk_idx++) {
+        // Spread the remainder over the first chunks
+        int count = item_count / chunk_count + (chunk_idx < item_count % chunk_count ? 1 : 0);
+        chunks[chunk_idx].context = &context;
+        chunks[chunk_idx].first = first;
+        chunks[chunk_idx].count = count;
+        first += count;
+
+        if (chunk_idx == chunk_count - 1) {
+            // The last chunk is recorded here, there would be nothing to do but wait otherwise
+            record_chunk(&chunks[chunk_idx]);
+        } else {
+            fa_jobs_run(record_chunk, &chunks[chunk_idx], &counter);
+        }
+    }
+    fa_jobs_wait(&counter);
+
+    for (int chunk_idx = 0; chunk_idx < chunk_count; chunk_idx++) {
+        command_buffers[chunk_idx] = chunks[chunk_idx].command_buffer;
+    }
+    vkCmdExecuteCommands(primary, chunk_count, command_buffers);
+    fa_arena_scratch_end(scratch);
+}
\ No newline at end of file
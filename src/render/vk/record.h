@@ -0,0 +1,66 @@
+/**
+ * @file record.h
+ * @author ItsHighNoon
+ * @date 10-17-2026
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ * Command recording spread over the job system. A range of items, usually draws, is split into chunks which are
+ * recorded into secondary command buffers on whichever threads pick them up, then executed from the primary command
+ * buffer in their original order. Every thread records into command pools of its own, one set per frame in flight, so
+ * recording never takes a lock.
+ *
+ * Secondary command buffers inherit no state, so the record function binds the pipeline, viewport and everything else
+ * its chunk needs before drawing:
+ *
+ *     static void record_meshes(VkCommandBuffer command_buffer, int first, int count, void* data) {
+ *         vkCmdBindPipeline(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+ *         for (int mesh_idx = first; mesh_idx < first + count; mesh_idx++) {
+ *             // Draw mesh mesh_idx
+ *         }
+ *     }
+ *
+ *     vkCmdBeginRenderPass(command_buffer, &render_pass_info, VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
+ *     fa_vk_record_parallel(command_buffer, &inheritance, mesh_count, record_meshes, meshes);
+ *     vkCmdEndRenderPass(command_buffer);
+ */
+
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+/**
+ * Records part of the items into a secondary command buffer.
+ * @param command_buffer The secondary command buffer to record into, already begun.
+ * @param first The first item of the chunk.
+ * @param count The number of items in the chunk.
+ * @param data The data passed to fa_vk_record_parallel.
+ */
+typedef void (*FA_VkRecordFunction)(VkCommandBuffer command_buffer, int first, int count, void* data);
+
+/**
+ * Create command pools for every job thread. Call after _fa_jobs_init.
+ * @param queue_family The queue family the primary command buffers are submitted to.
+ * @param frames The number of frames in flight, each gets its own pools.
+ */
+void _fa_vk_record_init(VkDevice device, uint32_t queue_family, int frames);
+
+void _fa_vk_record_teardown();
+
+/**
+ * Reset the command pools of a frame. Only once the GPU has finished the last frame which used them.
+ * @param frame The index of the frame in flight.
+ */
+void _fa_vk_record_begin_frame(int frame);
+
+/**
+ * Record items across all job threads and execute the result from a primary command buffer. Waits until everything
+ * is recorded, running jobs in the meantime. Call from the main thread or a job.
+ * @param primary The primary command buffer, inside a render pass begun with secondary command buffer contents.
+ * @param inheritance The render pass, subpass and framebuffer the secondary command buffers continue.
+ * @param item_count The number of items to record.
+ * @param function Called once per chunk, on any job thread.
+ * @param data Passed to function.
+ */
+void fa_vk_record_parallel(VkCommandBuffer primary, const VkCommandBufferInheritanceInfo* inheritance, int item_count,
+                           FA_VkRecordFunction function, void* data);
\ No newline at end of file
@@ -0,0 +1,68 @@
+/**
+ * @file shaders.c
+ * @author ItsHighNoon
+ * @date 10-17-2026
+ * 
+ * @copyright Copyright (c) 2026
+ */
+
+#include "shaders.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+const FA_ShaderCode* _fa_vk_shader_find(const char* name) {
+    // Only a handful of shaders, and each is looked up once when its pipeline is created
+    for (int shader_idx = 0; shader_idx < _fa_vk_shaders_len; shader_idx++) {
+        if (strcmp(_fa_vk_shaders[shader_idx].name, name) == 0) {
+            return &_fa_vk_shaders[shader_idx];
+        }
+    }
+    return NULL;
+}
+
+VkShaderModule _fa_vk_shader_create_module(VkDevice device, const char* name) {
+    const FA_ShaderCode* shader = _fa_vk_shader_find(name);
+    if (shader == NULL) {
+        printf("No shader named %s :(\n", name);
+        exit(1);
+    }
+
+    VkShaderModuleCreateInfo create_info;
+    memset(&create_info, 0, sizeof(create_info));
+    create_info.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+    create_info.codeSize = shader->code_size;
+    create_info.pCode = shader->code;
+
+    VkShaderModule shader_module;
+    if (vkCreateShaderModule(device, &create_info, NULL, &shader_module) != VK_SUCCESS) {
+        printf("Failed to create shader module %s :(\n", name);
+        exit(1);
+    }
+
+    return shader_module;
+}
+
+VkPipeline _fa_vk_shader_create_compute_pipeline(VkDevice device, VkPipelineCache pipeline_cache, const char* name,
+                                                 VkPipelineLayout layout) {
+    VkShaderModule module = _fa_vk_shader_create_module(device, name);
+
+    VkComputePipelineCreateInfo create_info;
+    memset(&create_info, 0, sizeof(create_info));
+    create_info.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+    create_info.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    create_info.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+    create_info.stage.module = module;
+    create_info.stage.pName = "main";
+    create_info.layout = layout;
+
+    VkPipeline pipeline;
+    if (vkCreateComputePipelines(device, pipeline_cache, 1, &create_info, NULL, &pipeline) != VK_SUCCESS) {
+        printf("Failed to create compute pipeline %s :(\n", name);
+        exit(1);
+    }
+
+    vkDestroyShaderModule(device, module, NULL);
+    return pipeline;
+}
\ No newline at end of file
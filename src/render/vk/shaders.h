@@ -0,0 +1,50 @@
+/**
+ * @file shaders.h
+ * @author ItsHighNoon
+ * @date 10-17-2026
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ * Shaders compiled to SPIR-V at build time and linked into the executable by fa_embed. A shader is looked up by its
+ * source file name, for example "default.vert".
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vulkan/vulkan.h>
+
+typedef struct {
+    const char* name;
+    const uint32_t* code;
+    size_t code_size;
+} FA_ShaderCode;
+
+// Generated, see tools/embed.c
+extern const FA_ShaderCode _fa_vk_shaders[];
+extern const int _fa_vk_shaders_len;
+
+/**
+ * Find a built in shader.
+ * @param name The file name of the shader source. Assumed to be null terminated.
+ * @return The SPIR-V of the shader, or NULL if there is no such shader.
+ */
+const FA_ShaderCode* _fa_vk_shader_find(const char* name);
+
+/**
+ * Create a shader module from a built in shader. Exits if there is no such shader.
+ * @param name The file name of the shader source.
+ * @return The module, to be destroyed once every pipeline using it is created.
+ */
+VkShaderModule _fa_vk_shader_create_module(VkDevice device, const char* name);
+
+/**
+ * Create a compute pipeline from a built in shader. Exits on failure.
+ * @param pipeline_cache The cache to create it through, or VK_NULL_HANDLE.
+ * @param name The file name of the compute shader source, for example "cull.comp".
+ * @param layout The layout of the pipeline.
+ * @return The pipeline.
+ */
+VkPipeline _fa_vk_shader_create_compute_pipeline(VkDevice device, VkPipelineCache pipeline_cache, const char* name,
+                                                 VkPipelineLayout layout);
\ No newline at end of file
@@ -0,0 +1,415 @@
+/**
+ * @file stream.c
+ * @author ItsHighNoon
+ * @date 10-17-2026
+ * 
+ * @copyright Copyright (c) 2026
+ */
+
+#include "stream.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "os/file.h"
+#include "render/vk/memory.h"
+#include "render/vk/upload.h"
+#include "util/jobs.h"
+
+// Handles keep the slot in the low bits and a generation in the high bits, so a handle outlives its slot safely
+#define MAX_STREAMS 4096
+#define SLOT_BITS 16
+#define SLOT_MASK ((1u << SLOT_BITS) - 1)
+// Enough to keep the disk busy without filling the job queue with reads
+#define MAX_PREFETCHING 4
+// Bytes uploaded per frame, well below the staging ring so uploads never wait for it
+#define UPLOAD_BUDGET (8ull * 1024 * 1024)
+
+enum StreamState {
+    STREAM_FREE,
+    STREAM_QUEUED,
+    STREAM_PREFETCHING,
+    STREAM_PREFETCHED,
+    STREAM_UPLOADING,
+    STREAM_READY,
+    STREAM_FAILED,
+    // Released, waiting for the frames in flight
+    STREAM_RETIRED,
+};
+
+struct Stream {
+    enum StreamState state;
+    uint32_t generation;
+    int priority;
+    // Cancelled while a worker or the transfer queue still uses it, freed once they are done
+    int cancelled;
+    const FA_Pack* pack;
+    const FA_PackEntry* entry;
+    FA_JobCounter prefetched;
+    uint64_t ticket;
+    uint64_t retired_serial;
+
+    VkBuffer buffer;
+    VkImage image;
+    VkImageView image_view;
+    FA_VkAllocation allocation;
+    FA_VkBindlessHandle bindless;
+};
+
+static VkDevice device;
+static int frames_in_flight;
+static uint64_t frame_serial;
+static VkSampler sampler;
+
+static struct Stream* streams;
+static uint32_t* free_slots;
+static uint32_t free_len;
+// Slots of every stream which is not free, so a frame only looks at requests which exist
+static uint32_t* active_slots;
+static uint32_t active_len;
+static int prefetching_len;
+
+static struct Stream* lookup(FA_VkStreamHandle handle) {
+    uint32_t slot = (handle & SLOT_MASK) - 1;
+    if (slot >= MAX_STREAMS) {
+        return NULL;
+    }
+    struct Stream* stream = &streams[slot];
+    if (stream->state == STREAM_FREE || stream->cancelled || stream->state == STREAM_RETIRED ||
+        stream->generation != handle >> SLOT_BITS) {
+        return NULL;
+    }
+    return stream;
+}
+
+static void prefetch(void* data) {
+    struct Stream* stream = data;
+    _fa_os_prefetch(fa_pack_data(stream->pack, stream->entry), stream->entry->size);
+}
+
+static void destroy_resources(struct Stream* stream) {
+    if (stream->bindless != FA_VK_BINDLESS_INVALID_HANDLE) {
+        if (stream->entry->type == FA_PACK_TEXTURE) {
+            fa_vk_bindless_remove_texture(stream->bindless);
+        } else {
+            fa_vk_bindless_remove_buffer(stream->bindless);
+        }
+    }
+    if (stream->image_view != VK_NULL_HANDLE) {
+        vkDestroyImageView(device, stream->image_view, NULL);
+    }
+    if (stream->image != VK_NULL_HANDLE) {
+        fa_vk_memory_destroy_image(stream->image, &stream->allocation);
+    }
+    if (stream->buffer != VK_NULL_HANDLE) {
+        fa_vk_memory_destroy_buffer(stream->buffer, &stream->allocation);
+    }
+}
+
+static void free_stream(uint32_t active_idx) {
+    uint32_t slot = active_slots[active_idx];
+    struct Stream* stream = &streams[slot];
+    destroy_resources(stream);
+
+    uint32_t generation = stream->generation + 1;
+    memset(stream, 0, sizeof(struct Stream));
+    stream->generation = generation & (UINT32_MAX >> SLOT_BITS);
+    stream->bindless = FA_VK_BINDLESS_INVALID_HANDLE;
+
+    active_slots[active_idx] = active_slots[--active_len];
+    free_slots[free_len++] = slot;
+}
+
+// Whatever the GPU may still read has to wait for the frames in flight, the rest goes right away
+static void release(uint32_t active_idx) {
+    struct Stream* stream = &streams[active_slots[active_idx]];
+    if (stream->state == STREAM_READY && stream->entry->type != FA_PACK_SHADER) {
+        // The frame being recorded may use it too
+        stream->state = STREAM_RETIRED;
+        stream->retired_serial = frame_serial + 1;
+        return;
+    }
+    free_stream(active_idx);
+}
+
+// The next request to move on from state, the one with the highest priority
+static int most_important(enum StreamState state) {
+    int best_idx = -1;
+    for (uint32_t active_idx = 0; active_idx < active_len; active_idx++) {
+        struct Stream* stream = &streams[active_slots[active_idx]];
+        if (stream->state == state && (best_idx < 0 || stream->priority > streams[active_slots[best_idx]].priority)) {
+            best_idx = active_idx;
+        }
+    }
+    return best_idx;
+}
+
+static int create_mesh(struct Stream* stream, const void* data) {
+    VkBufferCreateInfo create_info;
+    memset(&create_info, 0, sizeof(create_info));
+    create_info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    create_info.size = stream->entry->size;
+    create_info.usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT
+                        | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+    create_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    if (fa_vk_memory_create_buffer(&create_info, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, 0, &stream->buffer,
+                                   &stream->allocation) != 0) {
+        return 1;
+    }
+
+    stream->bindless = fa_vk_bindless_add_buffer(stream->buffer, 0, VK_WHOLE_SIZE);
+    if (stream->bindless == FA_VK_BINDLESS_INVALID_HANDLE) {
+        return 1;
+    }
+
+    stream->ticket = fa_vk_upload_buffer(stream->buffer, 0, data, stream->entry->size);
+    return stream->ticket == 0;
+}
+
+static int create_texture(struct Stream* stream, const void* data) {
+    VkExtent3D extent;
+    extent.width = stream->entry->texture.width;
+    extent.height = stream->entry->texture.height;
+    extent.depth = 1;
+
+    VkImageCreateInfo create_info;
+    memset(&create_info, 0, sizeof(create_info));
+    create_info.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    create_info.imageType = VK_IMAGE_TYPE_2D;
+    // FA_PACK_FORMAT_RGBA8_SRGB is the only format so far
+    create_info.format = VK_FORMAT_R8G8B8A8_SRGB;
+    create_info.extent = extent;
+    create_info.mipLevels = 1;
+    create_info.arrayLayers = 1;
+    create_info.samples = VK_SAMPLE_COUNT_1_BIT;
+    create_info.tiling = VK_IMAGE_TILING_OPTIMAL;
+    create_info.usage = VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+    create_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    create_info.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    if (fa_vk_memory_create_image(&create_info, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, &stream->image,
+                                  &stream->allocation) != 0) {
+        return 1;
+    }
+
+    VkImageViewCreateInfo view_info;
+    memset(&view_info, 0, sizeof(view_info));
+    view_info.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+    view_info.image = stream->image;
+    view_info.viewType = VK_IMAGE_VIEW_TYPE_2D;
+    view_info.format = create_info.format;
+    view_info.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    view_info.subresourceRange.levelCount = 1;
+    view_info.subresourceRange.layerCount = 1;
+    if (vkCreateImageView(device, &view_info, NULL, &stream->image_view) != VK_SUCCESS) {
+        stream->image_view = VK_NULL_HANDLE;
+        return 1;
+    }
+
+    stream->bindless = fa_vk_bindless_add_texture(stream->image_view, sampler);
+    if (stream->bindless == FA_VK_BINDLESS_INVALID_HANDLE) {
+        return 1;
+    }
+
+    stream->ticket = fa_vk_upload_image(stream->image, VK_IMAGE_ASPECT_COLOR_BIT, extent, data,
+                                        (VkDeviceSize)extent.width * extent.height * 4,
+                                        VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    return stream->ticket == 0;
+}
+
+static void start_upload(struct Stream* stream) {
+    const void* data = fa_pack_data(stream->pack, stream->entry);
+    int result = 0;
+    switch (stream->entry->type) {
+    case FA_PACK_MESH:
+        result = create_mesh(stream, data);
+        break;
+    case FA_PACK_TEXTURE:
+        result = create_texture(stream, data);
+        break;
+    default:
+        // Shaders are used straight from the pack
+        stream->state = STREAM_READY;
+        return;
+    }
+
+    if (result != 0) {
+        printf("Failed to stream %s :(\n", fa_pack_name(stream->pack, stream->entry));
+        // Nothing was submitted, so nothing can be using the resources yet
+        destroy_resources(stream);
+        stream->buffer = VK_NULL_HANDLE;
+        stream->image = VK_NULL_HANDLE;
+        stream->image_view = VK_NULL_HANDLE;
+        stream->bindless = FA_VK_BINDLESS_INVALID_HANDLE;
+        stream->state = STREAM_FAILED;
+        return;
+    }
+    stream->state = STREAM_UPLOADING;
+}
+
+void _fa_vk_stream_init(VkDevice logical_device, int frames) {
+    device = logical_device;
+    frames_in_flight = frames;
+    frame_serial = 0;
+
+    streams = calloc(MAX_STREAMS, sizeof(struct Stream));
+    free_slots = malloc(MAX_STREAMS * sizeof(uint32_t));
+    active_slots = malloc(MAX_STREAMS * sizeof(uint32_t));
+    // Popped from the back, so the first requests get the first slots
+    for (uint32_t slot_idx = 0; slot_idx < MAX_STREAMS; slot_idx++) {
+        free_slots[slot_idx] = MAX_STREAMS - 1 - slot_idx;
+        streams[slot_idx].bindless = FA_VK_BINDLESS_INVALID_HANDLE;
+    }
+    free_len = MAX_STREAMS;
+    active_len = 0;
+    prefetching_len = 0;
+
+    VkSamplerCreateInfo sampler_info;
+    memset(&sampler_info, 0, sizeof(sampler_info));
+    sampler_info.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+    sampler_info.magFilter = VK_FILTER_LINEAR;
+    sampler_info.minFilter = VK_FILTER_LINEAR;
+    sampler_info.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
+    sampler_info.addressModeU = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+    sampler_info.addressModeV = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+    sampler_info.addressModeW = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+    sampler_info.maxLod = VK_LOD_CLAMP_NONE;
+    if (vkCreateSampler(device, &sampler_info, NULL, &sampler) != VK_SUCCESS) {
+        printf("Failed to create stream sampler :(\n");
+        exit(1);
+    }
+}
+
+void _fa_vk_stream_teardown() {
+    // Workers may still be reading from the packs
+    for (uint32_t active_idx = 0; active_idx < active_len; active_idx++) {
+        struct Stream* stream = &streams[active_slots[active_idx]];
+        if (stream->state == STREAM_PREFETCHING) {
+            fa_jobs_wait(&stream->prefetched);
+        }
+    }
+    while (active_len > 0) {
+        free_stream(active_len - 1);
+    }
+
+    vkDestroySampler(device, sampler, NULL);
+    free(streams);
+    free(free_slots);
+    free(active_slots);
+}
+
+void _fa_vk_stream_begin_frame(uint64_t serial) {
+    frame_serial = serial;
+
+    // Backwards, since freeing moves the last stream into the freed spot
+    for (uint32_t active_idx = active_len; active_idx-- > 0;) {
+        struct Stream* stream = &streams[active_slots[active_idx]];
+        if (stream->state == STREAM_PREFETCHING && atomic_load(&stream->prefetched.count) == 0) {
+            stream->state = STREAM_PREFETCHED;
+            prefetching_len--;
+        } else if (stream->state == STREAM_UPLOADING && fa_vk_upload_ready(stream->ticket)) {
+            stream->state = STREAM_READY;
+        } else if (stream->state == STREAM_RETIRED && stream->retired_serial + frames_in_flight <= frame_serial) {
+            free_stream(active_idx);
+            continue;
+        }
+
+        if (stream->cancelled && (stream->state == STREAM_PREFETCHED || stream->state == STREAM_READY)) {
+            release(active_idx);
+        }
+    }
+
+    while (prefetching_len < MAX_PREFETCHING) {
+        int active_idx = most_important(STREAM_QUEUED);
+        if (active_idx < 0) {
+            break;
+        }
+        struct Stream* stream = &streams[active_slots[active_idx]];
+        stream->state = STREAM_PREFETCHING;
+        fa_jobs_run(prefetch, stream, &stream->prefetched);
+        prefetching_len++;
+    }
+
+    // The first upload always goes, so an asset bigger than the budget still gets through
+    uint64_t budget = UPLOAD_BUDGET;
+    for (int uploaded = 0;; uploaded++) {
+        int active_idx = most_important(STREAM_PREFETCHED);
+        if (active_idx < 0) {
+            break;
+        }
+        struct Stream* stream = &streams[active_slots[active_idx]];
+        uint64_t size = stream->entry->type == FA_PACK_SHADER ? 0 : stream->entry->size;
+        if (uploaded > 0 && size > budget) {
+            break;
+        }
+        budget -= size < budget ? size : budget;
+        start_upload(stream);
+    }
+}
+
+FA_VkStreamHandle fa_vk_stream_request(const FA_Pack* pack, const char* name, int priority) {
+    const FA_PackEntry* entry = fa_pack_find(pack, name);
+    if (entry == NULL || free_len == 0) {
+        return FA_VK_STREAM_INVALID_HANDLE;
+    }
+
+    uint32_t slot = free_slots[--free_len];
+    active_slots[active_len++] = slot;
+    struct Stream* stream = &streams[slot];
+    stream->state = STREAM_QUEUED;
+    stream->priority = priority;
+    stream->pack = pack;
+    stream->entry = entry;
+    return (stream->generation << SLOT_BITS) | (slot + 1);
+}
+
+void fa_vk_stream_set_priority(FA_VkStreamHandle handle, int priority) {
+    struct Stream* stream = lookup(handle);
+    if (stream != NULL) {
+        stream->priority = priority;
+    }
+}
+
+void fa_vk_stream_cancel(FA_VkStreamHandle handle) {
+    struct Stream* stream = lookup(handle);
+    if (stream == NULL) {
+        return;
+    }
+
+    if (stream->state == STREAM_PREFETCHING || stream->state == STREAM_UPLOADING) {
+        // Picked up by _fa_vk_stream_begin_frame once the worker or the copy is done with it
+        stream->cancelled = 1;
+        return;
+    }
+    for (uint32_t active_idx = 0; active_idx < active_len; active_idx++) {
+        if (&streams[active_slots[active_idx]] == stream) {
+            release(active_idx);
+            return;
+        }
+    }
+}
+
+FA_VkStreamStatus fa_vk_stream_status(FA_VkStreamHandle handle) {
+    struct Stream* stream = lookup(handle);
+    if (stream == NULL) {
+        return FA_VK_STREAM_INVALID;
+    }
+    switch (stream->state) {
+    case STREAM_READY:
+        return FA_VK_STREAM_READY;
+    case STREAM_FAILED:
+        return FA_VK_STREAM_FAILED;
+    default:
+        return FA_VK_STREAM_LOADING;
+    }
+}
+
+VkBuffer fa_vk_stream_buffer(FA_VkStreamHandle handle) {
+    struct Stream* stream = lookup(handle);
+    return stream != NULL && stream->state == STREAM_READY ? stream->buffer : VK_NULL_HANDLE;
+}
+
+FA_VkBindlessHandle fa_vk_stream_bindless(FA_VkStreamHandle handle) {
+    struct Stream* stream = lookup(handle);
+    return stream != NULL && stream->state == STREAM_READY ? stream->bindless : FA_VK_BINDLESS_INVALID_HANDLE;
+}
\ No newline at end of file
@@ -0,0 +1,104 @@
+/**
+ * @file stream.h
+ * @author ItsHighNoon
+ * @date 10-17-2026
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ * Streams assets from packs onto the GPU in the background. A request first waits for a worker to page its payload in
+ * from disk, then the payload goes from the mapping of the pack straight into the staging ring, see upload.h. Both
+ * steps take the most important requests first, and the uploads of a frame are capped so streaming never stalls
+ * rendering on a full staging ring:
+ *     FA_VkStreamHandle rock = fa_vk_stream_request(&pack, "rock", 10);
+ *     ...
+ *     if (fa_vk_stream_status(rock) == FA_VK_STREAM_READY) {
+ *         // Draw with fa_vk_stream_buffer(rock)
+ *     }
+ *     ...
+ *     fa_vk_stream_cancel(rock);
+ * Meshes become a buffer of vertices followed by indices, textures become a sampled image, and shaders stay in the
+ * pack and are ready once they are resident. Not thread safe, call everything from the thread which renders.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <vulkan/vulkan.h>
+
+#include "asset/pack.h"
+#include "render/vk/bindless.h"
+
+typedef uint32_t FA_VkStreamHandle;
+
+#define FA_VK_STREAM_INVALID_HANDLE 0
+
+typedef enum {
+    // Cancelled, or never requested
+    FA_VK_STREAM_INVALID,
+    // Waiting for the disk or the transfer queue
+    FA_VK_STREAM_LOADING,
+    FA_VK_STREAM_READY,
+    // The asset could not be created, cancel the request to free it
+    FA_VK_STREAM_FAILED,
+} FA_VkStreamStatus;
+
+/**
+ * @param frames The number of frames in flight, which may still use released assets.
+ */
+void _fa_vk_stream_init(VkDevice device, int frames);
+
+/**
+ * Waits for every request still being paged in and destroys every asset, the device must be idle.
+ */
+void _fa_vk_stream_teardown();
+
+/**
+ * Advance requests, start paging in and uploading the most important ones, and destroy released assets which no frame
+ * in flight can use anymore.
+ * @param frame_serial Counts every frame, see _fa_vk_bindless_begin_frame.
+ */
+void _fa_vk_stream_begin_frame(uint64_t frame_serial);
+
+/**
+ * Start streaming an asset.
+ * @param pack The pack with the asset. Has to stay open until the request is cancelled.
+ * @param name The name of the asset in pack. Assumed to be null terminated.
+ * @param priority Requests with a higher priority are paged in and uploaded first.
+ * @return A handle to the request, or FA_VK_STREAM_INVALID_HANDLE if pack does not have the asset or too many
+ *         requests are active.
+ */
+FA_VkStreamHandle fa_vk_stream_request(const FA_Pack* pack, const char* name, int priority);
+
+/**
+ * Change the priority of a request which is still loading, for example when the camera moves.
+ * @param handle The request.
+ * @param priority The new priority.
+ */
+void fa_vk_stream_set_priority(FA_VkStreamHandle handle, int priority);
+
+/**
+ * Stop streaming an asset, or release it once it is no longer needed. The handle is invalid afterwards. Anything
+ * already created is destroyed once no frame in flight can use it.
+ * @param handle The request to cancel.
+ */
+void fa_vk_stream_cancel(FA_VkStreamHandle handle);
+
+/**
+ * @param handle The request.
+ * @return Where the request is.
+ */
+FA_VkStreamStatus fa_vk_stream_status(FA_VkStreamHandle handle);
+
+/**
+ * @param handle A mesh request.
+ * @return The buffer of the mesh, laid out like its payload, or VK_NULL_HANDLE if it is not ready. Usable as an index
+ *         buffer and a storage buffer.
+ */
+VkBuffer fa_vk_stream_buffer(FA_VkStreamHandle handle);
+
+/**
+ * @param handle A mesh or texture request.
+ * @return The buffer or texture index of the asset in shader/bindless.glsl, or FA_VK_BINDLESS_INVALID_HANDLE if it is
+ *         not ready.
+ */
+FA_VkBindlessHandle fa_vk_stream_bindless(FA_VkStreamHandle handle);
\ No newline at end of file
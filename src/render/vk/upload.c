@@ -0,0 +1,434 @@
+/**
+ * @file upload.c
+ * @author ItsHighNoon
+ * @date 10-17-2026
+ * 
+ * @copyright Copyright (c) 2026
+ */
+
+#include "upload.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "render/vk/memory.h"
+#include "util/arena.h"
+
+#define STAGING_SIZE (32ull * 1024 * 1024)
+// Covers optimalBufferCopyOffsetAlignment and the texel size of every format on the drivers we care about
+#define STAGING_ALIGNMENT 256
+#define BATCHES 4
+
+enum BatchState {
+    BATCH_FREE,
+    BATCH_RECORDING,
+    BATCH_SUBMITTED
+};
+
+struct UploadBatch {
+    VkCommandPool command_pool;
+    VkCommandBuffer command_buffer;
+    enum BatchState state;
+    // Value of the timeline semaphore once the batch has finished
+    uint64_t ticket;
+    // Ring position after the last copy, everything before it is free once the batch has finished
+    uint64_t ring_end;
+};
+
+/*
+ * The graphics half of a queue family ownership transfer, recorded at the start of the first frame after the copy
+ * finished.
+ */
+struct PendingAcquire {
+    uint64_t ticket;
+    int is_image;
+    VkBufferMemoryBarrier buffer_barrier;
+    VkImageMemoryBarrier image_barrier;
+};
+
+static VkDevice device;
+static VkQueue transfer_queue;
+static uint32_t transfer_family;
+static uint32_t graphics_family;
+
+static VkSemaphore timeline;
+static uint64_t next_ticket = 1;
+static uint64_t handed_ticket;
+
+static VkBuffer ring_buffer;
+static FA_VkAllocation ring_allocation;
+// Positions only ever grow, the offset in the buffer is the position modulo STAGING_SIZE
+static uint64_t ring_head;
+static uint64_t ring_tail;
+
+static struct UploadBatch batches[BATCHES];
+static int current_batch;
+static int oldest_batch;
+
+static struct PendingAcquire* pending;
+static int pending_len;
+static int pending_capacity;
+
+static uint64_t completed_ticket() {
+    uint64_t value = 0;
+    vkGetSemaphoreCounterValue(device, timeline, &value);
+    return value;
+}
+
+// Free ring space used by batches which have finished
+static void reclaim() {
+    uint64_t completed = completed_ticket();
+    while (batches[oldest_batch].state == BATCH_SUBMITTED && batches[oldest_batch].ticket <= completed) {
+        ring_tail = batches[oldest_batch].ring_end;
+        batches[oldest_batch].state = BATCH_FREE;
+        oldest_batch = (oldest_batch + 1) % BATCHES;
+    }
+}
+
+static void wait_for_ticket(uint64_t ticket) {
+    VkSemaphoreWaitInfo wait_info;
+    memset(&wait_info, 0, sizeof(wait_info));
+    wait_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+    wait_info.semaphoreCount = 1;
+    wait_info.pSemaphores = &timeline;
+    wait_info.pValues = &ticket;
+    vkWaitSemaphores(device, &wait_info, UINT64_MAX);
+}
+
+static struct UploadBatch* begin_batch() {
+    struct UploadBatch* batch = &batches[current_batch];
+    if (batch->state == BATCH_RECORDING) {
+        return batch;
+    }
+
+    if (batch->state == BATCH_SUBMITTED) {
+        // Every batch is in flight, the oldest has to finish before its command buffer can be reused
+        wait_for_ticket(batch->ticket);
+        reclaim();
+    }
+
+    vkResetCommandPool(device, batch->command_pool, 0);
+
+    VkCommandBufferBeginInfo begin_info;
+    memset(&begin_info, 0, sizeof(begin_info));
+    begin_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    begin_info.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    vkBeginCommandBuffer(batch->command_buffer, &begin_info);
+
+    batch->state = BATCH_RECORDING;
+    batch->ticket = next_ticket++;
+    return batch;
+}
+
+static uint64_t align_up(uint64_t value, uint64_t alignment) {
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+static int reserve(VkDeviceSize size, VkDeviceSize* offset) {
+    if (size > STAGING_SIZE) {
+        return 1;
+    }
+
+    for (;;) {
+        reclaim();
+        if (ring_tail == ring_head) {
+            // Nothing in flight, start over at the beginning of the buffer so even a copy of STAGING_SIZE fits
+            ring_head = align_up(ring_head, STAGING_SIZE);
+            ring_tail = ring_head;
+        }
+
+        uint64_t start = align_up(ring_head, STAGING_ALIGNMENT);
+        if (start % STAGING_SIZE + size > STAGING_SIZE) {
+            // Copies have to be contiguous, skip the rest of the buffer
+            start += STAGING_SIZE - start % STAGING_SIZE;
+        }
+        if (start + size - ring_tail <= STAGING_SIZE) {
+            ring_head = start + size;
+            *offset = start % STAGING_SIZE;
+            return 0;
+        }
+
+        // The ring is full of copies still in flight, submit ours and wait for the oldest
+        if (batches[current_batch].state == BATCH_RECORDING) {
+            fa_vk_upload_flush();
+        }
+        if (batches[oldest_batch].state != BATCH_SUBMITTED) {
+            // Nothing left to wait for, so waiting would never free any space
+            return 1;
+        }
+        wait_for_ticket(batches[oldest_batch].ticket);
+    }
+}
+
+static struct PendingAcquire* add_pending(uint64_t ticket) {
+    if (pending_len == pending_capacity) {
+        pending_capacity = pending_capacity > 0 ? pending_capacity * 2 : 64;
+        pending = realloc(pending, pending_capacity * sizeof(struct PendingAcquire));
+    }
+
+    struct PendingAcquire* acquire = &pending[pending_len++];
+    memset(acquire, 0, sizeof(struct PendingAcquire));
+    acquire->ticket = ticket;
+    return acquire;
+}
+
+void _fa_vk_upload_init(VkDevice logical_device, uint32_t transfer_family_idx, VkQueue queue,
+                        uint32_t graphics_family_idx) {
+    device = logical_device;
+    transfer_family = transfer_family_idx;
+    transfer_queue = queue;
+    graphics_family = graphics_family_idx;
+
+    VkSemaphoreTypeCreateInfo type_info;
+    memset(&type_info, 0, sizeof(type_info));
+    type_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+    type_info.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+    type_info.initialValue = 0;
+
+    VkSemaphoreCreateInfo semaphore_info;
+    memset(&semaphore_info, 0, sizeof(semaphore_info));
+    semaphore_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+    semaphore_info.pNext = &type_info;
+    if (vkCreateSemaphore(device, &semaphore_info, NULL, &timeline) != VK_SUCCESS) {
+        printf("Failed to create upload semaphore :(\n");
+        exit(1);
+    }
+
+    VkBufferCreateInfo buffer_info;
+    memset(&buffer_info, 0, sizeof(buffer_info));
+    buffer_info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    buffer_info.size = STAGING_SIZE;
+    buffer_info.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+    buffer_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    if (fa_vk_memory_create_buffer(&buffer_info, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT
+                                   | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, 0, &ring_buffer, &ring_allocation) != 0) {
+        printf("Failed to create staging buffer :(\n");
+        exit(1);
+    }
+
+    for (int batch_idx = 0; batch_idx < BATCHES; batch_idx++) {
+        VkCommandPoolCreateInfo pool_info;
+        memset(&pool_info, 0, sizeof(pool_info));
+        pool_info.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+        pool_info.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+        pool_info.queueFamilyIndex = transfer_family;
+        if (vkCreateCommandPool(device, &pool_info, NULL, &batches[batch_idx].command_pool) != VK_SUCCESS) {
+            printf("Failed to create upload command pool :(\n");
+            exit(1);
+        }
+
+        VkCommandBufferAllocateInfo alloc_info;
+        memset(&alloc_info, 0, sizeof(alloc_info));
+        alloc_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        alloc_info.commandPool = batches[batch_idx].command_pool;
+        alloc_info.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        alloc_info.commandBufferCount = 1;
+        if (vkAllocateCommandBuffers(device, &alloc_info, &batches[batch_idx].command_buffer) != VK_SUCCESS) {
+            printf("Failed to allocate upload command buffer :(\n");
+            exit(1);
+        }
+        batches[batch_idx].state = BATCH_FREE;
+    }
+}
+
+void _fa_vk_upload_teardown() {
+    fa_vk_upload_flush();
+    wait_for_ticket(next_ticket - 1);
+
+    for (int batch_idx = 0; batch_idx < BATCHES; batch_idx++) {
+        vkDestroyCommandPool(device, batches[batch_idx].command_pool, NULL);
+    }
+    fa_vk_memory_destroy_buffer(ring_buffer, &ring_allocation);
+    vkDestroySemaphore(device, timeline, NULL);
+
+    free(pending);
+    pending = NULL;
+    pending_len = 0;
+    pending_capacity = 0;
+}
+
+VkSemaphore _fa_vk_upload_acquire(VkCommandBuffer command_buffer, uint64_t* wait_value) {
+    fa_vk_upload_flush();
+    reclaim();
+
+    // Only finished copies, so the frame never waits for the transfer queue on the GPU either
+    uint64_t completed = completed_ticket();
+    int buffer_count = 0;
+    int image_count = 0;
+    for (int pending_idx = 0; pending_idx < pending_len; pending_idx++) {
+        if (pending[pending_idx].ticket <= completed) {
+            if (pending[pending_idx].is_image) {
+                image_count++;
+            } else {
+                buffer_count++;
+            }
+        }
+    }
+
+    *wait_value = 0;
+    if (completed > handed_ticket) {
+        handed_ticket = completed;
+    }
+    if (buffer_count + image_count == 0) {
+        return VK_NULL_HANDLE;
+    }
+
+    FA_ArenaScope scratch = fa_arena_scratch_begin();
+    VkBufferMemoryBarrier* buffer_barriers = fa_arena_push(scratch.arena, buffer_count * sizeof(VkBufferMemoryBarrier));
+    VkImageMemoryBarrier* image_barriers = fa_arena_push(scratch.arena, image_count * sizeof(VkImageMemoryBarrier));
+    buffer_count = 0;
+    image_count = 0;
+    int kept = 0;
+    for (int pending_idx = 0; pending_idx < pending_len; pending_idx++) {
+        if (pending[pending_idx].ticket > completed) {
+            pending[kept++] = pending[pending_idx];
+        } else if (pending[pending_idx].is_image) {
+            image_barriers[image_count++] = pending[pending_idx].image_barrier;
+        } else {
+            buffer_barriers[buffer_count++] = pending[pending_idx].buffer_barrier;
+        }
+    }
+    pending_len = kept;
+
+    vkCmdPipelineBarrier(command_buffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0,
+                         0, NULL, buffer_count, buffer_barriers, image_count, image_barriers);
+    fa_arena_scratch_end(scratch);
+
+    // Already signaled, but the release and acquire need a semaphore between them to be well defined
+    *wait_value = completed;
+    return timeline;
+}
+
+uint64_t fa_vk_upload_buffer(VkBuffer buffer, VkDeviceSize offset, const void* data, VkDeviceSize size) {
+    VkDeviceSize staging_offset;
+    if (reserve(size, &staging_offset) != 0) {
+        return 0;
+    }
+    memcpy((char*)ring_allocation.mapped + staging_offset, data, size);
+
+    struct UploadBatch* batch = begin_batch();
+
+    VkBufferCopy region;
+    region.srcOffset = staging_offset;
+    region.dstOffset = offset;
+    region.size = size;
+    vkCmdCopyBuffer(batch->command_buffer, ring_buffer, buffer, 1, &region);
+
+    struct PendingAcquire* acquire = add_pending(batch->ticket);
+    VkBufferMemoryBarrier* barrier = &acquire->buffer_barrier;
+    barrier->sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+    barrier->srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier->dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier->buffer = buffer;
+    barrier->offset = offset;
+    barrier->size = size;
+
+    if (transfer_family != graphics_family) {
+        barrier->srcQueueFamilyIndex = transfer_family;
+        barrier->dstQueueFamilyIndex = graphics_family;
+        barrier->srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        vkCmdPipelineBarrier(batch->command_buffer, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                             VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0, NULL, 1, barrier, 0, NULL);
+    }
+
+    // The semaphore makes the copy visible, the barrier on the graphics queue is the acquire half
+    barrier->srcAccessMask = 0;
+    barrier->dstAccessMask = VK_ACCESS_MEMORY_READ_BIT;
+    return batch->ticket;
+}
+
+uint64_t fa_vk_upload_image(VkImage image, VkImageAspectFlags aspect, VkExtent3D extent, const void* data,
+                            VkDeviceSize size, VkImageLayout final_layout) {
+    VkDeviceSize staging_offset;
+    if (reserve(size, &staging_offset) != 0) {
+        return 0;
+    }
+    memcpy((char*)ring_allocation.mapped + staging_offset, data, size);
+
+    struct UploadBatch* batch = begin_batch();
+
+    VkImageMemoryBarrier barrier;
+    memset(&barrier, 0, sizeof(barrier));
+    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barrier.srcAccessMask = 0;
+    barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image = image;
+    barrier.subresourceRange.aspectMask = aspect;
+    barrier.subresourceRange.levelCount = 1;
+    barrier.subresourceRange.layerCount = 1;
+    vkCmdPipelineBarrier(batch->command_buffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0,
+                         0, NULL, 0, NULL, 1, &barrier);
+
+    VkBufferImageCopy region;
+    memset(&region, 0, sizeof(region));
+    region.bufferOffset = staging_offset;
+    region.imageSubresource.aspectMask = aspect;
+    region.imageSubresource.layerCount = 1;
+    region.imageExtent = extent;
+    vkCmdCopyBufferToImage(batch->command_buffer, ring_buffer, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+
+    // The layout transition happens in the release and again in the acquire, with identical layouts in both
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = 0;
+    barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    barrier.newLayout = final_layout;
+    if (transfer_family != graphics_family) {
+        barrier.srcQueueFamilyIndex = transfer_family;
+        barrier.dstQueueFamilyIndex = graphics_family;
+    }
+    vkCmdPipelineBarrier(batch->command_buffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+                         0, 0, NULL, 0, NULL, 1, &barrier);
+
+    struct PendingAcquire* acquire = add_pending(batch->ticket);
+    acquire->is_image = 1;
+    acquire->image_barrier = barrier;
+    acquire->image_barrier.srcAccessMask = 0;
+    acquire->image_barrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT;
+    if (transfer_family == graphics_family) {
+        // Already transitioned on the same queue family, only visibility is left
+        acquire->image_barrier.oldLayout = final_layout;
+    }
+    return batch->ticket;
+}
+
+void fa_vk_upload_flush() {
+    struct UploadBatch* batch = &batches[current_batch];
+    if (batch->state != BATCH_RECORDING) {
+        return;
+    }
+
+    vkEndCommandBuffer(batch->command_buffer);
+
+    VkTimelineSemaphoreSubmitInfo timeline_info;
+    memset(&timeline_info, 0, sizeof(timeline_info));
+    timeline_info.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+    timeline_info.signalSemaphoreValueCount = 1;
+    timeline_info.pSignalSemaphoreValues = &batch->ticket;
+
+    VkSubmitInfo submit_info;
+    memset(&submit_info, 0, sizeof(submit_info));
+    submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submit_info.pNext = &timeline_info;
+    submit_info.commandBufferCount = 1;
+    submit_info.pCommandBuffers = &batch->command_buffer;
+    submit_info.signalSemaphoreCount = 1;
+    submit_info.pSignalSemaphores = &timeline;
+
+    if (vkQueueSubmit(transfer_queue, 1, &submit_info, VK_NULL_HANDLE) != VK_SUCCESS) {
+        printf("Failed to submit uploads :(\n");
+        exit(1);
+    }
+
+    batch->state = BATCH_SUBMITTED;
+    batch->ring_end = ring_head;
+    current_batch = (current_batch + 1) % BATCHES;
+}
+
+int fa_vk_upload_ready(uint64_t ticket) {
+    return ticket != 0 && ticket <= handed_ticket;
+}
\ No newline at end of file
@@ -0,0 +1,81 @@
+/**
+ * @file upload.h
+ * @author ItsHighNoon
+ * @date 10-17-2026
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ * Asynchronous uploads to device local memory. Data is copied into a persistently mapped staging ring, and the copies
+ * are batched into command buffers which run on the transfer queue, next to rendering instead of in front of it.
+ *
+ * Every upload returns a ticket. Once the transfer has finished, the next frame takes ownership of the resource on the
+ * graphics queue, and from then on fa_vk_upload_ready says the resource can be used:
+ *
+ *     uint64_t ticket = fa_vk_upload_buffer(vertex_buffer, 0, vertices, vertices_size);
+ *     fa_vk_upload_flush();
+ *     ...
+ *     if (fa_vk_upload_ready(ticket)) {
+ *         // Draw with vertex_buffer
+ *     }
+ *
+ * Not thread safe, uploads are recorded and submitted on the thread which renders.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <vulkan/vulkan.h>
+
+/**
+ * @param transfer_family The queue family of transfer_queue. May be the same as graphics_family.
+ * @param transfer_queue The queue to run copies on.
+ * @param graphics_family The queue family which uses the uploaded resources.
+ */
+void _fa_vk_upload_init(VkDevice device, uint32_t transfer_family, VkQueue transfer_queue, uint32_t graphics_family);
+
+void _fa_vk_upload_teardown();
+
+/**
+ * Hand finished uploads over to the graphics queue. Called at the start of every frame's command buffer.
+ * @param command_buffer The graphics command buffer being recorded.
+ * @param wait_value Set to the value of the upload semaphore the frame has to wait for, or 0 if there is none.
+ * @return The semaphore to wait for before the command buffer runs.
+ */
+VkSemaphore _fa_vk_upload_acquire(VkCommandBuffer command_buffer, uint64_t* wait_value);
+
+/**
+ * Queue a copy into a buffer.
+ * @param buffer The buffer to copy to. Must have been created with VK_BUFFER_USAGE_TRANSFER_DST_BIT and
+ *        VK_SHARING_MODE_EXCLUSIVE.
+ * @param offset Where in buffer to copy to.
+ * @param data The data to copy. Copied into the staging ring before this returns.
+ * @param size The size of data in bytes.
+ * @return A ticket for fa_vk_upload_ready, or 0 if data does not fit in the staging ring.
+ */
+uint64_t fa_vk_upload_buffer(VkBuffer buffer, VkDeviceSize offset, const void* data, VkDeviceSize size);
+
+/**
+ * Queue a copy into the first mip level and layer of an image.
+ * @param image The image to copy to. Must have been created with VK_IMAGE_USAGE_TRANSFER_DST_BIT and
+ *        VK_SHARING_MODE_EXCLUSIVE. The previous contents are discarded.
+ * @param aspect The aspect of image to copy to.
+ * @param extent The size of the image.
+ * @param data Tightly packed texels. Copied into the staging ring before this returns.
+ * @param size The size of data in bytes.
+ * @param final_layout The layout the image is in once the upload is ready.
+ * @return A ticket for fa_vk_upload_ready, or 0 if data does not fit in the staging ring.
+ */
+uint64_t fa_vk_upload_image(VkImage image, VkImageAspectFlags aspect, VkExtent3D extent, const void* data,
+                            VkDeviceSize size, VkImageLayout final_layout);
+
+/**
+ * Submit all queued copies to the transfer queue. Also happens at the start of every frame.
+ */
+void fa_vk_upload_flush();
+
+/**
+ * Check whether an upload can be used by the graphics queue.
+ * @param ticket A ticket returned by fa_vk_upload_buffer or fa_vk_upload_image.
+ * @return 1 if the resource has been handed to the graphics queue, 0 if it is still on its way.
+ */
+int fa_vk_upload_ready(uint64_t ticket);
\ No newline at end of file
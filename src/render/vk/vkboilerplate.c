@@ -18,7 +18,32 @@
 #include <GLFW/glfw3.h>
 
 #include "os/display.h"
+#include "os/file.h"
+#include "render/vk/bindless.h"
+#include "render/vk/compute.h"
+#include "render/vk/cull.h"
+#include "render/vk/draw_queue.h"
+#include "render/vk/memory.h"
+#include "render/vk/offscreen.h"
+#include "render/vk/profile.h"
+#include "render/vk/record.h"
+#include "render/vk/shaders.h"
+#include "render/vk/stream.h"
+#include "render/vk/upload.h"
+#include "util/arena.h"
+#include "util/jobs.h"
+#include "util/option_names.h"
 #include "util/options.h"
+#include "util/profile.h"
+#include "util/util.h"
+
+// "FAPC" in a little endian file
+#define PIPELINE_CACHE_MAGIC 0x43504146
+#define PIPELINE_CACHE_VERSION 1
+
+#define DEFAULT_FRAMES_IN_FLIGHT 2
+#define MAX_FRAMES_IN_FLIGHT 8
+#define MAX_RETIRED_SWAP_CHAINS 4
 
 static const char* DEVICE_EXTENSIONS[] = {
     VK_KHR_SWAPCHAIN_EXTENSION_NAME
@@ -33,6 +58,8 @@ static VkPhysicalDevice physical_device;
 static VkDevice device;
 static VkQueue graphics_queue;
 static VkQueue present_queue;
+static VkQueue transfer_queue;
+static VkQueue compute_queue;
 static VkSurfaceKHR surface;
 static VkSwapchainKHR swap_chain;
 static VkFormat swap_chain_format;
@@ -41,6 +68,90 @@ static VkImage* swap_chain_images;
 static int swap_chain_images_len;
 static VkImageView* swap_chain_image_views;
 static int swap_chain_image_views_len;
+static VkFramebuffer* swap_chain_framebuffers;
+static VkSemaphore* render_finished_semaphores;
+// Shared by every frame, each main pass clears it and the depth pyramid is built from it
+static VkFormat depth_format;
+static VkImage depth_image;
+static FA_VkAllocation depth_allocation;
+static VkImageView depth_image_view;
+static uint32_t graphics_family;
+static uint32_t transfer_family;
+static uint32_t compute_family;
+static VkRenderPass render_pass;
+static VkPipelineLayout pipeline_layout;
+static VkPipeline graphics_pipeline;
+static VkPipelineCache pipeline_cache;
+static int calibrated_timestamps;
+// What the default pipeline draws with, a color read through the bindless set
+static VkBuffer material_buffer;
+static FA_VkAllocation material_allocation;
+static FA_VkBindlessHandle material_handle;
+static uint64_t material_ticket;
+// The indices of every mesh
+static VkBuffer mesh_buffer;
+static FA_VkAllocation mesh_allocation;
+static FA_VkMesh triangle_mesh;
+static uint64_t mesh_ticket;
+static uint32_t default_pipeline_id;
+// Rendering to offscreen images instead of a window, see _fa_display_headless
+static int headless;
+
+/*
+ * Written in front of the driver's own cache data. The driver checks its header too, but not the driver version, and
+ * some drivers crash instead of rejecting data from an older build.
+ */
+struct PipelineCacheHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t vendor_id;
+    uint32_t device_id;
+    uint32_t driver_version;
+    uint8_t uuid[VK_UUID_SIZE];
+    uint64_t data_size;
+    uint64_t data_hash;
+};
+
+/*
+ * Everything one frame needs while the GPU may still be working on the frames before it. The CPU records frame N + 1
+ * while frame N executes, and only blocks on the fence once it comes back around to the same resources.
+ */
+struct FrameResources {
+    VkCommandPool command_pool;
+    VkCommandBuffer command_buffer;
+    VkSemaphore image_available;
+    VkFence in_flight;
+};
+
+static struct FrameResources frames[MAX_FRAMES_IN_FLIGHT];
+static int frames_in_flight;
+static int frame_index;
+static uint32_t image_index;
+static int image_acquired;
+// Frames submitted so far
+static uint64_t frame_serial;
+
+/*
+ * A swapchain replaced by a new one, along with everything created from it. Frames already submitted may still render
+ * to it, so it is destroyed once every frame slot has come back around instead of waiting for the device to go idle.
+ */
+struct RetiredSwapChain {
+    VkSwapchainKHR swap_chain;
+    VkImage* images;
+    VkImageView* image_views;
+    VkFramebuffer* framebuffers;
+    VkSemaphore* render_finished_semaphores;
+    int images_len;
+    VkImage depth_image;
+    FA_VkAllocation depth_allocation;
+    VkImageView depth_image_view;
+    // Frames submitted before it was replaced
+    uint64_t frame_serial;
+};
+
+static struct RetiredSwapChain retired_swap_chains[MAX_RETIRED_SWAP_CHAINS];
+static int retired_swap_chains_len;
+static int swap_chain_dirty;
 
 struct SwapChainSupportDetails {
     VkSurfaceCapabilitiesKHR capabilities;
@@ -55,50 +166,157 @@ struct QueueFamilyIndices {
     int found_graphics_family;
     uint32_t present_family;
     int found_present_family;
+    // Falls back to the graphics family when there is no separate transfer family
+    uint32_t transfer_family;
+    int found_transfer_family;
+    // Falls back to the graphics queue when there is no family with compute but not graphics
+    uint32_t compute_family;
+    int found_compute_family;
+    // May share the family of the transfer queue, then it takes the second queue if there is one
+    uint32_t compute_queue_index;
+};
+
+/*
+ * A physical device as queried by a worker during startup. Everything but the surface is known before the window is,
+ * the rest is checked once the surface exists.
+ */
+struct DeviceCandidate {
+    VkPhysicalDevice device;
+    VkPhysicalDeviceProperties properties;
+    struct QueueFamilyIndices qfi;
+    int suitable;
+    int score;
 };
 
-struct SwapChainSupportDetails query_swap_chain_support(VkPhysicalDevice device) {
+/*
+ * Startup runs as a graph of jobs, see _fa_vk_init_begin. The workers create the instance, query the devices and load
+ * the pipeline cache while the main thread opens the window, then create shader modules while it builds the rest.
+ */
+static FA_JobCounter startup_jobs;
+static int startup_begun;
+static struct DeviceCandidate* device_candidates;
+static uint32_t device_candidates_len;
+// Mapped and checked against its hash by a worker, checked against the device once there is one
+static const unsigned char* pipeline_cache_file;
+static size_t pipeline_cache_file_size;
+static VkShaderModule vert_module;
+static VkShaderModule frag_module;
+
+// Queried once while picking the physical device
+static VkPhysicalDeviceProperties physical_device_properties;
+static struct QueueFamilyIndices queue_families;
+// Fixed for the surface, only the capabilities follow the window and are queried again
+static VkSurfaceFormatKHR* surface_formats;
+static uint32_t surface_formats_len;
+static VkPresentModeKHR* surface_present_modes;
+static uint32_t surface_present_modes_len;
+// render.validation asked for the validation layers and they are installed
+static int validation;
+
+struct SwapChainSupportDetails query_swap_chain_support(VkPhysicalDevice device, FA_Arena* arena) {
     struct SwapChainSupportDetails details;
 
     vkGetPhysicalDeviceSurfaceCapabilitiesKHR(device, surface, &details.capabilities);
 
     vkGetPhysicalDeviceSurfaceFormatsKHR(device, surface, &details.formats_len, NULL);
-    details.formats = malloc(details.formats_len * sizeof(VkSurfaceFormatKHR));
+    details.formats = fa_arena_push(arena, details.formats_len * sizeof(VkSurfaceFormatKHR));
     vkGetPhysicalDeviceSurfaceFormatsKHR(device, surface, &details.formats_len, details.formats);
 
     vkGetPhysicalDeviceSurfacePresentModesKHR(device, surface, &details.modes_len, NULL);
-    details.present_modes = malloc(details.modes_len * sizeof(VkPresentModeKHR));
+    details.present_modes = fa_arena_push(arena, details.modes_len * sizeof(VkPresentModeKHR));
     vkGetPhysicalDeviceSurfacePresentModesKHR(device, surface, &details.modes_len, details.present_modes);
 
     return details;
 }
 
+// Everything but the present family, which needs the surface, see find_present_family
 struct QueueFamilyIndices find_queue_families(VkPhysicalDevice device) {
     struct QueueFamilyIndices qfi;
     memset(&qfi, 0, sizeof(qfi));
 
+    FA_ArenaScope scratch = fa_arena_scratch_begin();
     uint32_t queue_family_count = 0;
     vkGetPhysicalDeviceQueueFamilyProperties(device, &queue_family_count, NULL);
-    VkQueueFamilyProperties* queue_families = malloc(queue_family_count * sizeof(VkQueueFamilyProperties));
+    VkQueueFamilyProperties* queue_families = fa_arena_push(scratch.arena, queue_family_count * sizeof(VkQueueFamilyProperties));
     vkGetPhysicalDeviceQueueFamilyProperties(device, &queue_family_count, queue_families);
 
+    int transfer_family_score = -1;
     for (int queue_family_idx = 0; queue_family_idx < queue_family_count; queue_family_idx++) {
-        if (queue_families[queue_family_idx].queueFlags & VK_QUEUE_GRAPHICS_BIT) {
+        // Dedicated transfer families are the copy engines, which run alongside graphics work
+        VkQueueFlags flags = queue_families[queue_family_idx].queueFlags;
+        if (flags & VK_QUEUE_TRANSFER_BIT) {
+            int score = 0;
+            if ((flags & VK_QUEUE_GRAPHICS_BIT) == 0) {
+                score++;
+                if ((flags & VK_QUEUE_COMPUTE_BIT) == 0) {
+                    score++;
+                }
+            }
+            if (score > transfer_family_score) {
+                transfer_family_score = score;
+                qfi.transfer_family = queue_family_idx;
+                qfi.found_transfer_family = 1;
+            }
+        }
+        // The first family with graphics and compute, every device with graphics has one
+        if ((flags & VK_QUEUE_GRAPHICS_BIT) && (qfi.found_graphics_family == 0 || ((flags & VK_QUEUE_COMPUTE_BIT)
+            && (queue_families[qfi.graphics_family].queueFlags & VK_QUEUE_COMPUTE_BIT) == 0))) {
             qfi.graphics_family = queue_family_idx;
             qfi.found_graphics_family = 1;
         }
-        VkBool32 present_support;
-        vkGetPhysicalDeviceSurfaceSupportKHR(device, queue_family_idx, surface, &present_support);
-        if (present_support) {
-            qfi.present_family = queue_family_idx;
-            qfi.found_present_family = 1;
+    }
+
+    // Graphics queues always support transfers, even without the bit
+    if (qfi.found_graphics_family && (qfi.found_transfer_family == 0 || transfer_family_score == 0)) {
+        qfi.transfer_family = qfi.graphics_family;
+        qfi.found_transfer_family = 1;
+    }
+
+    // Compute families without graphics are the async compute engines. One the copies do not use comes first.
+    for (int queue_family_idx = 0; queue_family_idx < queue_family_count; queue_family_idx++) {
+        VkQueueFlags flags = queue_families[queue_family_idx].queueFlags;
+        if ((flags & VK_QUEUE_COMPUTE_BIT) == 0 || (flags & VK_QUEUE_GRAPHICS_BIT)) {
+            continue;
         }
+        int shares_transfer = queue_family_idx == qfi.transfer_family;
+        if (qfi.found_compute_family == 0 || (qfi.compute_family == qfi.transfer_family && !shares_transfer)) {
+            qfi.compute_family = queue_family_idx;
+            qfi.found_compute_family = 1;
+            qfi.compute_queue_index = shares_transfer && queue_families[queue_family_idx].queueCount > 1 ? 1 : 0;
+        }
+    }
+    if (qfi.found_graphics_family && qfi.found_compute_family == 0) {
+        qfi.compute_family = qfi.graphics_family;
+        qfi.found_compute_family = 1;
+        qfi.compute_queue_index = 0;
     }
 
-    free(queue_families);
+    fa_arena_scratch_end(scratch);
     return qfi;
 }
 
+static void find_present_family(VkPhysicalDevice device, struct QueueFamilyIndices* qfi) {
+    // Without a surface nothing is presented, so the graphics queue stands in
+    if (surface == VK_NULL_HANDLE) {
+        qfi->present_family = qfi->graphics_family;
+        qfi->found_present_family = qfi->found_graphics_family;
+        return;
+    }
+
+    uint32_t queue_family_count = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(device, &queue_family_count, NULL);
+    qfi->found_present_family = 0;
+    for (uint32_t queue_family_idx = 0; queue_family_idx < queue_family_count; queue_family_idx++) {
+        VkBool32 present_support;
+        vkGetPhysicalDeviceSurfaceSupportKHR(device, queue_family_idx, surface, &present_support);
+        // Presenting from the graphics queue saves sharing the swapchain images between families
+        if (present_support && (qfi->found_present_family == 0 || queue_family_idx == qfi->graphics_family)) {
+            qfi->present_family = queue_family_idx;
+            qfi->found_present_family = 1;
+        }
+    }
+}
+
 static VkSurfaceFormatKHR choose_swap_surface_format(struct SwapChainSupportDetails* details) {
     for (int format_idx = 0; format_idx < details->formats_len; format_idx++) {
         if (details->formats[format_idx].format == VK_FORMAT_B8G8R8A8_SRGB
@@ -111,12 +329,31 @@ static VkSurfaceFormatKHR choose_swap_surface_format(struct SwapChainSupportDeta
 }
 
 static VkPresentModeKHR choose_swap_present_mode(struct SwapChainSupportDetails* details) {
-    for (int mode_idx = 0; mode_idx < details->formats_len; mode_idx++) {
-        if (details->present_modes[mode_idx] == VK_PRESENT_MODE_MAILBOX_KHR) {
-            return details->present_modes[mode_idx];
+    // Mailbox has the lowest latency without tearing
+    VkPresentModeKHR wanted = VK_PRESENT_MODE_MAILBOX_KHR;
+    FA_OptionValue mode_value = fa_options_get_hashed(FA_OPTION_NAME_RENDER_PRESENT_MODE);
+    if (mode_value.type == FA_OPTION_STRING) {
+        const char* mode_name = fa_options_string(&mode_value);
+        if (strcmp(mode_name, "immediate") == 0) {
+            wanted = VK_PRESENT_MODE_IMMEDIATE_KHR;
+        } else if (strcmp(mode_name, "fifo") == 0) {
+            wanted = VK_PRESENT_MODE_FIFO_KHR;
+        } else if (strcmp(mode_name, "fifo_relaxed") == 0) {
+            wanted = VK_PRESENT_MODE_FIFO_RELAXED_KHR;
+        } else if (strcmp(mode_name, "mailbox") != 0) {
+            printf("Unknown present mode %s, using mailbox\n", mode_name);
+        }
+    } else {
+        fa_options_set_string("render.present_mode", "mailbox");
+    }
+
+    for (int mode_idx = 0; mode_idx < details->modes_len; mode_idx++) {
+        if (details->present_modes[mode_idx] == wanted) {
+            return wanted;
         }
     }
 
+    // The only mode every driver supports
     return VK_PRESENT_MODE_FIFO_KHR;
 }
 
@@ -150,12 +387,14 @@ static VkExtent2D choose_swap_extent(struct SwapChainSupportDetails* details) {
 }
 
 static int check_device_extensions(VkPhysicalDevice device) {
+    FA_ArenaScope scratch = fa_arena_scratch_begin();
     uint32_t extension_count;
     vkEnumerateDeviceExtensionProperties(device, NULL, &extension_count, NULL);
-    VkExtensionProperties* extensions = malloc(extension_count * sizeof(VkExtensionProperties));
+    VkExtensionProperties* extensions = fa_arena_push(scratch.arena, extension_count * sizeof(VkExtensionProperties));
     vkEnumerateDeviceExtensionProperties(device, NULL, &extension_count, extensions);
 
     int found[sizeof(DEVICE_EXTENSIONS) / sizeof(char*)];
+    memset(found, 0, sizeof(found));
     for (int requested_idx = 0; requested_idx < sizeof(DEVICE_EXTENSIONS) / sizeof(char*); requested_idx++) {
         for (int extension_idx = 0; extension_idx < extension_count; extension_idx++) {
             if (strcmp(DEVICE_EXTENSIONS[requested_idx], extensions[extension_idx].extensionName) == 0) {
@@ -165,7 +404,7 @@ static int check_device_extensions(VkPhysicalDevice device) {
         }
     }
 
-    free(extensions);
+    fa_arena_scratch_end(scratch);
 
     int found_all = 1;
     for (int found_idx = 0; found_idx < sizeof(DEVICE_EXTENSIONS) / sizeof(char*); found_idx++) {
@@ -176,12 +415,14 @@ static int check_device_extensions(VkPhysicalDevice device) {
 }
 
 static int check_validation_layers() {
+    FA_ArenaScope scratch = fa_arena_scratch_begin();
     uint32_t layer_count;
     vkEnumerateInstanceLayerProperties(&layer_count, NULL);
-    VkLayerProperties* layers = malloc(layer_count * sizeof(VkLayerProperties));
+    VkLayerProperties* layers = fa_arena_push(scratch.arena, layer_count * sizeof(VkLayerProperties));
     vkEnumerateInstanceLayerProperties(&layer_count, layers);
 
     int found[sizeof(VALIDATION_LAYERS) / sizeof(char*)];
+    memset(found, 0, sizeof(found));
     for (int requested_idx = 0; requested_idx < sizeof(VALIDATION_LAYERS) / sizeof(char*); requested_idx++) {
         for (int layer_idx = 0; layer_idx < layer_count; layer_idx++) {
             if (strcmp(VALIDATION_LAYERS[requested_idx], layers[layer_idx].layerName) == 0) {
@@ -191,7 +432,7 @@ static int check_validation_layers() {
         }
     }
 
-    free(layers);
+    fa_arena_scratch_end(scratch);
 
     int found_all = 1;
     for (int found_idx = 0; found_idx < sizeof(VALIDATION_LAYERS) / sizeof(char*); found_idx++) {
@@ -201,8 +442,505 @@ static int check_validation_layers() {
     return found_all;
 }
 
+static void create_render_pass() {
+    VkAttachmentDescription color_attachment;
+    memset(&color_attachment, 0, sizeof(color_attachment));
+    color_attachment.format = swap_chain_format;
+    color_attachment.samples = VK_SAMPLE_COUNT_1_BIT;
+    color_attachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+    color_attachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+    color_attachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+    color_attachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    color_attachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    // Offscreen images are only ever copied from
+    color_attachment.finalLayout = headless ? VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL : VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+
+    // Kept after the pass for the depth pyramid, see render/vk/cull.h
+    VkAttachmentDescription depth_attachment;
+    memset(&depth_attachment, 0, sizeof(depth_attachment));
+    depth_attachment.format = depth_format;
+    depth_attachment.samples = VK_SAMPLE_COUNT_1_BIT;
+    depth_attachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+    depth_attachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+    depth_attachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+    depth_attachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    depth_attachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    depth_attachment.finalLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+    VkAttachmentDescription attachments[] = { color_attachment, depth_attachment };
+
+    VkAttachmentReference color_attachment_ref;
+    color_attachment_ref.attachment = 0;
+    color_attachment_ref.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+
+    VkAttachmentReference depth_attachment_ref;
+    depth_attachment_ref.attachment = 1;
+    depth_attachment_ref.layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+
+    VkSubpassDescription subpass;
+    memset(&subpass, 0, sizeof(subpass));
+    subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+    subpass.colorAttachmentCount = 1;
+    subpass.pColorAttachments = &color_attachment_ref;
+    subpass.pDepthStencilAttachment = &depth_attachment_ref;
+
+    VkSubpassDependency dependencies[2];
+    memset(dependencies, 0, sizeof(dependencies));
+    // The image is only available once the acquire semaphore is signaled, which is waited for at this stage. The depth
+    // buffer is free once the last frame's pyramid was built from it.
+    dependencies[0].srcSubpass = VK_SUBPASS_EXTERNAL;
+    dependencies[0].dstSubpass = 0;
+    dependencies[0].srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT
+        | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+    dependencies[0].srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    dependencies[0].dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT
+        | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
+    dependencies[0].dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT
+        | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    // The depth pyramid is built from the depth buffer right after the pass
+    dependencies[1].srcSubpass = 0;
+    dependencies[1].dstSubpass = VK_SUBPASS_EXTERNAL;
+    dependencies[1].srcStageMask = VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+    dependencies[1].srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    dependencies[1].dstStageMask = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+    dependencies[1].dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+
+    VkRenderPassCreateInfo create_info;
+    memset(&create_info, 0, sizeof(create_info));
+    create_info.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+    create_info.attachmentCount = 2;
+    create_info.pAttachments = attachments;
+    create_info.subpassCount = 1;
+    create_info.pSubpasses = &subpass;
+    create_info.dependencyCount = 2;
+    create_info.pDependencies = dependencies;
+
+    if (vkCreateRenderPass(device, &create_info, NULL, &render_pass) != VK_SUCCESS) {
+        printf("Failed to create render pass :(\n");
+        exit(1);
+    }
+}
+
+// Job, the hash covers the whole cache, which takes a while and needs no device
+static void load_pipeline_cache_file(void* data) {
+    fa_profile_begin("Load pipeline cache");
+    size_t file_size;
+    const unsigned char* file = _fa_os_map_file(FA_VK_PIPELINE_CACHE_PATH, &file_size);
+    const struct PipelineCacheHeader* header = (const struct PipelineCacheHeader*)file;
+    if (file != NULL && (file_size < sizeof(struct PipelineCacheHeader)
+        || header->magic != PIPELINE_CACHE_MAGIC
+        || header->version != PIPELINE_CACHE_VERSION
+        || header->data_size != file_size - sizeof(struct PipelineCacheHeader)
+        || header->data_hash != fa_util_hash_bytes(file + sizeof(struct PipelineCacheHeader), header->data_size))) {
+        _fa_os_unmap_file(file, file_size);
+        file = NULL;
+    }
+    pipeline_cache_file = file;
+    pipeline_cache_file_size = file_size;
+    fa_profile_end();
+}
+
+static void create_pipeline_cache() {
+    const struct PipelineCacheHeader* header = (const struct PipelineCacheHeader*)pipeline_cache_file;
+
+    VkPipelineCacheCreateInfo create_info;
+    memset(&create_info, 0, sizeof(create_info));
+    create_info.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+    if (pipeline_cache_file != NULL
+        && header->vendor_id == physical_device_properties.vendorID
+        && header->device_id == physical_device_properties.deviceID
+        && header->driver_version == physical_device_properties.driverVersion
+        && memcmp(header->uuid, physical_device_properties.pipelineCacheUUID, VK_UUID_SIZE) == 0) {
+        create_info.initialDataSize = header->data_size;
+        create_info.pInitialData = pipeline_cache_file + sizeof(struct PipelineCacheHeader);
+    }
+
+    // A rejected or missing file only means starting cold
+    if (vkCreatePipelineCache(device, &create_info, NULL, &pipeline_cache) != VK_SUCCESS) {
+        pipeline_cache = VK_NULL_HANDLE;
+    }
+
+    if (pipeline_cache_file != NULL) {
+        _fa_os_unmap_file(pipeline_cache_file, pipeline_cache_file_size);
+        pipeline_cache_file = NULL;
+    }
+}
+
+// Job, overlaps with creating the swapchain and everything else the pipelines do not need
+static void create_shader_modules(void* data) {
+    fa_profile_begin("Create shader modules");
+    create_pipeline_cache();
+    vert_module = _fa_vk_shader_create_module(device, "default.vert");
+    frag_module = _fa_vk_shader_create_module(device, "default.frag");
+    fa_profile_end();
+}
+
+static void save_pipeline_cache() {
+    if (pipeline_cache == VK_NULL_HANDLE) {
+        return;
+    }
+
+    size_t data_size;
+    if (vkGetPipelineCacheData(device, pipeline_cache, &data_size, NULL) == VK_SUCCESS) {
+        unsigned char* file = malloc(sizeof(struct PipelineCacheHeader) + data_size);
+        if (vkGetPipelineCacheData(device, pipeline_cache, &data_size, file + sizeof(struct PipelineCacheHeader))
+            == VK_SUCCESS) {
+            const VkPhysicalDeviceProperties* properties = &physical_device_properties;
+
+            struct PipelineCacheHeader header;
+            memset(&header, 0, sizeof(header));
+            header.magic = PIPELINE_CACHE_MAGIC;
+            header.version = PIPELINE_CACHE_VERSION;
+            header.vendor_id = properties->vendorID;
+            header.device_id = properties->deviceID;
+            header.driver_version = properties->driverVersion;
+            memcpy(header.uuid, properties->pipelineCacheUUID, VK_UUID_SIZE);
+            header.data_size = data_size;
+            header.data_hash = fa_util_hash_bytes(file + sizeof(struct PipelineCacheHeader), data_size);
+            memcpy(file, &header, sizeof(header));
+
+            _fa_os_write_file_atomic(FA_VK_PIPELINE_CACHE_PATH, file, sizeof(struct PipelineCacheHeader) + data_size);
+        }
+        free(file);
+    }
+
+    vkDestroyPipelineCache(device, pipeline_cache, NULL);
+}
+
+// The shader modules come from create_shader_modules, and are destroyed once the pipeline has them
 static void create_graphics_pipeline() {
+    VkPipelineShaderStageCreateInfo stages[2];
+    memset(stages, 0, sizeof(stages));
+    stages[0].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    stages[0].stage = VK_SHADER_STAGE_VERTEX_BIT;
+    stages[0].module = vert_module;
+    stages[0].pName = "main";
+    stages[1].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    stages[1].stage = VK_SHADER_STAGE_FRAGMENT_BIT;
+    stages[1].module = frag_module;
+    stages[1].pName = "main";
+
+    VkPipelineVertexInputStateCreateInfo vertex_input;
+    memset(&vertex_input, 0, sizeof(vertex_input));
+    vertex_input.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+
+    VkPipelineInputAssemblyStateCreateInfo input_assembly;
+    memset(&input_assembly, 0, sizeof(input_assembly));
+    input_assembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+    input_assembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+    input_assembly.primitiveRestartEnable = VK_FALSE;
+
+    // Viewport and scissor are dynamic so the pipeline survives a resize
+    VkPipelineViewportStateCreateInfo viewport_state;
+    memset(&viewport_state, 0, sizeof(viewport_state));
+    viewport_state.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+    viewport_state.viewportCount = 1;
+    viewport_state.scissorCount = 1;
+
+    VkPipelineRasterizationStateCreateInfo rasterizer;
+    memset(&rasterizer, 0, sizeof(rasterizer));
+    rasterizer.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+    rasterizer.depthClampEnable = VK_FALSE;
+    rasterizer.rasterizerDiscardEnable = VK_FALSE;
+    rasterizer.polygonMode = VK_POLYGON_MODE_FILL;
+    rasterizer.lineWidth = 1.0f;
+    rasterizer.cullMode = VK_CULL_MODE_BACK_BIT;
+    rasterizer.frontFace = VK_FRONT_FACE_CLOCKWISE;
+    rasterizer.depthBiasEnable = VK_FALSE;
+
+    VkPipelineMultisampleStateCreateInfo multisampling;
+    memset(&multisampling, 0, sizeof(multisampling));
+    multisampling.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+    multisampling.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+    multisampling.sampleShadingEnable = VK_FALSE;
+
+    VkPipelineDepthStencilStateCreateInfo depth_stencil;
+    memset(&depth_stencil, 0, sizeof(depth_stencil));
+    depth_stencil.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
+    depth_stencil.depthTestEnable = VK_TRUE;
+    depth_stencil.depthWriteEnable = VK_TRUE;
+    depth_stencil.depthCompareOp = VK_COMPARE_OP_LESS;
+
+    VkPipelineColorBlendAttachmentState color_blend_attachment;
+    memset(&color_blend_attachment, 0, sizeof(color_blend_attachment));
+    color_blend_attachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT
+        | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+    color_blend_attachment.blendEnable = VK_FALSE;
+
+    VkPipelineColorBlendStateCreateInfo color_blending;
+    memset(&color_blending, 0, sizeof(color_blending));
+    color_blending.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+    color_blending.logicOpEnable = VK_FALSE;
+    color_blending.attachmentCount = 1;
+    color_blending.pAttachments = &color_blend_attachment;
+
+    VkDynamicState dynamic_states[] = { VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR };
+    VkPipelineDynamicStateCreateInfo dynamic_state;
+    memset(&dynamic_state, 0, sizeof(dynamic_state));
+    dynamic_state.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+    dynamic_state.dynamicStateCount = sizeof(dynamic_states) / sizeof(VkDynamicState);
+    dynamic_state.pDynamicStates = dynamic_states;
+
+    // Set 0 is the bindless set, and draws pick their resources with handles in push constants
+    VkDescriptorSetLayout set_layout = fa_vk_bindless_layout();
+    VkPushConstantRange push_range;
+    memset(&push_range, 0, sizeof(push_range));
+    push_range.stageFlags = VK_SHADER_STAGE_ALL_GRAPHICS;
+    push_range.size = sizeof(FA_VkBindlessHandle);
+
+    VkPipelineLayoutCreateInfo layout_info;
+    memset(&layout_info, 0, sizeof(layout_info));
+    layout_info.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    layout_info.setLayoutCount = 1;
+    layout_info.pSetLayouts = &set_layout;
+    layout_info.pushConstantRangeCount = 1;
+    layout_info.pPushConstantRanges = &push_range;
+
+    if (vkCreatePipelineLayout(device, &layout_info, NULL, &pipeline_layout) != VK_SUCCESS) {
+        printf("Failed to create pipeline layout :(\n");
+        exit(1);
+    }
+
+    VkGraphicsPipelineCreateInfo create_info;
+    memset(&create_info, 0, sizeof(create_info));
+    create_info.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+    create_info.stageCount = 2;
+    create_info.pStages = stages;
+    create_info.pVertexInputState = &vertex_input;
+    create_info.pInputAssemblyState = &input_assembly;
+    create_info.pViewportState = &viewport_state;
+    create_info.pRasterizationState = &rasterizer;
+    create_info.pMultisampleState = &multisampling;
+    create_info.pDepthStencilState = &depth_stencil;
+    create_info.pColorBlendState = &color_blending;
+    create_info.pDynamicState = &dynamic_state;
+    create_info.layout = pipeline_layout;
+    create_info.renderPass = render_pass;
+    create_info.subpass = 0;
+
+    if (vkCreateGraphicsPipelines(device, pipeline_cache, 1, &create_info, NULL, &graphics_pipeline) != VK_SUCCESS) {
+        printf("Failed to create graphics pipeline :(\n");
+        exit(1);
+    }
+
+    vkDestroyShaderModule(device, frag_module, NULL);
+    vkDestroyShaderModule(device, vert_module, NULL);
+    frag_module = VK_NULL_HANDLE;
+    vert_module = VK_NULL_HANDLE;
+}
+
+static void create_framebuffers() {
+    swap_chain_framebuffers = malloc(swap_chain_image_views_len * sizeof(VkFramebuffer));
+
+    for (int image_idx = 0; image_idx < swap_chain_image_views_len; image_idx++) {
+        VkImageView attachments[] = { swap_chain_image_views[image_idx], depth_image_view };
+
+        VkFramebufferCreateInfo create_info;
+        memset(&create_info, 0, sizeof(create_info));
+        create_info.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+        create_info.renderPass = render_pass;
+        create_info.attachmentCount = 2;
+        create_info.pAttachments = attachments;
+        create_info.width = swap_chain_extent.width;
+        create_info.height = swap_chain_extent.height;
+        create_info.layers = 1;
+
+        if (vkCreateFramebuffer(device, &create_info, NULL, &swap_chain_framebuffers[image_idx]) != VK_SUCCESS) {
+            printf("Failed to create framebuffer %d :(\n", image_idx);
+            exit(1);
+        }
+    }
+}
+
+static void create_frame_resources() {
+    frames_in_flight = DEFAULT_FRAMES_IN_FLIGHT;
+    FA_OptionValue frames_value = fa_options_get_hashed(FA_OPTION_NAME_RENDER_FRAMES_IN_FLIGHT);
+    if (frames_value.type == FA_OPTION_INT && frames_value.int_value > 0) {
+        frames_in_flight = frames_value.int_value;
+        if (frames_in_flight > MAX_FRAMES_IN_FLIGHT) {
+            frames_in_flight = MAX_FRAMES_IN_FLIGHT;
+        }
+    } else {
+        fa_options_set_int("render.frames_in_flight", frames_in_flight);
+    }
+    frame_index = 0;
+    frame_serial = 0;
+
+    VkSemaphoreCreateInfo semaphore_info;
+    memset(&semaphore_info, 0, sizeof(semaphore_info));
+    semaphore_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+
+    // Signaled, so the first wait on each frame returns immediately
+    VkFenceCreateInfo fence_info;
+    memset(&fence_info, 0, sizeof(fence_info));
+    fence_info.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+    fence_info.flags = VK_FENCE_CREATE_SIGNALED_BIT;
+
+    for (int frame_idx = 0; frame_idx < frames_in_flight; frame_idx++) {
+        // Reset as a whole every frame instead of per command buffer
+        VkCommandPoolCreateInfo pool_info;
+        memset(&pool_info, 0, sizeof(pool_info));
+        pool_info.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+        pool_info.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+        pool_info.queueFamilyIndex = graphics_family;
+
+        if (vkCreateCommandPool(device, &pool_info, NULL, &frames[frame_idx].command_pool) != VK_SUCCESS) {
+            printf("Failed to create command pool :(\n");
+            exit(1);
+        }
+
+        VkCommandBufferAllocateInfo alloc_info;
+        memset(&alloc_info, 0, sizeof(alloc_info));
+        alloc_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        alloc_info.commandPool = frames[frame_idx].command_pool;
+        alloc_info.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        alloc_info.commandBufferCount = 1;
+
+        if (vkAllocateCommandBuffers(device, &alloc_info, &frames[frame_idx].command_buffer) != VK_SUCCESS) {
+            printf("Failed to allocate command buffer :(\n");
+            exit(1);
+        }
+
+        if (vkCreateSemaphore(device, &semaphore_info, NULL, &frames[frame_idx].image_available) != VK_SUCCESS
+            || vkCreateFence(device, &fence_info, NULL, &frames[frame_idx].in_flight) != VK_SUCCESS) {
+            printf("Failed to create frame synchronization :(\n");
+            exit(1);
+        }
+    }
+
+}
+
+static void create_present_semaphores() {
+    VkSemaphoreCreateInfo semaphore_info;
+    memset(&semaphore_info, 0, sizeof(semaphore_info));
+    semaphore_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+
+    // Indexed by swapchain image, since presentation may hold on to it past the end of the frame that signaled it
+    render_finished_semaphores = malloc(swap_chain_images_len * sizeof(VkSemaphore));
+    for (int image_idx = 0; image_idx < swap_chain_images_len; image_idx++) {
+        if (vkCreateSemaphore(device, &semaphore_info, NULL, &render_finished_semaphores[image_idx]) != VK_SUCCESS) {
+            printf("Failed to create frame synchronization :(\n");
+            exit(1);
+        }
+    }
+}
+
+static void create_material() {
+    VkBufferCreateInfo create_info;
+    memset(&create_info, 0, sizeof(create_info));
+    create_info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    create_info.size = 4 * sizeof(float);
+    create_info.usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+    create_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    if (fa_vk_memory_create_buffer(&create_info, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, 0, &material_buffer,
+                                   &material_allocation) != 0) {
+        printf("Failed to create material buffer :(\n");
+        exit(1);
+    }
+
+    float color[4] = { 1.0f, 0.0f, 0.0f, 1.0f };
+    material_ticket = fa_vk_upload_buffer(material_buffer, 0, color, sizeof(color));
+    material_handle = fa_vk_bindless_add_buffer(material_buffer, 0, VK_WHOLE_SIZE);
+}
+
+static void create_meshes() {
+    uint32_t indices[] = { 0, 1, 2 };
+
+    VkBufferCreateInfo create_info;
+    memset(&create_info, 0, sizeof(create_info));
+    create_info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    create_info.size = sizeof(indices);
+    create_info.usage = VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+    create_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    if (fa_vk_memory_create_buffer(&create_info, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, 0, &mesh_buffer,
+                                   &mesh_allocation) != 0) {
+        printf("Failed to create mesh buffer :(\n");
+        exit(1);
+    }
+
+    mesh_ticket = fa_vk_upload_buffer(mesh_buffer, 0, indices, sizeof(indices));
+    triangle_mesh.index_count = 3;
+    triangle_mesh.first_index = 0;
+    triangle_mesh.vertex_offset = 0;
+}
+
+// Records batches of the main pass, data points at the index of its first batch
+static void record_draws(VkCommandBuffer command_buffer, int first, int count, void* data) {
+    VkViewport viewport;
+    viewport.x = 0.0f;
+    viewport.y = 0.0f;
+    viewport.width = (float)swap_chain_extent.width;
+    viewport.height = (float)swap_chain_extent.height;
+    viewport.minDepth = 0.0f;
+    viewport.maxDepth = 1.0f;
+    vkCmdSetViewport(command_buffer, 0, 1, &viewport);
+
+    VkRect2D scissor;
+    memset(&scissor, 0, sizeof(scissor));
+    scissor.extent = swap_chain_extent;
+    vkCmdSetScissor(command_buffer, 0, 1, &scissor);
+
+    fa_vk_draw_queue_record(command_buffer, *(int*)data + first, count, &mesh_buffer);
+}
+
+// Returns a semaphore the submission has to wait on to see finished uploads, or VK_NULL_HANDLE
+static VkSemaphore record_command_buffer(VkCommandBuffer command_buffer, uint32_t image_index, uint64_t* upload_wait_value) {
+    VkCommandBufferBeginInfo begin_info;
+    memset(&begin_info, 0, sizeof(begin_info));
+    begin_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    begin_info.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+    if (vkBeginCommandBuffer(command_buffer, &begin_info) != VK_SUCCESS) {
+        printf("Failed to begin command buffer :(\n");
+        exit(1);
+    }
+
+    VkSemaphore upload_semaphore = _fa_vk_upload_acquire(command_buffer, upload_wait_value);
+    _fa_vk_profile_begin_frame(command_buffer, frame_index);
+
+    fa_vk_profile_begin(command_buffer, "Cull");
+    _fa_vk_cull_record(command_buffer);
+    fa_vk_profile_end(command_buffer);
+
+    VkClearValue clear_values[2];
+    memset(clear_values, 0, sizeof(clear_values));
+    clear_values[1].depthStencil.depth = 1.0f;
+
+    VkRenderPassBeginInfo render_pass_info;
+    memset(&render_pass_info, 0, sizeof(render_pass_info));
+    render_pass_info.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+    render_pass_info.renderPass = render_pass;
+    render_pass_info.framebuffer = swap_chain_framebuffers[image_index];
+    render_pass_info.renderArea.extent = swap_chain_extent;
+    render_pass_info.clearValueCount = 2;
+    render_pass_info.pClearValues = clear_values;
+
+    fa_vk_profile_begin(command_buffer, "Main pass");
+    vkCmdBeginRenderPass(command_buffer, &render_pass_info, VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
+
+    VkCommandBufferInheritanceInfo inheritance;
+    memset(&inheritance, 0, sizeof(inheritance));
+    inheritance.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+    inheritance.renderPass = render_pass;
+    inheritance.subpass = 0;
+    inheritance.framebuffer = swap_chain_framebuffers[image_index];
+    int first_batch;
+    int batch_count = fa_vk_draw_queue_pass_batches(FA_VK_PASS_MAIN, &first_batch);
+    fa_vk_record_parallel(command_buffer, &inheritance, batch_count, record_draws, &first_batch);
+
+    vkCmdEndRenderPass(command_buffer);
+    fa_vk_profile_end(command_buffer);
+
+    fa_vk_profile_begin(command_buffer, "Depth pyramid");
+    _fa_vk_cull_build_depth_pyramid(command_buffer);
+    fa_vk_profile_end(command_buffer);
+
+    if (vkEndCommandBuffer(command_buffer) != VK_SUCCESS) {
+        printf("Failed to record command buffer :(\n");
+        exit(1);
+    }
 
+    return upload_semaphore;
 }
 
 static void create_image_views() {
@@ -233,14 +971,29 @@ static void create_image_views() {
     }
 }
 
-static void create_swap_chain() {
-    struct SwapChainSupportDetails details = query_swap_chain_support(physical_device);
+static void create_swap_chain(VkSwapchainKHR old_swap_chain) {
+    struct SwapChainSupportDetails details;
+    vkGetPhysicalDeviceSurfaceCapabilitiesKHR(physical_device, surface, &details.capabilities);
+    details.formats = surface_formats;
+    details.formats_len = surface_formats_len;
+    details.present_modes = surface_present_modes;
+    details.modes_len = surface_present_modes_len;
 
     VkSurfaceFormatKHR format = choose_swap_surface_format(&details);
     VkPresentModeKHR mode = choose_swap_present_mode(&details);
     VkExtent2D extent = choose_swap_extent(&details);
 
+    // One more than the minimum, so there is always an image to acquire while the others are queued for display
     uint32_t image_count = details.capabilities.minImageCount + 1;
+    FA_OptionValue images_value = fa_options_get_hashed(FA_OPTION_NAME_RENDER_SWAPCHAIN_IMAGES);
+    if (images_value.type == FA_OPTION_INT && images_value.int_value > 0) {
+        image_count = images_value.int_value;
+    } else if (images_value.type != FA_OPTION_INT) {
+        fa_options_set_int("render.swapchain_images", 0);
+    }
+    if (image_count < details.capabilities.minImageCount) {
+        image_count = details.capabilities.minImageCount;
+    }
     if (details.capabilities.maxImageCount > 0 && image_count > details.capabilities.maxImageCount) {
         image_count = details.capabilities.maxImageCount;
     }
@@ -256,9 +1009,8 @@ static void create_swap_chain() {
     create_info.imageArrayLayers = 1;
     create_info.imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
 
-    struct QueueFamilyIndices qfi = find_queue_families(physical_device);
-    uint32_t queue_indices[] = { qfi.graphics_family, qfi.present_family };
-    if (qfi.graphics_family != qfi.present_family) {
+    uint32_t queue_indices[] = { queue_families.graphics_family, queue_families.present_family };
+    if (queue_families.graphics_family != queue_families.present_family) {
         create_info.imageSharingMode = VK_SHARING_MODE_CONCURRENT;
         create_info.queueFamilyIndexCount = 2;
         create_info.pQueueFamilyIndices = queue_indices;
@@ -272,60 +1024,184 @@ static void create_swap_chain() {
     create_info.compositeAlpha = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR;
     create_info.presentMode = mode;
     create_info.clipped = VK_TRUE;
-    create_info.oldSwapchain = VK_NULL_HANDLE;
+    // Lets the driver hand resources over from the swapchain being replaced, if there is one
+    create_info.oldSwapchain = old_swap_chain;
 
     if (vkCreateSwapchainKHR(device, &create_info, NULL, &swap_chain) != VK_SUCCESS) {
         printf("Failed to create swap chain :(\n");
         exit(1);
     }
 
-    free(details.formats);
-    free(details.present_modes);
-
     vkGetSwapchainImagesKHR(device, swap_chain, &image_count, NULL);
     swap_chain_images = malloc(image_count * sizeof(VkImage));
     vkGetSwapchainImagesKHR(device, swap_chain, &image_count, swap_chain_images);
+    swap_chain_images_len = image_count;
 
     swap_chain_format = format.format;
     swap_chain_extent = extent;
 }
 
-static void create_logical_device() {
-    struct QueueFamilyIndices qfi = find_queue_families(physical_device);
+static void create_offscreen_images() {
+    VkExtent2D extent;
+    FA_OptionValue width_value = fa_options_get_hashed(FA_OPTION_NAME_WINDOW_WIDTH);
+    FA_OptionValue height_value = fa_options_get_hashed(FA_OPTION_NAME_WINDOW_HEIGHT);
+    extent.width = width_value.type == FA_OPTION_INT ? width_value.int_value : 0;
+    extent.height = height_value.type == FA_OPTION_INT ? height_value.int_value : 0;
+    if (extent.width == 0 || extent.height == 0) {
+        printf("No size to render offscreen at :(\n");
+        exit(1);
+    }
 
-    int n_queues = 2;
-    if (qfi.graphics_family == qfi.present_family) {
-        // TODO use a set
-        n_queues = 1;
+    // One image per frame slot, so waiting on the slot's fence also frees its image
+    swap_chain_images_len = frames_in_flight;
+    swap_chain_images = malloc(swap_chain_images_len * sizeof(VkImage));
+    swap_chain_format = VK_FORMAT_B8G8R8A8_SRGB;
+    swap_chain_extent = extent;
+    _fa_vk_offscreen_create(device, swap_chain_format, swap_chain_extent, swap_chain_images_len, swap_chain_images);
+}
+
+static VkFormat choose_depth_format() {
+    // Sampled too, for the depth pyramid
+    VkFormat candidates[] = { VK_FORMAT_D32_SFLOAT, VK_FORMAT_D16_UNORM };
+    VkFormatFeatureFlags wanted = VK_FORMAT_FEATURE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT;
+    for (int format_idx = 0; format_idx < sizeof(candidates) / sizeof(VkFormat); format_idx++) {
+        VkFormatProperties properties;
+        vkGetPhysicalDeviceFormatProperties(physical_device, candidates[format_idx], &properties);
+        if ((properties.optimalTilingFeatures & wanted) == wanted) {
+            return candidates[format_idx];
+        }
+    }
+
+    printf("No depth format to draw with :(\n");
+    exit(1);
+}
+
+static void create_depth_image() {
+    VkImageCreateInfo create_info;
+    memset(&create_info, 0, sizeof(create_info));
+    create_info.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    create_info.imageType = VK_IMAGE_TYPE_2D;
+    create_info.format = depth_format;
+    create_info.extent.width = swap_chain_extent.width;
+    create_info.extent.height = swap_chain_extent.height;
+    create_info.extent.depth = 1;
+    create_info.mipLevels = 1;
+    create_info.arrayLayers = 1;
+    create_info.samples = VK_SAMPLE_COUNT_1_BIT;
+    create_info.tiling = VK_IMAGE_TILING_OPTIMAL;
+    create_info.usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+    create_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    create_info.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    if (fa_vk_memory_create_image(&create_info, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, &depth_image,
+                                  &depth_allocation) != 0) {
+        printf("Failed to create depth image :(\n");
+        exit(1);
     }
-    VkDeviceQueueCreateInfo* queue_create_infos = malloc(n_queues * sizeof(VkDeviceQueueCreateInfo));
 
-    float queue_priority = 1.0f;
+    VkImageViewCreateInfo view_info;
+    memset(&view_info, 0, sizeof(view_info));
+    view_info.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+    view_info.image = depth_image;
+    view_info.viewType = VK_IMAGE_VIEW_TYPE_2D;
+    view_info.format = depth_format;
+    view_info.subresourceRange.aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT;
+    view_info.subresourceRange.levelCount = 1;
+    view_info.subresourceRange.layerCount = 1;
+    if (vkCreateImageView(device, &view_info, NULL, &depth_image_view) != VK_SUCCESS) {
+        printf("Failed to create depth image view :(\n");
+        exit(1);
+    }
+}
+
+static void read_back_last_frame() {
+    FA_OptionValue path_value = fa_options_get_hashed(FA_OPTION_NAME_RENDER_READBACK_PATH);
+    if (path_value.type != FA_OPTION_STRING || frame_serial == 0) {
+        return;
+    }
+    const char* path = fa_options_string(&path_value);
+    if (path[0] == '\0') {
+        return;
+    }
+
+    _fa_vk_offscreen_readback(graphics_queue, frames[0].command_pool, image_index, path);
+}
+
+static void create_logical_device() {
+    struct QueueFamilyIndices qfi = queue_families;
+
+    // Enough queues from each distinct family for the highest queue index used in it
+    uint32_t families[] = { qfi.graphics_family, qfi.present_family, qfi.transfer_family, qfi.compute_family };
+    uint32_t queue_indices[] = { 0, 0, 0, qfi.compute_queue_index };
+    uint32_t unique_families[sizeof(families) / sizeof(uint32_t)];
+    uint32_t unique_queue_counts[sizeof(families) / sizeof(uint32_t)];
+    int n_queues = 0;
+    for (int family_idx = 0; family_idx < sizeof(families) / sizeof(uint32_t); family_idx++) {
+        int unique_idx = 0;
+        while (unique_idx < n_queues && unique_families[unique_idx] != families[family_idx]) {
+            unique_idx++;
+        }
+        if (unique_idx == n_queues) {
+            unique_families[n_queues] = families[family_idx];
+            unique_queue_counts[n_queues] = 0;
+            n_queues++;
+        }
+        if (queue_indices[family_idx] + 1 > unique_queue_counts[unique_idx]) {
+            unique_queue_counts[unique_idx] = queue_indices[family_idx] + 1;
+        }
+    }
+    FA_ArenaScope scratch = fa_arena_scratch_begin();
+    VkDeviceQueueCreateInfo* queue_create_infos = fa_arena_push(scratch.arena, n_queues * sizeof(VkDeviceQueueCreateInfo));
+
+    float queue_priorities[] = { 1.0f, 1.0f };
     for (int queue_idx = 0; queue_idx < n_queues; queue_idx++) {
         memset(&queue_create_infos[queue_idx], 0, sizeof(VkDeviceQueueCreateInfo));
         queue_create_infos[queue_idx].sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
-        // TODO TODOTODOTODOTODOTODO
-        if (queue_idx == 0) {
-            queue_create_infos[queue_idx].queueFamilyIndex = qfi.graphics_family;
-        } else {
-            queue_create_infos[queue_idx].queueFamilyIndex = qfi.present_family;
-        }
-        queue_create_infos[queue_idx].queueCount = 1;
-        queue_create_infos[queue_idx].pQueuePriorities = &queue_priority;
+        queue_create_infos[queue_idx].queueFamilyIndex = unique_families[queue_idx];
+        queue_create_infos[queue_idx].queueCount = unique_queue_counts[queue_idx];
+        queue_create_infos[queue_idx].pQueuePriorities = queue_priorities;
     }
 
     VkPhysicalDeviceFeatures device_features;
     memset(&device_features, 0, sizeof(device_features));
 
+    // Uploads track completion with a timeline semaphore
+    VkPhysicalDeviceVulkan12Features vulkan12_features;
+    memset(&vulkan12_features, 0, sizeof(vulkan12_features));
+    vulkan12_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+    vulkan12_features.timelineSemaphore = VK_TRUE;
+    _fa_vk_bindless_enable_features(&device_features, &vulkan12_features);
+
+    VkPhysicalDeviceVulkan12Features supported_vulkan12;
+    memset(&supported_vulkan12, 0, sizeof(supported_vulkan12));
+    supported_vulkan12.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+    VkPhysicalDeviceFeatures2 supported;
+    memset(&supported, 0, sizeof(supported));
+    supported.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+    supported.pNext = &supported_vulkan12;
+    vkGetPhysicalDeviceFeatures2(physical_device, &supported);
+    _fa_vk_draw_queue_enable_features(&supported.features, &supported_vulkan12, &device_features, &vulkan12_features);
+
     VkDeviceCreateInfo create_info;
     memset(&create_info, 0, sizeof(create_info));
     create_info.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+    create_info.pNext = &vulkan12_features;
     create_info.pQueueCreateInfos = queue_create_infos;
     create_info.queueCreateInfoCount = n_queues;
     create_info.pEnabledFeatures = &device_features;
-    create_info.enabledExtensionCount = sizeof(DEVICE_EXTENSIONS) / sizeof(char*);
-    create_info.ppEnabledExtensionNames = DEVICE_EXTENSIONS;
-    if (check_validation_layers()) {
+    // The required extensions, then the optional ones the device has. Headless needs none of the required ones.
+    const char* extensions[sizeof(DEVICE_EXTENSIONS) / sizeof(char*) + 1];
+    int extensions_len = 0;
+    for (int extension_idx = 0; headless == 0 && extension_idx < sizeof(DEVICE_EXTENSIONS) / sizeof(char*);
+         extension_idx++) {
+        extensions[extensions_len++] = DEVICE_EXTENSIONS[extension_idx];
+    }
+    calibrated_timestamps = _fa_vk_profile_calibration_supported(instance, physical_device);
+    if (calibrated_timestamps) {
+        extensions[extensions_len++] = VK_EXT_CALIBRATED_TIMESTAMPS_EXTENSION_NAME;
+    }
+    create_info.enabledExtensionCount = extensions_len;
+    create_info.ppEnabledExtensionNames = extensions;
+    if (validation) {
         create_info.enabledLayerCount = sizeof(VALIDATION_LAYERS) / sizeof(char*);
         create_info.ppEnabledLayerNames = VALIDATION_LAYERS;
     } else {
@@ -337,85 +1213,116 @@ static void create_logical_device() {
         exit(1);
     }
 
-    free(queue_create_infos);
+    fa_arena_scratch_end(scratch);
 
+    graphics_family = qfi.graphics_family;
+    transfer_family = qfi.transfer_family;
+    compute_family = qfi.compute_family;
     vkGetDeviceQueue(device, qfi.graphics_family, 0, &graphics_queue);
     vkGetDeviceQueue(device, qfi.present_family, 0, &present_queue);
+    vkGetDeviceQueue(device, qfi.transfer_family, 0, &transfer_queue);
+    vkGetDeviceQueue(device, qfi.compute_family, qfi.compute_queue_index, &compute_queue);
 }
 
-static void pick_physical_device() {
-    uint32_t device_count = 0;
-    vkEnumeratePhysicalDevices(instance, &device_count, NULL);
+// Job, everything about one device which does not need the surface
+static void query_device(void* data) {
+    fa_profile_begin("Query device");
+    struct DeviceCandidate* candidate = data;
+    candidate->suitable = 0;
+    vkGetPhysicalDeviceProperties(candidate->device, &candidate->properties);
+    candidate->qfi = find_queue_families(candidate->device);
+
+    VkPhysicalDeviceVulkan12Features vulkan12_features;
+    memset(&vulkan12_features, 0, sizeof(vulkan12_features));
+    vulkan12_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+    VkPhysicalDeviceFeatures2 features2;
+    memset(&features2, 0, sizeof(features2));
+    features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+    features2.pNext = &vulkan12_features;
+    vkGetPhysicalDeviceFeatures2(candidate->device, &features2);
+
+    if (candidate->qfi.found_graphics_family
+        && (headless || check_device_extensions(candidate->device))
+        && vulkan12_features.timelineSemaphore == VK_TRUE
+        && _fa_vk_bindless_supported(&features2.features, &vulkan12_features)
+        && _fa_vk_draw_queue_supported(&features2.features)) {
+        // TODO replace with manual selector
+        candidate->score = 0;
+        if (candidate->properties.deviceType == VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU) {
+            candidate->score += 5000;
+        }
+        candidate->score += candidate->properties.limits.maxComputeSharedMemorySize;
+        candidate->suitable = 1;
+    }
+    fa_profile_end();
+}
 
-    if (device_count == 0) {
+// Finishes what query_device started now that there is a surface, and keeps what the rest of startup needs
+static void pick_physical_device() {
+    if (device_candidates_len == 0) {
         printf("No physical device with Vulkan support :(\n");
         exit(1);
     }
 
-    VkPhysicalDevice* devices = malloc(device_count * sizeof(VkPhysicalDevice));
-    vkEnumeratePhysicalDevices(instance, &device_count, devices);
-
-    VkPhysicalDevice best_device;
-    int best_device_score = -1;
-    for (int device_idx = 0; device_idx < device_count; device_idx++) {
-        // TODO replace with manual selector
-        int device_score = 0;
-        
-        VkPhysicalDeviceProperties device_properties;
-        VkPhysicalDeviceFeatures device_features;
-        vkGetPhysicalDeviceProperties(devices[device_idx], &device_properties);
-        vkGetPhysicalDeviceFeatures(devices[device_idx], &device_features);
-
-        struct QueueFamilyIndices qfi = find_queue_families(devices[device_idx]);
-        if (qfi.found_graphics_family == 0
-            || qfi.found_present_family == 0) {
+    int best_idx = -1;
+    for (int candidate_idx = 0; candidate_idx < device_candidates_len; candidate_idx++) {
+        struct DeviceCandidate* candidate = &device_candidates[candidate_idx];
+        if (candidate->suitable == 0 || (best_idx >= 0 && candidate->score <= device_candidates[best_idx].score)) {
             continue;
         }
 
-        if (check_device_extensions(devices[device_idx]) == 0) {
+        find_present_family(candidate->device, &candidate->qfi);
+        if (candidate->qfi.found_present_family == 0) {
             continue;
         }
 
-        struct SwapChainSupportDetails swap_chain_details = query_swap_chain_support(devices[device_idx]);
-        free(swap_chain_details.formats);
-        free(swap_chain_details.present_modes);
-        if (swap_chain_details.formats_len == 0 || swap_chain_details.modes_len == 0) {
-            continue;
-        }
+        if (headless == 0) {
+            FA_ArenaScope scratch = fa_arena_scratch_begin();
+            struct SwapChainSupportDetails details = query_swap_chain_support(candidate->device, scratch.arena);
+            if (details.formats_len == 0 || details.modes_len == 0) {
+                fa_arena_scratch_end(scratch);
+                continue;
+            }
 
-        if (device_properties.deviceType == VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU) {
-            device_score += 5000;
+            free(surface_formats);
+            free(surface_present_modes);
+            surface_formats = malloc(details.formats_len * sizeof(VkSurfaceFormatKHR));
+            memcpy(surface_formats, details.formats, details.formats_len * sizeof(VkSurfaceFormatKHR));
+            surface_formats_len = details.formats_len;
+            surface_present_modes = malloc(details.modes_len * sizeof(VkPresentModeKHR));
+            memcpy(surface_present_modes, details.present_modes, details.modes_len * sizeof(VkPresentModeKHR));
+            surface_present_modes_len = details.modes_len;
+            fa_arena_scratch_end(scratch);
         }
-        device_score += device_properties.limits.maxComputeSharedMemorySize;
 
-        if (device_score > best_device_score) {
-            best_device_score = device_score;
-            best_device = devices[device_idx];
-        }
+        best_idx = candidate_idx;
     }
 
-    free(devices);
-
-    if (best_device_score < 0) {
+    if (best_idx < 0) {
         printf("No physical device was suitable :(\n");
         exit(1);
     }
 
-    physical_device = best_device;
+    physical_device = device_candidates[best_idx].device;
+    physical_device_properties = device_candidates[best_idx].properties;
+    queue_families = device_candidates[best_idx].qfi;
+    free(device_candidates);
+    device_candidates = NULL;
+    device_candidates_len = 0;
 }
 
 static void create_instance() {
     VkApplicationInfo app_info;
     memset(&app_info, 0, sizeof(app_info));
     app_info.sType = VK_STRUCTURE_TYPE_APPLICATION_INFO;
-    FA_OptionValue app_name_value = fa_options_get("app.name");
+    FA_OptionValue app_name_value = fa_options_get_hashed(FA_OPTION_NAME_APP_NAME);
     if (app_name_value.type == FA_OPTION_STRING) {
-        app_info.pApplicationName = app_name_value.string_value;
+        app_info.pApplicationName = fa_options_string(&app_name_value);
     } else {
         fa_options_set_string("app.name", "Unknown Application");
         app_info.pApplicationName = "Unknown Application";
     }
-    FA_OptionValue app_vers_value = fa_options_get("app.version");
+    FA_OptionValue app_vers_value = fa_options_get_hashed(FA_OPTION_NAME_APP_VERSION);
     if (app_vers_value.type == FA_OPTION_INT) {
         app_info.applicationVersion = app_vers_value.int_value;
     } else {
@@ -426,9 +1333,12 @@ static void create_instance() {
     app_info.engineVersion = VK_MAKE_VERSION(0, 0, 1);
     app_info.apiVersion = VK_API_VERSION_1_3;
 
-    unsigned int glfw_ext_count;
-    const char** glfw_extensions;
-    glfw_extensions = glfwGetRequiredInstanceExtensions(&glfw_ext_count);
+    // Offscreen rendering needs no surface, and so no window system extensions
+    unsigned int glfw_ext_count = 0;
+    const char** glfw_extensions = NULL;
+    if (headless == 0) {
+        glfw_extensions = glfwGetRequiredInstanceExtensions(&glfw_ext_count);
+    }
 
     VkInstanceCreateInfo create_info;
     memset(&create_info, 0, sizeof(create_info));
@@ -436,7 +1346,7 @@ static void create_instance() {
     create_info.pApplicationInfo = &app_info;
     create_info.enabledExtensionCount = glfw_ext_count;
     create_info.ppEnabledExtensionNames = glfw_extensions;
-    if (check_validation_layers()) {
+    if (validation) {
         create_info.enabledLayerCount = 1;
         create_info.ppEnabledLayerNames = VALIDATION_LAYERS;
     } else {
@@ -448,28 +1358,435 @@ static void create_instance() {
         printf("Failed to create Vulkan instance :(\n");
         exit(1);
     }
+}
+
+// Job, and the devices are queried by jobs of their own as soon as there is an instance to list them with
+static void create_instance_and_query_devices(void* data) {
+    fa_profile_begin("Create instance");
+    create_instance();
+    fa_profile_end();
+
+    vkEnumeratePhysicalDevices(instance, &device_candidates_len, NULL);
+    device_candidates = calloc(device_candidates_len, sizeof(struct DeviceCandidate));
+    VkPhysicalDevice* devices = malloc(device_candidates_len * sizeof(VkPhysicalDevice));
+    vkEnumeratePhysicalDevices(instance, &device_candidates_len, devices);
+    for (int candidate_idx = 0; candidate_idx < device_candidates_len; candidate_idx++) {
+        device_candidates[candidate_idx].device = devices[candidate_idx];
+        fa_jobs_run(query_device, &device_candidates[candidate_idx], &startup_jobs);
+    }
+    free(devices);
+}
 
-    if (glfwCreateWindowSurface(instance, _fa_display_get_handle(), NULL, &surface) != VK_SUCCESS) {
+// Needs the instance and the window, so it waits for both on the main thread
+static void create_surface() {
+    surface = VK_NULL_HANDLE;
+    if (headless == 0 && glfwCreateWindowSurface(instance, _fa_display_get_handle(), NULL, &surface) != VK_SUCCESS) {
         printf("Failed to create surface :(\n");
         exit(1);
     }
 }
 
+// Take the current swapchain and everything created from it out of the globals
+static struct RetiredSwapChain take_swap_chain() {
+    struct RetiredSwapChain taken;
+    taken.swap_chain = swap_chain;
+    taken.images = swap_chain_images;
+    taken.image_views = swap_chain_image_views;
+    taken.framebuffers = swap_chain_framebuffers;
+    taken.render_finished_semaphores = render_finished_semaphores;
+    taken.images_len = swap_chain_images_len;
+    taken.depth_image = depth_image;
+    taken.depth_allocation = depth_allocation;
+    taken.depth_image_view = depth_image_view;
+    taken.frame_serial = frame_serial;
+
+    swap_chain = VK_NULL_HANDLE;
+    swap_chain_images = NULL;
+    swap_chain_image_views = NULL;
+    swap_chain_framebuffers = NULL;
+    render_finished_semaphores = NULL;
+    swap_chain_images_len = 0;
+    swap_chain_image_views_len = 0;
+    depth_image = VK_NULL_HANDLE;
+    memset(&depth_allocation, 0, sizeof(depth_allocation));
+    depth_image_view = VK_NULL_HANDLE;
+    return taken;
+}
+
+static void destroy_swap_chain(struct RetiredSwapChain* retired) {
+    for (int image_idx = 0; image_idx < retired->images_len; image_idx++) {
+        if (retired->render_finished_semaphores != NULL) {
+            vkDestroySemaphore(device, retired->render_finished_semaphores[image_idx], NULL);
+        }
+        vkDestroyFramebuffer(device, retired->framebuffers[image_idx], NULL);
+        vkDestroyImageView(device, retired->image_views[image_idx], NULL);
+    }
+    free(retired->render_finished_semaphores);
+    free(retired->framebuffers);
+    free(retired->image_views);
+    free(retired->images);
+    vkDestroyImageView(device, retired->depth_image_view, NULL);
+    fa_vk_memory_destroy_image(retired->depth_image, &retired->depth_allocation);
+    // Offscreen images have no swapchain, and the extension isn't even enabled
+    if (retired->swap_chain != VK_NULL_HANDLE) {
+        vkDestroySwapchainKHR(device, retired->swap_chain, NULL);
+    }
+}
+
+/*
+ * Destroy retired swapchains once the last frame which could have used them finished. Called after waiting for the
+ * frame slot about to be reused, at which point every frame but the last frames_in_flight has finished.
+ */
+static void destroy_finished_swap_chains() {
+    int kept = 0;
+    for (int retired_idx = 0; retired_idx < retired_swap_chains_len; retired_idx++) {
+        if (retired_swap_chains[retired_idx].frame_serial + frames_in_flight <= frame_serial) {
+            destroy_swap_chain(&retired_swap_chains[retired_idx]);
+        } else {
+            retired_swap_chains[kept++] = retired_swap_chains[retired_idx];
+        }
+    }
+    retired_swap_chains_len = kept;
+}
+
+static int recreate_swap_chain() {
+    int width;
+    int height;
+    glfwGetFramebufferSize(_fa_display_get_handle(), &width, &height);
+    if (width == 0 || height == 0) {
+        // Minimized, there is nothing to present to
+        return 1;
+    }
+
+    if (retired_swap_chains_len == MAX_RETIRED_SWAP_CHAINS) {
+        // Resized faster than frames finish, wait for the frames instead of the whole device
+        VkFence fences[MAX_FRAMES_IN_FLIGHT];
+        for (int frame_idx = 0; frame_idx < frames_in_flight; frame_idx++) {
+            fences[frame_idx] = frames[frame_idx].in_flight;
+        }
+        vkWaitForFences(device, frames_in_flight, fences, VK_TRUE, UINT64_MAX);
+        for (int retired_idx = 0; retired_idx < retired_swap_chains_len; retired_idx++) {
+            destroy_swap_chain(&retired_swap_chains[retired_idx]);
+        }
+        retired_swap_chains_len = 0;
+    }
+
+    struct RetiredSwapChain old = take_swap_chain();
+    retired_swap_chains[retired_swap_chains_len++] = old;
+
+    VkFormat old_format = swap_chain_format;
+    create_swap_chain(old.swap_chain);
+    if (swap_chain_format != old_format) {
+        printf("Swap chain format changed :(\n");
+        exit(1);
+    }
+    create_image_views();
+    create_depth_image();
+    _fa_vk_cull_set_depth(depth_image_view, swap_chain_extent);
+    create_framebuffers();
+    create_present_semaphores();
+
+    swap_chain_dirty = 0;
+    return 0;
+}
+
+static void on_swap_chain_option_changed(void* user_data) {
+    swap_chain_dirty = 1;
+}
+
+void _fa_vk_init_begin() {
+    headless = _fa_display_headless();
+
+    // The layers slow everything down, so they are only for debugging
+    validation = 0;
+    FA_OptionValue validation_value = fa_options_get_hashed(FA_OPTION_NAME_RENDER_VALIDATION);
+    if (validation_value.type != FA_OPTION_INT) {
+        fa_options_set_int("render.validation", 0);
+    } else if (validation_value.int_value != 0) {
+        validation = check_validation_layers();
+        if (validation == 0) {
+            printf("Validation layers are not installed, running without them :(\n");
+        }
+    }
+
+    startup_begun = 1;
+    fa_jobs_run(create_instance_and_query_devices, NULL, &startup_jobs);
+    fa_jobs_run(load_pipeline_cache_file, NULL, &startup_jobs);
+}
+
 void _fa_vk_init() {
-    create_instance();
+    // Timed as zones of the first profiler frame, which is how fa_bench measures startup. Zones of jobs are timed on
+    // the workers, so the phases add up to more than the whole.
+    if (startup_begun == 0) {
+        _fa_vk_init_begin();
+    }
+    fa_profile_begin("Wait for startup jobs");
+    fa_jobs_wait(&startup_jobs);
+    fa_profile_end();
+    startup_begun = 0;
+    create_surface();
+    fa_profile_begin("Pick physical device");
     pick_physical_device();
+    fa_profile_end();
+    fa_profile_begin("Create logical device");
     create_logical_device();
-    create_swap_chain();
+    fa_profile_end();
+    fa_jobs_run(create_shader_modules, NULL, &startup_jobs);
+    _fa_vk_memory_init(physical_device, device);
+    _fa_vk_upload_init(device, transfer_family, transfer_queue, graphics_family);
+    create_frame_resources();
+    _fa_vk_compute_init(device, compute_family, compute_queue, graphics_family, frames_in_flight);
+    _fa_vk_bindless_init(physical_device, device, frames_in_flight);
+    _fa_vk_stream_init(device, frames_in_flight);
+    create_material();
+    create_meshes();
+    _fa_vk_draw_queue_init(physical_device, device, frames_in_flight);
+    fa_profile_begin("Create swap chain");
+    if (headless) {
+        create_offscreen_images();
+    } else {
+        create_swap_chain(VK_NULL_HANDLE);
+    }
     create_image_views();
+    depth_format = choose_depth_format();
+    create_depth_image();
+    fa_profile_end();
+    create_render_pass();
+    fa_profile_begin("Create pipelines");
+    fa_jobs_wait(&startup_jobs);
     create_graphics_pipeline();
+    _fa_vk_cull_init(device, pipeline_cache, frames_in_flight);
+    fa_profile_end();
+    _fa_vk_cull_set_depth(depth_image_view, swap_chain_extent);
+    default_pipeline_id = fa_vk_draw_queue_add_pipeline(graphics_pipeline, pipeline_layout);
+    create_framebuffers();
+    _fa_vk_record_init(device, graphics_family, frames_in_flight);
+    _fa_vk_profile_init(physical_device, device, graphics_family, frames_in_flight, calibrated_timestamps);
+
+    if (headless) {
+        return;
+    }
+    create_present_semaphores();
+    fa_options_subscribe(fa_options_register_hashed(FA_OPTION_NAME_RENDER_PRESENT_MODE), on_swap_chain_option_changed,
+                         NULL);
+    fa_options_subscribe(fa_options_register_hashed(FA_OPTION_NAME_RENDER_SWAPCHAIN_IMAGES),
+                         on_swap_chain_option_changed, NULL);
+}
+
+int _fa_vk_begin_frame() {
+    struct FrameResources* frame = &frames[frame_index];
+    fa_profile_begin("Wait for GPU");
+    vkWaitForFences(device, 1, &frame->in_flight, VK_TRUE, UINT64_MAX);
+    fa_profile_end();
+    _fa_vk_bindless_begin_frame(frame_serial);
+    _fa_vk_draw_queue_begin_frame(frame_index);
+    _fa_vk_cull_begin_frame(frame_index);
+    _fa_vk_stream_begin_frame(frame_serial);
+    _fa_vk_compute_begin_frame(frame_index);
+
+    if (headless) {
+        // The image belongs to this frame slot, so it is free as soon as the fence is
+        image_index = frame_index;
+        image_acquired = 1;
+        return 1;
+    }
+
+    destroy_finished_swap_chains();
+
+    if (_fa_display_take_resized()) {
+        swap_chain_dirty = 1;
+    }
+    if (swap_chain_dirty && recreate_swap_chain() != 0) {
+        return 0;
+    }
+
+    fa_profile_begin("Acquire image");
+    VkResult result = vkAcquireNextImageKHR(device, swap_chain, UINT64_MAX, frame->image_available, VK_NULL_HANDLE,
+                                            &image_index);
+    fa_profile_end();
+    if (result == VK_ERROR_OUT_OF_DATE_KHR) {
+        // Nothing to draw to until the swapchain is rebuilt, which happens next frame
+        swap_chain_dirty = 1;
+        return 0;
+    } else if (result == VK_SUBOPTIMAL_KHR) {
+        // Still presentable, so draw this frame and rebuild for the next one
+        swap_chain_dirty = 1;
+    } else if (result != VK_SUCCESS) {
+        printf("Failed to acquire swap chain image :(\n");
+        exit(1);
+    }
+
+    image_acquired = 1;
+    return 1;
+}
+
+void _fa_vk_draw_frame() {
+    if (image_acquired == 0) {
+        return;
+    }
+    image_acquired = 0;
+    struct FrameResources* frame = &frames[frame_index];
+
+    // Only reset once work is guaranteed to be submitted, or the next wait on this fence would never return
+    vkResetFences(device, 1, &frame->in_flight);
+    vkResetCommandPool(device, frame->command_pool, 0);
+    _fa_vk_record_begin_frame(frame_index);
+    uint64_t upload_wait_value;
+    fa_profile_begin("Record");
+    // Stands in for the scene until there is one, and only once the graphics queue owns its buffers
+    if (fa_vk_upload_ready(material_ticket) && fa_vk_upload_ready(mesh_ticket)) {
+        FA_VkDraw triangle;
+        triangle.key = fa_vk_draw_key(FA_VK_PASS_MAIN, default_pipeline_id, material_handle, 0.0f);
+        triangle.mesh = triangle_mesh;
+        triangle.instance = material_handle;
+        // With the default view, the triangle's clip space positions are its world positions
+        triangle.bounds[0] = 0.0f;
+        triangle.bounds[1] = 0.0f;
+        triangle.bounds[2] = 0.0f;
+        triangle.bounds[3] = 0.75f;
+        fa_vk_draw_queue_submit(&triangle);
+    }
+    _fa_vk_draw_queue_build();
+    VkSemaphore upload_semaphore = record_command_buffer(frame->command_buffer, image_index, &upload_wait_value);
+    fa_profile_end();
+
+    VkSemaphore wait_semaphores[3];
+    VkPipelineStageFlags wait_stages[3];
+    uint64_t wait_values[3];
+    int wait_len = 0;
+    if (headless == 0) {
+        wait_semaphores[wait_len] = frame->image_available;
+        wait_stages[wait_len] = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+        // Binary semaphores ignore their value
+        wait_values[wait_len] = 0;
+        wait_len++;
+    }
+    if (upload_semaphore != VK_NULL_HANDLE) {
+        wait_semaphores[wait_len] = upload_semaphore;
+        wait_stages[wait_len] = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+        wait_values[wait_len] = upload_wait_value;
+        wait_len++;
+    }
+    VkPipelineStageFlags compute_wait_stage;
+    uint64_t compute_wait_value;
+    VkSemaphore compute_semaphore = _fa_vk_compute_acquire(&compute_wait_value, &compute_wait_stage);
+    if (compute_semaphore != VK_NULL_HANDLE) {
+        wait_semaphores[wait_len] = compute_semaphore;
+        wait_stages[wait_len] = compute_wait_stage;
+        wait_values[wait_len] = compute_wait_value;
+        wait_len++;
+    }
+
+    // Compute work submitted later can wait for the frame on the graphics timeline
+    VkSemaphore signal_semaphores[2];
+    uint64_t signal_values[2];
+    int signal_len = 0;
+    if (headless == 0) {
+        signal_semaphores[signal_len] = render_finished_semaphores[image_index];
+        signal_values[signal_len] = 0;
+        signal_len++;
+    }
+    signal_semaphores[signal_len] = _fa_vk_compute_frame_signal(&signal_values[signal_len]);
+    signal_len++;
+
+    VkTimelineSemaphoreSubmitInfo timeline_info;
+    memset(&timeline_info, 0, sizeof(timeline_info));
+    timeline_info.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+    timeline_info.waitSemaphoreValueCount = wait_len;
+    timeline_info.pWaitSemaphoreValues = wait_values;
+    timeline_info.signalSemaphoreValueCount = signal_len;
+    timeline_info.pSignalSemaphoreValues = signal_values;
+
+    VkSubmitInfo submit_info;
+    memset(&submit_info, 0, sizeof(submit_info));
+    submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submit_info.pNext = &timeline_info;
+    submit_info.waitSemaphoreCount = wait_len;
+    submit_info.pWaitSemaphores = wait_semaphores;
+    submit_info.pWaitDstStageMask = wait_stages;
+    submit_info.commandBufferCount = 1;
+    submit_info.pCommandBuffers = &frame->command_buffer;
+    submit_info.signalSemaphoreCount = signal_len;
+    submit_info.pSignalSemaphores = signal_semaphores;
+
+    fa_profile_begin("Submit and present");
+    _fa_vk_profile_submit();
+    if (vkQueueSubmit(graphics_queue, 1, &submit_info, frame->in_flight) != VK_SUCCESS) {
+        printf("Failed to submit draw command buffer :(\n");
+        exit(1);
+    }
+
+    VkResult result = VK_SUCCESS;
+    if (headless == 0) {
+        VkPresentInfoKHR present_info;
+        memset(&present_info, 0, sizeof(present_info));
+        present_info.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
+        present_info.waitSemaphoreCount = 1;
+        present_info.pWaitSemaphores = &render_finished_semaphores[image_index];
+        present_info.swapchainCount = 1;
+        present_info.pSwapchains = &swap_chain;
+        present_info.pImageIndices = &image_index;
+
+        result = vkQueuePresentKHR(present_queue, &present_info);
+    }
+    fa_profile_end();
+    if (result == VK_SUBOPTIMAL_KHR || result == VK_ERROR_OUT_OF_DATE_KHR) {
+        swap_chain_dirty = 1;
+    } else if (result != VK_SUCCESS) {
+        printf("Failed to present swap chain image :(\n");
+        exit(1);
+    }
+
+    frame_index = (frame_index + 1) % frames_in_flight;
+    frame_serial++;
 }
 
 void _fa_vk_teardown() {
-    for (int image_view_idx = 0; image_view_idx < swap_chain_image_views_len; image_view_idx++) {
-        vkDestroyImageView(device, swap_chain_image_views[image_view_idx], NULL);
+    fa_options_unsubscribe(on_swap_chain_option_changed, NULL);
+    vkDeviceWaitIdle(device);
+    if (headless) {
+        read_back_last_frame();
+    }
+
+    for (int frame_idx = 0; frame_idx < frames_in_flight; frame_idx++) {
+        vkDestroyFence(device, frames[frame_idx].in_flight, NULL);
+        vkDestroySemaphore(device, frames[frame_idx].image_available, NULL);
+        vkDestroyCommandPool(device, frames[frame_idx].command_pool, NULL);
     }
-    vkDestroySwapchainKHR(device, swap_chain, NULL);
+    _fa_vk_record_teardown();
+    _fa_vk_profile_teardown();
+    _fa_vk_compute_teardown();
+    for (int retired_idx = 0; retired_idx < retired_swap_chains_len; retired_idx++) {
+        destroy_swap_chain(&retired_swap_chains[retired_idx]);
+    }
+    retired_swap_chains_len = 0;
+    struct RetiredSwapChain current = take_swap_chain();
+    destroy_swap_chain(&current);
+    if (headless) {
+        _fa_vk_offscreen_destroy();
+    }
+
+    vkDestroyPipeline(device, graphics_pipeline, NULL);
+    save_pipeline_cache();
+    vkDestroyPipelineLayout(device, pipeline_layout, NULL);
+    vkDestroyRenderPass(device, render_pass, NULL);
+
+    _fa_vk_cull_teardown();
+    _fa_vk_draw_queue_teardown();
+    fa_vk_memory_destroy_buffer(mesh_buffer, &mesh_allocation);
+    fa_vk_bindless_remove_buffer(material_handle);
+    fa_vk_memory_destroy_buffer(material_buffer, &material_allocation);
+    _fa_vk_stream_teardown();
+    _fa_vk_bindless_teardown();
+    _fa_vk_upload_teardown();
+    _fa_vk_memory_teardown();
     vkDestroyDevice(device, NULL);
-    vkDestroySurfaceKHR(instance, surface, NULL);
+    free(surface_formats);
+    free(surface_present_modes);
+    surface_formats = NULL;
+    surface_present_modes = NULL;
+    if (surface != VK_NULL_HANDLE) {
+        vkDestroySurfaceKHR(instance, surface, NULL);
+    }
     vkDestroyInstance(instance, NULL);
 }
\ No newline at end of file
@@ -8,6 +8,33 @@
  * All the Vulkan nonsense that needs to happen at statup.
  */
 
+// Relative to the working directory
+#define FA_VK_PIPELINE_CACHE_PATH "pipeline_cache.bin"
+
+/**
+ * Start the parts of startup which do not need the window on the workers: creating the instance, querying the physical
+ * devices and loading the pipeline cache. Called after _fa_display_init and before _fa_display_open, so they overlap
+ * with opening the window. The validation layers are enabled if render.validation is set.
+ */
+void _fa_vk_init_begin();
+
+/**
+ * Finish startup once the window is open. Calls _fa_vk_init_begin first if it has not been called. Each phase is timed
+ * as a profiler zone of the first frame, see util/profile.h.
+ */
 void _fa_vk_init();
 
+/**
+ * Wait until the resources for the next frame are free and acquire a swapchain image, rebuilding the swapchain first if
+ * the window was resized or the presentation options changed. Blocks only if the GPU is still working on the frame that
+ * last used the same resources. Done before input is polled, so the wait does not add to input latency.
+ * @return Nonzero if there is an image to draw to, zero to skip the frame, for example while minimized.
+ */
+int _fa_vk_begin_frame();
+
+/**
+ * Record, submit and present the frame started by _fa_vk_begin_frame. Does nothing if it returned zero.
+ */
+void _fa_vk_draw_frame();
+
 void _fa_vk_teardown();
\ No newline at end of file
@@ -0,0 +1,15 @@
+// Resources indexed by handle, see render/vk/bindless.h. Handles which can differ between invocations of one draw
+// have to be wrapped in nonuniformEXT.
+
+#extension GL_EXT_nonuniform_qualifier : require
+
+layout (set = 0, binding = 0) uniform sampler2D fa_textures[];
+
+// The same buffers seen as different types
+layout (set = 0, binding = 1, std430) readonly buffer FA_Vec4Buffer {
+    vec4 data[];
+} fa_vec4_buffers[];
+
+layout (set = 0, binding = 1, std430) readonly buffer FA_UintBuffer {
+    uint data[];
+} fa_uint_buffers[];
\ No newline at end of file
@@ -0,0 +1,56 @@
+// What the cull pass reads and writes through the bindless buffers, see render/vk/cull.h. Include after bindless.glsl.
+
+// A command target whose command keeps its place instead of being compacted
+#define NOT_COMPACTED 0xffffffffu
+
+// One per queued draw, matches render/vk/draw_queue.c
+struct CullObject {
+    // Center and radius, never culled if the radius is negative
+    vec4 bounds;
+    // The command it is an instance of
+    uint command;
+    uint instance;
+};
+
+// VkDrawIndexedIndirectCommand
+struct DrawCommand {
+    uint index_count;
+    uint instance_count;
+    uint first_index;
+    int vertex_offset;
+    uint first_instance;
+};
+
+// Where a command is written, matches render/vk/draw_queue.c
+struct CommandTarget {
+    uint count_slot;
+    uint first_command;
+};
+
+// Matches render/vk/cull.c
+layout (set = 0, binding = 1, std430) readonly buffer FA_CullViewBuffer {
+    // Frustum planes facing inwards, not normalized
+    vec4 planes[6];
+    // What the depth pyramid was drawn with
+    mat4 pyramid_view_projection;
+    vec2 pyramid_size;
+    uint pyramid_levels;
+    // Zero until there is a depth pyramid to test against
+    uint occlusion;
+} fa_cull_views[];
+
+layout (set = 0, binding = 1, std430) readonly buffer FA_CullObjectBuffer {
+    CullObject data[];
+} fa_cull_objects[];
+
+layout (set = 0, binding = 1, std430) readonly buffer FA_CommandTargetBuffer {
+    CommandTarget data[];
+} fa_command_targets[];
+
+layout (set = 0, binding = 1, std430) buffer FA_DrawCommandBuffer {
+    DrawCommand data[];
+} fa_draw_commands[];
+
+layout (set = 0, binding = 1, std430) buffer FA_WritableUintBuffer {
+    uint data[];
+} fa_writable_uint_buffers[];
\ No newline at end of file
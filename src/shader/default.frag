@@ -1,7 +1,13 @@
 #version 450
+#extension GL_GOOGLE_include_directive : require
+
+#include "bindless.glsl"
+
+layout (location = 0) flat in uint material;
 
 layout (location = 0) out vec4 out_color;
 
 void main() {
-    out_color = vec4(1.0, 0.0, 0.0, 1.0);
+    // Instances of one draw can have different materials
+    out_color = fa_vec4_buffers[nonuniformEXT(material)].data[0];
 }
\ No newline at end of file
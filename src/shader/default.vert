@@ -1,4 +1,15 @@
 #version 450
+#extension GL_GOOGLE_include_directive : require
+
+#include "bindless.glsl"
+
+layout (push_constant) uniform DrawConstants {
+    // Handle of the buffer with one value per instance, see render/vk/draw_queue.h
+    uint instances;
+} draw;
+
+// The handle of a buffer starting with the color to draw with
+layout (location = 0) flat out uint out_material;
 
 vec2 positions[3] = vec2[](
     vec2(0.0, -0.5),
@@ -8,4 +19,5 @@ vec2 positions[3] = vec2[](
 
 void main() {
     gl_Position = vec4(positions[gl_VertexIndex], 0.0, 1.0);
+    out_material = fa_uint_buffers[draw.instances].data[gl_InstanceIndex];
 }
\ No newline at end of file
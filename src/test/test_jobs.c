@@ -0,0 +1,97 @@
+/**
+ * @file test_jobs.c
+ * @author ItsHighNoon
+ * @date 10-17-2026
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ * Checks that every job runs exactly once, including when more than FA_JOBS_MAX_PENDING are submitted at a time and
+ * some of them have to run on the submitting thread.
+ */
+
+#include <stdatomic.h>
+#include <stdio.h>
+
+#include "util/jobs.h"
+#include "util/options.h"
+
+#define JOBS (FA_JOBS_MAX_PENDING * 2 + 1000)
+#define SPAWNERS 4
+
+static atomic_int runs[JOBS];
+
+static void count_job(void* data) {
+    atomic_fetch_add(&runs[(long)data], 1);
+}
+
+static void spawn_job(void* data) {
+    FA_JobCounter* counter = data;
+    for (long job_idx = 0; job_idx < JOBS; job_idx++) {
+        fa_jobs_run(count_job, (void*)job_idx, counter);
+    }
+}
+
+static int check_runs(const char* test, int threads, int expected) {
+    int failed = 0;
+    for (int job_idx = 0; job_idx < JOBS; job_idx++) {
+        int count = atomic_exchange(&runs[job_idx], 0);
+        if (count != expected) {
+            printf("%s with %d threads: job %d ran %d times instead of %d :(\n", test, threads, job_idx, count,
+                   expected);
+            failed = 1;
+            break;
+        }
+    }
+    return failed;
+}
+
+static int test_threads(int threads) {
+    int failed = 0;
+    fa_options_set_int("jobs.threads", threads);
+    _fa_jobs_init();
+
+    // Everything from the main thread
+    FA_JobCounter counter = {0};
+    for (long job_idx = 0; job_idx < JOBS; job_idx++) {
+        fa_jobs_run(count_job, (void*)job_idx, &counter);
+    }
+    fa_jobs_wait(&counter);
+    failed |= check_runs("run", threads, 1);
+
+    // From inside jobs, which fill up the deques of the workers
+    FA_JobCounter spawned = {0};
+    for (int spawner_idx = 0; spawner_idx < SPAWNERS; spawner_idx++) {
+        fa_jobs_run(spawn_job, &spawned, &spawned);
+    }
+    fa_jobs_wait(&spawned);
+    failed |= check_runs("run from jobs", threads, SPAWNERS);
+
+    // More waiters parked on one counter than fit in the pool
+    FA_JobCounter dependency = {0};
+    FA_JobCounter after = {0};
+    for (long job_idx = 0; job_idx < SPAWNERS; job_idx++) {
+        fa_jobs_run(count_job, (void*)job_idx, &dependency);
+    }
+    for (long job_idx = SPAWNERS; job_idx < JOBS; job_idx++) {
+        fa_jobs_run_after(&dependency, count_job, (void*)job_idx, &after);
+    }
+    fa_jobs_wait(&dependency);
+    fa_jobs_wait(&after);
+    failed |= check_runs("run_after", threads, 1);
+
+    _fa_jobs_teardown();
+    return failed;
+}
+
+int main() {
+    int failed = 0;
+    _fa_options_init();
+    for (int threads = 1; threads <= 4; threads *= 2) {
+        failed |= test_threads(threads);
+    }
+    _fa_options_teardown();
+    if (!failed) {
+        printf("All jobs ran exactly once\n");
+    }
+    return failed;
+}
\ No newline at end of file
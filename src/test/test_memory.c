@@ -0,0 +1,208 @@
+/**
+ * @file test_memory.c
+ * @author ItsHighNoon
+ * @date 10-17-2026
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ * Checks the device memory allocator against a fake driver, which hands out handles without any memory behind them,
+ * so the free lists can be tested without a device.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "render/vk/memory.h"
+
+#define MIB (1024ull * 1024)
+#define HEAP_SIZE (8192 * MIB)
+// What memory.c splits a heap of HEAP_SIZE into
+#define BLOCK_SIZE (64 * MIB)
+
+static int live_memory_count;
+static uintptr_t next_memory = 1;
+
+VKAPI_ATTR void VKAPI_CALL vkGetPhysicalDeviceMemoryProperties(VkPhysicalDevice physical_device,
+                                                               VkPhysicalDeviceMemoryProperties* properties) {
+    memset(properties, 0, sizeof(VkPhysicalDeviceMemoryProperties));
+    properties->memoryTypeCount = 1;
+    properties->memoryTypes[0].propertyFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+    properties->memoryTypes[0].heapIndex = 0;
+    properties->memoryHeapCount = 1;
+    properties->memoryHeaps[0].size = HEAP_SIZE;
+}
+
+VKAPI_ATTR void VKAPI_CALL vkGetPhysicalDeviceProperties(VkPhysicalDevice physical_device,
+                                                         VkPhysicalDeviceProperties* properties) {
+    memset(properties, 0, sizeof(VkPhysicalDeviceProperties));
+    properties->limits.bufferImageGranularity = 1;
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL vkAllocateMemory(VkDevice device, const VkMemoryAllocateInfo* allocate_info,
+                                                const VkAllocationCallbacks* allocator, VkDeviceMemory* memory) {
+    if (allocate_info->allocationSize > HEAP_SIZE) {
+        return VK_ERROR_OUT_OF_DEVICE_MEMORY;
+    }
+    *memory = (VkDeviceMemory)next_memory++;
+    live_memory_count++;
+    return VK_SUCCESS;
+}
+
+VKAPI_ATTR void VKAPI_CALL vkFreeMemory(VkDevice device, VkDeviceMemory memory, const VkAllocationCallbacks* allocator) {
+    live_memory_count--;
+}
+
+// The rest is never reached with a device local only heap and no resources
+VKAPI_ATTR VkResult VKAPI_CALL vkMapMemory(VkDevice device, VkDeviceMemory memory, VkDeviceSize offset,
+                                           VkDeviceSize size, VkMemoryMapFlags flags, void** data) {
+    return VK_ERROR_MEMORY_MAP_FAILED;
+}
+
+VKAPI_ATTR void VKAPI_CALL vkUnmapMemory(VkDevice device, VkDeviceMemory memory) {
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL vkCreateBuffer(VkDevice device, const VkBufferCreateInfo* create_info,
+                                              const VkAllocationCallbacks* allocator, VkBuffer* buffer) {
+    return VK_ERROR_OUT_OF_DEVICE_MEMORY;
+}
+
+VKAPI_ATTR void VKAPI_CALL vkDestroyBuffer(VkDevice device, VkBuffer buffer, const VkAllocationCallbacks* allocator) {
+}
+
+VKAPI_ATTR void VKAPI_CALL vkGetBufferMemoryRequirements(VkDevice device, VkBuffer buffer,
+                                                         VkMemoryRequirements* requirements) {
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL vkBindBufferMemory(VkDevice device, VkBuffer buffer, VkDeviceMemory memory,
+                                                  VkDeviceSize offset) {
+    return VK_ERROR_OUT_OF_DEVICE_MEMORY;
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL vkCreateImage(VkDevice device, const VkImageCreateInfo* create_info,
+                                             const VkAllocationCallbacks* allocator, VkImage* image) {
+    return VK_ERROR_OUT_OF_DEVICE_MEMORY;
+}
+
+VKAPI_ATTR void VKAPI_CALL vkDestroyImage(VkDevice device, VkImage image, const VkAllocationCallbacks* allocator) {
+}
+
+VKAPI_ATTR void VKAPI_CALL vkGetImageMemoryRequirements(VkDevice device, VkImage image,
+                                                        VkMemoryRequirements* requirements) {
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL vkBindImageMemory(VkDevice device, VkImage image, VkDeviceMemory memory,
+                                                 VkDeviceSize offset) {
+    return VK_ERROR_OUT_OF_DEVICE_MEMORY;
+}
+
+static int allocate(VkDeviceSize size, VkDeviceSize alignment, FA_VkAllocation* allocation) {
+    VkMemoryRequirements requirements;
+    requirements.size = size;
+    requirements.alignment = alignment;
+    requirements.memoryTypeBits = 1;
+    return fa_vk_memory_allocate(&requirements, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, 0, 0, allocation);
+}
+
+// Anything over half a block gets a block of its own, whatever its size
+static int test_dedicated() {
+    const VkDeviceSize sizes[] = {
+        40000016,
+        // A 3840x2160 RGBA16F render target
+        66355200,
+        BLOCK_SIZE,
+        BLOCK_SIZE / 2 + 16,
+        BLOCK_SIZE * 3 + 48
+    };
+
+    for (int size_idx = 0; size_idx < sizeof(sizes) / sizeof(VkDeviceSize); size_idx++) {
+        FA_VkAllocation allocation;
+        if (allocate(sizes[size_idx], 256, &allocation) != 0) {
+            printf("Dedicated allocation of %llu bytes failed :(\n", (unsigned long long)sizes[size_idx]);
+            return 1;
+        }
+        if (allocation.offset != 0 || allocation.size < sizes[size_idx] || live_memory_count != 1) {
+            printf("Dedicated allocation of %llu bytes is not a block of its own :(\n",
+                   (unsigned long long)sizes[size_idx]);
+            return 1;
+        }
+        fa_vk_memory_free(&allocation);
+        if (live_memory_count != 0) {
+            printf("Freeing a dedicated allocation of %llu bytes leaked its block :(\n",
+                   (unsigned long long)sizes[size_idx]);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// Smaller allocations share a block, and every range comes back once they are all freed
+static int test_shared() {
+    FA_VkAllocation allocations[64];
+    for (int allocation_idx = 0; allocation_idx < 64; allocation_idx++) {
+        VkDeviceSize size = 4096 + allocation_idx * 1000;
+        VkDeviceSize alignment = 16ull << (allocation_idx % 8);
+        if (allocate(size, alignment, &allocations[allocation_idx]) != 0) {
+            printf("Shared allocation of %llu bytes failed :(\n", (unsigned long long)size);
+            return 1;
+        }
+        if (allocations[allocation_idx].offset % alignment != 0) {
+            printf("Shared allocation at %llu is not aligned to %llu :(\n",
+                   (unsigned long long)allocations[allocation_idx].offset, (unsigned long long)alignment);
+            return 1;
+        }
+        for (int other_idx = 0; other_idx < allocation_idx; other_idx++) {
+            if (allocations[allocation_idx].offset < allocations[other_idx].offset + allocations[other_idx].size
+                && allocations[other_idx].offset < allocations[allocation_idx].offset + size) {
+                printf("Shared allocations %d and %d overlap :(\n", other_idx, allocation_idx);
+                return 1;
+            }
+        }
+    }
+    if (live_memory_count != 1) {
+        printf("Shared allocations used %d blocks instead of 1 :(\n", live_memory_count);
+        return 1;
+    }
+
+    for (int allocation_idx = 0; allocation_idx < 64; allocation_idx += 2) {
+        fa_vk_memory_free(&allocations[allocation_idx]);
+    }
+    for (int allocation_idx = 1; allocation_idx < 64; allocation_idx += 2) {
+        fa_vk_memory_free(&allocations[allocation_idx]);
+    }
+
+    FA_VkMemoryStats stats;
+    fa_vk_memory_stats(-1, &stats);
+    if (stats.bytes_in_use != 0 || stats.free_range_count != 1 || stats.largest_free_range != BLOCK_SIZE) {
+        printf("Freed ranges were not merged back into one :(\n");
+        return 1;
+    }
+    return 0;
+}
+
+// An alignment no block can pad to fails without keeping the block it made for it
+static int test_failure() {
+    int live_before = live_memory_count;
+    FA_VkAllocation allocation;
+    if (allocate(4096, BLOCK_SIZE * 2, &allocation) == 0) {
+        printf("Allocation aligned past the end of a block succeeded :(\n");
+        return 1;
+    }
+    if (live_memory_count != live_before) {
+        printf("Failed allocation left %d blocks behind :(\n", live_memory_count - live_before);
+        return 1;
+    }
+    return 0;
+}
+
+int main() {
+    _fa_vk_memory_init(NULL, NULL);
+    int failed = test_dedicated();
+    failed |= test_shared();
+    failed |= test_failure();
+    _fa_vk_memory_teardown();
+    if (!failed) {
+        printf("All allocations behaved\n");
+    }
+    return failed;
+}
\ No newline at end of file
@@ -0,0 +1,105 @@
+/**
+ * @file embed.c
+ * @author ItsHighNoon
+ * @date 10-17-2026
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ * Build step which turns compiled SPIR-V modules into a C source file, so the shaders are linked into the executable
+ * instead of being read at runtime. See render/vk/shaders.h.
+ *
+ * Usage: fa_embed <registry.c> <shader.spv>...
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define WORDS_PER_LINE 8
+
+// The registry name of a shader is its file name without the directory and the .spv extension
+static void write_name(FILE* output, const char* path) {
+    const char* name = strrchr(path, '/');
+    name = name != NULL ? name + 1 : path;
+    size_t length = strlen(name);
+    if (length > 4 && strcmp(name + length - 4, ".spv") == 0) {
+        length -= 4;
+    }
+    fprintf(output, "\"%.*s\"", (int)length, name);
+}
+
+static int write_shader(FILE* output, const char* path, int shader_idx) {
+    FILE* input = fopen(path, "rb");
+    if (input == NULL) {
+        printf("Failed to open %s :(\n", path);
+        return 1;
+    }
+
+    fprintf(output, "static const uint32_t shader_%d[] = {", shader_idx);
+    unsigned char word[4];
+    size_t read;
+    long word_count = 0;
+    while ((read = fread(word, 1, sizeof(word), input)) == sizeof(word)) {
+        if (word_count % WORDS_PER_LINE == 0) {
+            fprintf(output, "\n   ");
+        }
+        // SPIR-V is a stream of host endian words, as is the array
+        unsigned int value;
+        memcpy(&value, word, sizeof(value));
+        fprintf(output, " 0x%08x,", value);
+        word_count++;
+    }
+    fprintf(output, "\n};\n\n");
+    fclose(input);
+
+    if (read != 0 || word_count == 0) {
+        printf("%s is not a SPIR-V module :(\n", path);
+        return 1;
+    }
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        printf("Usage: %s <registry.c> <shader.spv>...\n", argv[0]);
+        return 1;
+    }
+
+    FILE* output = fopen(argv[1], "w");
+    if (output == NULL) {
+        printf("Failed to open %s :(\n", argv[1]);
+        return 1;
+    }
+
+    fprintf(output, "/**\n");
+    fprintf(output, " * @file shader_registry.c\n");
+    fprintf(output, " * \n");
+    fprintf(output, " * Generated by fa_embed from the compiled shaders, do not edit.\n");
+    fprintf(output, " */\n\n");
+    fprintf(output, "#include \"render/vk/shaders.h\"\n\n");
+
+    int result = 0;
+    int shader_count = argc - 2;
+    for (int shader_idx = 0; shader_idx < shader_count && result == 0; shader_idx++) {
+        result = write_shader(output, argv[shader_idx + 2], shader_idx);
+    }
+
+    fprintf(output, "const FA_ShaderCode _fa_vk_shaders[] = {\n");
+    for (int shader_idx = 0; shader_idx < shader_count; shader_idx++) {
+        fprintf(output, "    { ");
+        write_name(output, argv[shader_idx + 2]);
+        fprintf(output, ", shader_%d, sizeof(shader_%d) },\n", shader_idx, shader_idx);
+    }
+    // Keeps the array valid when there are no shaders at all
+    fprintf(output, "    { NULL, NULL, 0 }\n");
+    fprintf(output, "};\n\n");
+    fprintf(output, "const int _fa_vk_shaders_len = %d;\n", shader_count);
+
+    if (fclose(output) != 0) {
+        result = 1;
+    }
+    if (result != 0) {
+        remove(argv[1]);
+    }
+    return result;
+}
\ No newline at end of file
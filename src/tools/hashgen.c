@@ -0,0 +1,74 @@
+/**
+ * @file hashgen.c
+ * @author ItsHighNoon
+ * @date 10-17-2026
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ * Build step which turns a list of option names into a header of precomputed hashes, see util/option_names.txt.
+ *
+ * Usage: fa_hashgen <names.txt> <header.h>
+ */
+
+#include <ctype.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "util/options.h"
+#include "util/util.h"
+
+int main(int argc, char** argv) {
+    if (argc != 3) {
+        printf("Usage: %s <names.txt> <header.h>\n", argv[0]);
+        return 1;
+    }
+
+    FILE* names = fopen(argv[1], "r");
+    if (names == NULL) {
+        printf("Failed to open %s :(\n", argv[1]);
+        return 1;
+    }
+    FILE* header = fopen(argv[2], "w");
+    if (header == NULL) {
+        printf("Failed to open %s :(\n", argv[2]);
+        fclose(names);
+        return 1;
+    }
+
+    fprintf(header, "/**\n");
+    fprintf(header, " * @file option_names.h\n");
+    fprintf(header, " * \n");
+    fprintf(header, " * Generated by fa_hashgen from util/option_names.txt, do not edit.\n");
+    fprintf(header, " */\n\n");
+    fprintf(header, "#pragma once\n\n");
+
+    int result = 0;
+    char line[FA_OPTION_MAX_LENGTH + 2];
+    while (fgets(line, sizeof(line), names) != NULL) {
+        size_t length = strcspn(line, "\r\n");
+        if (line[length] == '\0' && !feof(names)) {
+            printf("Option name too long: %s :(\n", line);
+            result = 1;
+            break;
+        }
+        line[length] = '\0';
+        if (length == 0 || line[0] == '#') {
+            continue;
+        }
+
+        fprintf(header, "#define FA_OPTION_NAME_");
+        for (size_t char_idx = 0; char_idx < length; char_idx++) {
+            fputc(isalnum((unsigned char)line[char_idx]) ? toupper((unsigned char)line[char_idx]) : '_', header);
+        }
+        fprintf(header, " \"%s\", 0x%lxul\n", line, fa_util_hash(line));
+    }
+
+    fclose(names);
+    if (fclose(header) != 0) {
+        result = 1;
+    }
+    if (result != 0) {
+        remove(argv[2]);
+    }
+    return result;
+}
\ No newline at end of file
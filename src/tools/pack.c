@@ -0,0 +1,367 @@
+/**
+ * @file pack.c
+ * @author ItsHighNoon
+ * @date 10-17-2026
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ * Offline tool which converts source assets into an asset pack, see asset/pack.h. The type of each asset comes from
+ * the extension of its file:
+ *     .obj  Wavefront mesh, positions only. Polygons are split into triangle fans.
+ *     .ppm  Binary (P6) image with 8 bit channels, stored as RGBA8 sRGB.
+ *     .spv  SPIR-V module, stored as is.
+ *
+ * Usage: fa_pack <output.pack> <name>=<file>...
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "asset/pack.h"
+#include "os/file.h"
+#include "util/util.h"
+
+#define SPIRV_MAGIC 0x07230203
+
+struct Asset {
+    FA_PackEntry entry;
+    const char* name;
+    size_t name_length;
+    unsigned char* payload;
+};
+
+struct Growable {
+    unsigned char* data;
+    size_t len;
+    size_t capacity;
+};
+
+static void append(struct Growable* growable, const void* data, size_t size) {
+    if (growable->len + size > growable->capacity) {
+        while (growable->len + size > growable->capacity) {
+            growable->capacity = growable->capacity > 0 ? growable->capacity * 2 : 4096;
+        }
+        growable->data = realloc(growable->data, growable->capacity);
+    }
+    memcpy(growable->data + growable->len, data, size);
+    growable->len += size;
+}
+
+static char* read_file(const char* path, size_t* size) {
+    FILE* input = fopen(path, "rb");
+    if (input == NULL) {
+        printf("Failed to open %s :(\n", path);
+        return NULL;
+    }
+
+    struct Growable contents;
+    memset(&contents, 0, sizeof(contents));
+    char chunk[4096];
+    size_t read;
+    while ((read = fread(chunk, 1, sizeof(chunk), input)) > 0) {
+        append(&contents, chunk, read);
+    }
+    fclose(input);
+
+    // Null terminated for the text formats
+    append(&contents, "", 1);
+    *size = contents.len - 1;
+    return (char*)contents.data;
+}
+
+// OBJ indices start at 1, negative indices count back from the last vertex read so far
+static int resolve_index(long index, uint32_t vertex_count, uint32_t* resolved) {
+    if (index > 0 && index <= vertex_count) {
+        *resolved = index - 1;
+        return 0;
+    }
+    if (index < 0 && -index <= vertex_count) {
+        *resolved = vertex_count + index;
+        return 0;
+    }
+    return 1;
+}
+
+static int pack_mesh(struct Asset* asset, const char* path) {
+    size_t size;
+    char* text = read_file(path, &size);
+    if (text == NULL) {
+        return 1;
+    }
+
+    struct Growable vertices;
+    struct Growable indices;
+    memset(&vertices, 0, sizeof(vertices));
+    memset(&indices, 0, sizeof(indices));
+    uint32_t vertex_count = 0;
+    int result = 0;
+    int line_number = 0;
+    char* line = text;
+    while (line != NULL && result == 0) {
+        char* next_line = strchr(line, '\n');
+        if (next_line != NULL) {
+            *next_line++ = '\0';
+        }
+        line_number++;
+
+        if (line[0] == 'v' && line[1] == ' ') {
+            float position[3];
+            if (sscanf(line + 2, "%f %f %f", &position[0], &position[1], &position[2]) == 3) {
+                append(&vertices, position, sizeof(position));
+                vertex_count++;
+            } else {
+                result = 1;
+            }
+        } else if (line[0] == 'f' && line[1] == ' ') {
+            uint32_t first = 0;
+            uint32_t previous = 0;
+            int corner_count = 0;
+            char* cursor = line + 2;
+            for (;;) {
+                cursor += strspn(cursor, " \t\r");
+                if (*cursor == '\0') {
+                    break;
+                }
+
+                // Each corner is v, v/vt, v//vn or v/vt/vn, only the position matters
+                char* end;
+                long index = strtol(cursor, &end, 10);
+                uint32_t corner;
+                if (end == cursor || resolve_index(index, vertex_count, &corner) != 0) {
+                    result = 1;
+                    break;
+                }
+                if (corner_count == 0) {
+                    first = corner;
+                } else if (corner_count >= 2) {
+                    uint32_t triangle[3] = {first, previous, corner};
+                    append(&indices, triangle, sizeof(triangle));
+                }
+                previous = corner;
+                corner_count++;
+                cursor = end + strcspn(end, " \t\r");
+            }
+            if (corner_count < 3) {
+                result = 1;
+            }
+        }
+        line = next_line;
+    }
+    free(text);
+
+    if (result != 0) {
+        printf("Failed to parse %s at line %d :(\n", path, line_number);
+    } else if (indices.len == 0) {
+        printf("%s has no faces :(\n", path);
+        result = 1;
+    } else {
+        // Indices are 4 byte aligned, as are the positions before them
+        asset->entry.type = FA_PACK_MESH;
+        asset->entry.mesh.vertex_count = vertex_count;
+        asset->entry.mesh.vertex_stride = 3 * sizeof(float);
+        asset->entry.mesh.index_count = indices.len / sizeof(uint32_t);
+        asset->entry.mesh.index_offset = vertices.len;
+        append(&vertices, indices.data, indices.len);
+        asset->entry.size = vertices.len;
+        asset->payload = vertices.data;
+        vertices.data = NULL;
+    }
+    free(vertices.data);
+    free(indices.data);
+    return result;
+}
+
+// Skips whitespace and comments between the fields of a PPM header
+static const char* ppm_field(const char* cursor, const char* end) {
+    while (cursor < end) {
+        if (*cursor == '#') {
+            while (cursor < end && *cursor != '\n') {
+                cursor++;
+            }
+        } else if (*cursor == ' ' || *cursor == '\t' || *cursor == '\r' || *cursor == '\n') {
+            cursor++;
+        } else {
+            break;
+        }
+    }
+    return cursor;
+}
+
+static int pack_texture(struct Asset* asset, const char* path) {
+    size_t size;
+    char* contents = read_file(path, &size);
+    if (contents == NULL) {
+        return 1;
+    }
+
+    const char* end = contents + size;
+    const char* cursor = contents;
+    unsigned long fields[3];
+    int valid = size > 2 && memcmp(contents, "P6", 2) == 0;
+    cursor += 2;
+    for (int field_idx = 0; field_idx < 3 && valid; field_idx++) {
+        cursor = ppm_field(cursor, end);
+        char* field_end;
+        fields[field_idx] = strtoul(cursor, &field_end, 10);
+        valid = field_end != cursor && fields[field_idx] > 0;
+        cursor = field_end;
+    }
+    // A single whitespace character separates the header from the texels
+    cursor++;
+
+    unsigned long width = fields[0];
+    unsigned long height = fields[1];
+    if (!valid || fields[2] != 255 || width > UINT16_MAX || height > UINT16_MAX || cursor > end ||
+        (size_t)(end - cursor) < width * height * 3) {
+        printf("%s is not a binary PPM with 8 bit channels :(\n", path);
+        free(contents);
+        return 1;
+    }
+
+    unsigned char* texels = malloc(width * height * 4);
+    for (unsigned long texel_idx = 0; texel_idx < width * height; texel_idx++) {
+        memcpy(&texels[texel_idx * 4], &cursor[texel_idx * 3], 3);
+        texels[texel_idx * 4 + 3] = 255;
+    }
+    free(contents);
+
+    asset->entry.type = FA_PACK_TEXTURE;
+    asset->entry.texture.width = width;
+    asset->entry.texture.height = height;
+    asset->entry.texture.format = FA_PACK_FORMAT_RGBA8_SRGB;
+    asset->entry.size = width * height * 4;
+    asset->payload = texels;
+    return 0;
+}
+
+static int pack_shader(struct Asset* asset, const char* path) {
+    size_t size;
+    char* contents = read_file(path, &size);
+    if (contents == NULL) {
+        return 1;
+    }
+
+    uint32_t magic = 0;
+    if (size >= sizeof(magic)) {
+        memcpy(&magic, contents, sizeof(magic));
+    }
+    if (magic != SPIRV_MAGIC || size % sizeof(uint32_t) != 0) {
+        printf("%s is not a SPIR-V module :(\n", path);
+        free(contents);
+        return 1;
+    }
+
+    asset->entry.type = FA_PACK_SHADER;
+    asset->entry.size = size;
+    asset->payload = (unsigned char*)contents;
+    return 0;
+}
+
+static int pack_asset(struct Asset* asset, const char* argument) {
+    const char* separator = strchr(argument, '=');
+    if (separator == NULL || separator == argument) {
+        printf("Expected <name>=<file>, got %s :(\n", argument);
+        return 1;
+    }
+
+    // The name is hashed and stored null terminated, so copy it out of the argument
+    size_t name_length = separator - argument;
+    char* name = malloc(name_length + 1);
+    memcpy(name, argument, name_length);
+    name[name_length] = '\0';
+    asset->name = name;
+    asset->name_length = name_length;
+    asset->entry.name_hash = fa_util_hash(name);
+
+    const char* path = separator + 1;
+    const char* extension = strrchr(path, '.');
+    if (extension != NULL && strcmp(extension, ".obj") == 0) {
+        return pack_mesh(asset, path);
+    } else if (extension != NULL && strcmp(extension, ".ppm") == 0) {
+        return pack_texture(asset, path);
+    } else if (extension != NULL && strcmp(extension, ".spv") == 0) {
+        return pack_shader(asset, path);
+    }
+    printf("Unknown asset type of %s :(\n", path);
+    return 1;
+}
+
+static int compare_assets(const void* a, const void* b) {
+    uint64_t hash_a = ((const struct Asset*)a)->entry.name_hash;
+    uint64_t hash_b = ((const struct Asset*)b)->entry.name_hash;
+    return hash_a < hash_b ? -1 : hash_a > hash_b;
+}
+
+static uint64_t align_up(uint64_t value, uint64_t alignment) {
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        printf("Usage: %s <output.pack> <name>=<file>...\n", argv[0]);
+        return 1;
+    }
+
+    int asset_count = argc - 2;
+    struct Asset* assets = calloc(asset_count, sizeof(struct Asset));
+    int result = 0;
+    for (int asset_idx = 0; asset_idx < asset_count && result == 0; asset_idx++) {
+        result = pack_asset(&assets[asset_idx], argv[asset_idx + 2]);
+    }
+
+    if (result == 0) {
+        qsort(assets, asset_count, sizeof(struct Asset), compare_assets);
+        for (int asset_idx = 1; asset_idx < asset_count; asset_idx++) {
+            if (assets[asset_idx - 1].entry.name_hash == assets[asset_idx].entry.name_hash) {
+                printf("%s and %s have the same hash, rename one :(\n", assets[asset_idx - 1].name,
+                       assets[asset_idx].name);
+                result = 1;
+            }
+        }
+    }
+
+    if (result == 0) {
+        FA_PackHeader header;
+        memset(&header, 0, sizeof(header));
+        header.magic = FA_PACK_MAGIC;
+        header.version = FA_PACK_VERSION;
+        header.entry_count = asset_count;
+        header.names_offset = sizeof(FA_PackHeader) + asset_count * sizeof(FA_PackEntry);
+
+        // Lay out the names right after the entries and every payload on its own pages after the names
+        for (int asset_idx = 0; asset_idx < asset_count; asset_idx++) {
+            assets[asset_idx].entry.name_offset = header.names_size;
+            header.names_size += assets[asset_idx].name_length + 1;
+        }
+        uint64_t offset = align_up(header.names_offset + header.names_size, FA_PACK_ALIGNMENT);
+        for (int asset_idx = 0; asset_idx < asset_count; asset_idx++) {
+            assets[asset_idx].entry.offset = offset;
+            offset = align_up(offset + assets[asset_idx].entry.size, FA_PACK_ALIGNMENT);
+        }
+        header.file_size = offset;
+
+        unsigned char* contents = calloc(header.file_size, 1);
+        memcpy(contents, &header, sizeof(header));
+        for (int asset_idx = 0; asset_idx < asset_count; asset_idx++) {
+            struct Asset* asset = &assets[asset_idx];
+            memcpy(contents + sizeof(FA_PackHeader) + asset_idx * sizeof(FA_PackEntry), &asset->entry,
+                   sizeof(FA_PackEntry));
+            memcpy(contents + header.names_offset + asset->entry.name_offset, asset->name, asset->name_length + 1);
+            memcpy(contents + asset->entry.offset, asset->payload, asset->entry.size);
+        }
+
+        if (_fa_os_write_file_atomic(argv[1], contents, header.file_size) != 0) {
+            printf("Failed to write %s :(\n", argv[1]);
+            result = 1;
+        }
+        free(contents);
+    }
+
+    for (int asset_idx = 0; asset_idx < asset_count; asset_idx++) {
+        free((char*)assets[asset_idx].name);
+        free(assets[asset_idx].payload);
+    }
+    free(assets);
+    return result;
+}
\ No newline at end of file
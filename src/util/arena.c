@@ -0,0 +1,148 @@
+/**
+ * @file arena.c
+ * @author ItsHighNoon
+ * @date 10-17-2026
+ * 
+ * @copyright Copyright (c) 2026
+ */
+
+#include "arena.h"
+
+#include <stdalign.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#define FRAME_CHUNK_SIZE (1024 * 1024)
+#define SCRATCH_CHUNK_SIZE (256 * 1024)
+
+struct FA_ArenaChunkStruct {
+    struct FA_ArenaChunkStruct* next;
+    size_t size;
+    alignas(max_align_t) char data[];
+};
+
+static FA_Arena frame_arena;
+
+static _Thread_local FA_Arena scratch_arena;
+static _Thread_local int scratch_created;
+
+/*
+ * Move on to the next chunk which can hold size bytes. Chunks that were too small stay where they are and get used
+ * again after the next reset, so a chunk is only ever allocated when an arena is bigger than it has ever been.
+ */
+static void next_chunk(FA_Arena* arena, size_t size) {
+    FA_ArenaChunk* previous = arena->current;
+    FA_ArenaChunk* candidate = previous != NULL ? previous->next : arena->first;
+    if (candidate == NULL || candidate->size < size) {
+        size_t chunk_size = size > arena->chunk_size ? size : arena->chunk_size;
+        FA_ArenaChunk* chunk = malloc(sizeof(FA_ArenaChunk) + chunk_size);
+        chunk->size = chunk_size;
+        chunk->next = candidate;
+        if (previous != NULL) {
+            previous->next = chunk;
+        } else {
+            arena->first = chunk;
+        }
+        candidate = chunk;
+    }
+
+    arena->current = candidate;
+    arena->used = 0;
+}
+
+void _fa_arena_init() {
+    fa_arena_create(&frame_arena, FRAME_CHUNK_SIZE);
+}
+
+void _fa_arena_teardown() {
+    fa_arena_destroy(&frame_arena);
+    _fa_arena_release_scratch();
+}
+
+void _fa_arena_new_frame() {
+    fa_arena_reset(&frame_arena);
+}
+
+void _fa_arena_release_scratch() {
+    if (scratch_created) {
+        fa_arena_destroy(&scratch_arena);
+        scratch_created = 0;
+    }
+}
+
+void fa_arena_create(FA_Arena* arena, size_t chunk_size) {
+    arena->first = NULL;
+    arena->current = NULL;
+    arena->used = 0;
+    arena->chunk_size = chunk_size;
+}
+
+void fa_arena_destroy(FA_Arena* arena) {
+    FA_ArenaChunk* chunk = arena->first;
+    while (chunk != NULL) {
+        FA_ArenaChunk* next = chunk->next;
+        free(chunk);
+        chunk = next;
+    }
+    arena->first = NULL;
+    arena->current = NULL;
+    arena->used = 0;
+}
+
+void* fa_arena_push(FA_Arena* arena, size_t size) {
+    return fa_arena_push_aligned(arena, size, alignof(max_align_t));
+}
+
+void* fa_arena_push_aligned(FA_Arena* arena, size_t size, size_t alignment) {
+    if (arena->current != NULL) {
+        uintptr_t start = ((uintptr_t)arena->current->data + arena->used + alignment - 1) & ~(uintptr_t)(alignment - 1);
+        size_t offset = start - (uintptr_t)arena->current->data;
+        if (offset + size <= arena->current->size) {
+            arena->used = offset + size;
+            return arena->current->data + offset;
+        }
+    }
+
+    // Chunk data is aligned for max_align_t, anything stricter needs room to slide forward
+    size_t padding = alignment > alignof(max_align_t) ? alignment : 0;
+    next_chunk(arena, size + padding);
+    return fa_arena_push_aligned(arena, size, alignment);
+}
+
+void fa_arena_reset(FA_Arena* arena) {
+    arena->current = arena->first;
+    arena->used = 0;
+}
+
+FA_ArenaScope fa_arena_begin(FA_Arena* arena) {
+    FA_ArenaScope scope;
+    scope.arena = arena;
+    scope.chunk = arena->current;
+    scope.used = arena->used;
+    return scope;
+}
+
+void fa_arena_end(FA_ArenaScope scope) {
+    if (scope.chunk == NULL) {
+        fa_arena_reset(scope.arena);
+    } else {
+        scope.arena->current = scope.chunk;
+        scope.arena->used = scope.used;
+    }
+}
+
+FA_Arena* fa_arena_frame() {
+    return &frame_arena;
+}
+
+FA_ArenaScope fa_arena_scratch_begin() {
+    if (!scratch_created) {
+        fa_arena_create(&scratch_arena, SCRATCH_CHUNK_SIZE);
+        scratch_created = 1;
+    }
+    return fa_arena_begin(&scratch_arena);
+}
+
+void fa_arena_scratch_end(FA_ArenaScope scope) {
+    fa_arena_end(scope);
+}
\ No newline at end of file
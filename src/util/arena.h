@@ -0,0 +1,121 @@
+/**
+ * @file arena.h
+ * @author ItsHighNoon
+ * @date 10-17-2026
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ * Bump allocators for memory with an obvious lifetime.
+ *
+ * There is one arena per frame, reset at the top of the main loop, for anything which only has to live until the next
+ * frame. Each thread also has a scratch arena for temporary queries. Scratch scopes nest, and ending a scope gives back
+ * everything allocated since it began:
+ *
+ *     FA_ArenaScope scratch = fa_arena_scratch_begin();
+ *     VkLayerProperties* layers = fa_arena_push(scratch.arena, layer_count * sizeof(VkLayerProperties));
+ *     ...
+ *     fa_arena_scratch_end(scratch);
+ *
+ * Arenas keep their memory once it has been allocated, so after the first few frames nothing reaches the general
+ * purpose allocator.
+ */
+
+#pragma once
+
+#include <stddef.h>
+
+typedef struct FA_ArenaChunkStruct FA_ArenaChunk;
+
+typedef struct {
+    FA_ArenaChunk* first;
+    FA_ArenaChunk* current;
+    size_t used;
+    size_t chunk_size;
+} FA_Arena;
+
+typedef struct {
+    FA_Arena* arena;
+    FA_ArenaChunk* chunk;
+    size_t used;
+} FA_ArenaScope;
+
+void _fa_arena_init();
+
+void _fa_arena_teardown();
+
+/**
+ * Reset the frame arena. Called once per frame at the top of the main loop.
+ */
+void _fa_arena_new_frame();
+
+/**
+ * Release the scratch arena of the calling thread. Threads other than the main thread call this before they exit.
+ */
+void _fa_arena_release_scratch();
+
+/**
+ * Set up an arena. Nothing is allocated until the first push.
+ * @param arena The arena to set up.
+ * @param chunk_size How much memory to get from the system at once. Pushes bigger than this get a chunk of their own.
+ */
+void fa_arena_create(FA_Arena* arena, size_t chunk_size);
+
+/**
+ * Give all memory of an arena back to the system.
+ * @param arena The arena to destroy.
+ */
+void fa_arena_destroy(FA_Arena* arena);
+
+/**
+ * Allocate memory from an arena, aligned for any type.
+ * @param arena The arena to allocate from.
+ * @param size How many bytes to allocate.
+ * @return A pointer to the memory. Never NULL.
+ */
+void* fa_arena_push(FA_Arena* arena, size_t size);
+
+/**
+ * Allocate memory from an arena with a specific alignment.
+ * @param arena The arena to allocate from.
+ * @param size How many bytes to allocate.
+ * @param alignment The required alignment. Must be a power of two.
+ * @return A pointer to the memory. Never NULL.
+ */
+void* fa_arena_push_aligned(FA_Arena* arena, size_t size, size_t alignment);
+
+/**
+ * Free everything allocated from an arena at once, keeping its memory for reuse.
+ * @param arena The arena to reset.
+ */
+void fa_arena_reset(FA_Arena* arena);
+
+/**
+ * Remember the current position of an arena.
+ * @param arena The arena.
+ * @return A scope which can be passed to fa_arena_end to free everything allocated after this call.
+ */
+FA_ArenaScope fa_arena_begin(FA_Arena* arena);
+
+/**
+ * Free everything allocated from an arena since a scope began.
+ * @param scope A scope returned by fa_arena_begin.
+ */
+void fa_arena_end(FA_ArenaScope scope);
+
+/**
+ * Get the frame arena. Only valid on the main thread.
+ * @return The frame arena. Anything allocated from it is freed at the start of the next frame.
+ */
+FA_Arena* fa_arena_frame();
+
+/**
+ * Begin a scope in the scratch arena of the calling thread.
+ * @return The scope. Allocate from scope.arena and end it with fa_arena_scratch_end.
+ */
+FA_ArenaScope fa_arena_scratch_begin();
+
+/**
+ * End a scope begun by fa_arena_scratch_begin, freeing everything allocated in it.
+ * @param scope The scope returned by fa_arena_scratch_begin.
+ */
+void fa_arena_scratch_end(FA_ArenaScope scope);
\ No newline at end of file
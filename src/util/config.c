@@ -0,0 +1,167 @@
+/**
+ * @file config.c
+ * @author ItsHighNoon
+ * @date 10-17-2026
+ * 
+ * @copyright Copyright (c) 2026
+ */
+
+#include "config.h"
+
+#include <errno.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "os/file.h"
+#include "util/options.h"
+
+#define MAX_ARGS 3
+#define MAX_ARG_LENGTH 1024
+
+// Stops config files from executing each other forever
+#define MAX_EXEC_DEPTH 8
+
+typedef struct {
+    char args[MAX_ARGS][MAX_ARG_LENGTH];
+    int quoted[MAX_ARGS];
+    int args_len;
+} Command;
+
+static int exec_depth;
+
+/*
+ * Split the line starting at text into arguments. Returns a pointer to the start of the next line. Arguments past
+ * MAX_ARGS are counted but not stored, so no command matches the line, and arguments longer than MAX_ARG_LENGTH are
+ * truncated.
+ */
+static const char* tokenize(const char* text, const char* end, Command* command) {
+    command->args_len = 0;
+
+    while (text < end && *text != '\n') {
+        if (*text == ' ' || *text == '\t' || *text == '\r') {
+            text++;
+            continue;
+        }
+        if (*text == '#' || (*text == '/' && text + 1 < end && text[1] == '/')) {
+            while (text < end && *text != '\n') {
+                text++;
+            }
+            break;
+        }
+
+        int quoted = *text == '"';
+        if (quoted) {
+            text++;
+        }
+        int length = 0;
+        char* arg = command->args_len < MAX_ARGS ? command->args[command->args_len] : NULL;
+        while (text < end && *text != '\n') {
+            if (quoted ? *text == '"' : (*text == ' ' || *text == '\t' || *text == '\r')) {
+                break;
+            }
+            if (arg != NULL && length < MAX_ARG_LENGTH - 1) {
+                arg[length++] = *text;
+            }
+            text++;
+        }
+        if (quoted && text < end && *text == '"') {
+            text++;
+        }
+
+        if (arg != NULL) {
+            arg[length] = '\0';
+            command->quoted[command->args_len] = quoted;
+        }
+        command->args_len++;
+    }
+
+    if (text < end) {
+        text++;
+    }
+    return text;
+}
+
+static int set_from_text(const char* command_name, const char* name, const char* value, int quoted) {
+    if (!quoted && *value != '\0') {
+        char* parse_end;
+        errno = 0;
+        long int_value = strtol(value, &parse_end, 0);
+        if (*parse_end == '\0') {
+            if (errno == ERANGE || int_value < INT_MIN || int_value > INT_MAX) {
+                printf("Bad config command \"%s\" :(\n", command_name);
+                return 1;
+            }
+            return fa_options_set_int(name, (int)int_value);
+        }
+
+        float float_value = strtof(value, &parse_end);
+        if (*parse_end == '\0') {
+            return fa_options_set_float(name, float_value);
+        }
+    }
+
+    return fa_options_set_string(name, value);
+}
+
+static int run_command(Command* command) {
+    if (command->args_len == 0) {
+        return 0;
+    }
+
+    if (strcmp(command->args[0], "exec") == 0 && command->args_len == 2) {
+        return fa_config_exec(command->args[1]);
+    } else if (strcmp(command->args[0], "set") == 0 && command->args_len == 3) {
+        return set_from_text(command->args[0], command->args[1], command->args[2], command->quoted[2]);
+    } else if (strcmp(command->args[0], "unset") == 0 && command->args_len == 2) {
+        return fa_options_unset(command->args[1]);
+    } else if (command->args_len == 2) {
+        return set_from_text(command->args[0], command->args[0], command->args[1], command->quoted[1]);
+    }
+
+    printf("Bad config command \"%s\" :(\n", command->args[0]);
+    return 1;
+}
+
+static int exec_text(const char* text, size_t length) {
+    const char* end = text + length;
+    // Too big for the stack
+    Command* command = malloc(sizeof(Command));
+    int result = 0;
+
+    while (text < end) {
+        text = tokenize(text, end, command);
+        if (run_command(command) != 0) {
+            result = 1;
+        }
+    }
+
+    free(command);
+    return result;
+}
+
+int fa_config_exec(const char* path) {
+    if (exec_depth >= MAX_EXEC_DEPTH) {
+        printf("Config files nested too deep at %s :(\n", path);
+        return 1;
+    }
+
+    size_t size;
+    const char* text = _fa_os_map_file(path, &size);
+    if (text == NULL) {
+        // Empty files can't be mapped, but running one does nothing
+        return _fa_os_file_size(path) == 0 ? 0 : 1;
+    }
+
+    exec_depth++;
+    int result = exec_text(text, size);
+    exec_depth--;
+
+    _fa_os_unmap_file(text, size);
+    return result;
+}
+
+int fa_config_run(const char* line) {
+    return exec_text(line, strlen(line));
+}
\ No newline at end of file
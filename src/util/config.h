@@ -0,0 +1,33 @@
+/**
+ * @file config.h
+ * @author ItsHighNoon
+ * @date 10-17-2026
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ * Text config files, similar to Quake/Source .cfg files.
+ *
+ * Each line holds one command. Arguments are separated by whitespace and can be quoted to include whitespace.
+ * Everything after // or # is a comment.
+ * - exec <path> - Run another config file.
+ * - set <name> <value> - Set an option. Values which parse completely as an integer or a float get that type,
+ *   anything else (including anything quoted) is a string.
+ * - unset <name> - Reset an option to having no value.
+ * - <name> <value> - Shorthand for set.
+ */
+
+#pragma once
+
+/**
+ * Run every command in a config file.
+ * @param path The path of the config file. Assumed to be null terminated.
+ * @return 0 on success, 1 if the file (or a file it executes) could not be read.
+ */
+int fa_config_exec(const char* path);
+
+/**
+ * Run a single config command, as if it were one line of a config file.
+ * @param line The command. Assumed to be null terminated.
+ * @return 0 on success, 1 if the command failed.
+ */
+int fa_config_run(const char* line);
\ No newline at end of file
@@ -0,0 +1,264 @@
+/**
+ * @file intern.c
+ * @author ItsHighNoon
+ * @date 10-17-2026
+ * 
+ * @copyright Copyright (c) 2026
+ */
+
+#include "intern.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "util/util.h"
+
+// Blocks (header included) are 32 bytes up to 64 KiB in powers of two. Anything bigger gets its own allocation.
+#define SIZE_CLASSES 12
+#define MIN_CLASS_SHIFT 5
+#define LARGE_CLASS SIZE_CLASSES
+
+#define CHUNK_SIZE (256 * 1024)
+#define INITIAL_TABLE_CAPACITY 64
+
+// Marks a removed entry in the table so probing continues past it
+#define TOMBSTONE ((StringBlock*)1)
+
+typedef struct StringBlockStruct {
+    // Links the block into a free list or the retire list once it is no longer referenced
+    struct StringBlockStruct* next;
+    unsigned long hash;
+    size_t length;
+    unsigned int references;
+    unsigned int size_class;
+    unsigned int retired;
+    // The reclaim epoch in which the last reference was dropped
+    unsigned int released_epoch;
+} StringBlock;
+
+// Open addressing with linear probing, keyed by hash and contents
+static StringBlock** table;
+// Rehashing to clear out tombstones goes into the spare table so it never needs to allocate
+static StringBlock** spare_table;
+static size_t table_capacity;
+static size_t table_live;
+static size_t table_used;
+
+static StringBlock* free_lists[SIZE_CLASSES];
+
+// The first bytes of each chunk point to the previous chunk
+static char* chunk;
+static size_t chunk_used;
+
+/*
+ * Blocks with no references stay in the table until they are recycled, so a value that comes back before then is
+ * revived instead of copied again. They are recycled once two reclaims have passed since their last reference was
+ * dropped.
+ */
+static StringBlock* retired;
+static unsigned int epoch;
+
+static char* block_string(StringBlock* block) {
+    return (char*)block + sizeof(StringBlock);
+}
+
+static StringBlock* string_block(const char* string) {
+    return (StringBlock*)(string - sizeof(StringBlock));
+}
+
+static unsigned int size_class_for(size_t size) {
+    unsigned int size_class = 0;
+    while (size_class < SIZE_CLASSES && ((size_t)1 << (size_class + MIN_CLASS_SHIFT)) < size) {
+        size_class++;
+    }
+    return size_class;
+}
+
+static StringBlock* allocate_block(size_t length) {
+    size_t size = sizeof(StringBlock) + length + 1;
+    unsigned int size_class = size_class_for(size);
+
+    StringBlock* block;
+    if (size_class == LARGE_CLASS) {
+        block = malloc(size);
+    } else if (free_lists[size_class] != NULL) {
+        block = free_lists[size_class];
+        free_lists[size_class] = block->next;
+    } else {
+        size_t class_size = (size_t)1 << (size_class + MIN_CLASS_SHIFT);
+        if (chunk == NULL || chunk_used + class_size > CHUNK_SIZE) {
+            char* new_chunk = malloc(CHUNK_SIZE);
+            memcpy(new_chunk, &chunk, sizeof(char*));
+            chunk = new_chunk;
+            // Keep blocks aligned for the header
+            chunk_used = sizeof(StringBlock);
+        }
+        block = (StringBlock*)(chunk + chunk_used);
+        chunk_used += class_size;
+    }
+
+    block->size_class = size_class;
+    return block;
+}
+
+static void recycle_block(StringBlock* block) {
+    if (block->size_class == LARGE_CLASS) {
+        free(block);
+    } else {
+        block->next = free_lists[block->size_class];
+        free_lists[block->size_class] = block;
+    }
+}
+
+static void table_insert(StringBlock** entries, size_t capacity, StringBlock* block) {
+    size_t mask = capacity - 1;
+    size_t position = block->hash & mask;
+    while (entries[position] != NULL && entries[position] != TOMBSTONE) {
+        position = (position + 1) & mask;
+    }
+    entries[position] = block;
+}
+
+static void table_rebuild(size_t capacity) {
+    StringBlock** entries = spare_table;
+    if (capacity != table_capacity) {
+        free(spare_table);
+        entries = malloc(capacity * sizeof(StringBlock*));
+    }
+    memset(entries, 0, capacity * sizeof(StringBlock*));
+
+    for (size_t position = 0; position < table_capacity; position++) {
+        if (table[position] != NULL && table[position] != TOMBSTONE) {
+            table_insert(entries, capacity, table[position]);
+        }
+    }
+
+    if (capacity != table_capacity) {
+        free(table);
+        spare_table = malloc(capacity * sizeof(StringBlock*));
+    } else {
+        spare_table = table;
+    }
+    table = entries;
+    table_capacity = capacity;
+    table_used = table_live;
+}
+
+void _fa_intern_init() {
+    table_capacity = INITIAL_TABLE_CAPACITY;
+    table = calloc(table_capacity, sizeof(StringBlock*));
+    spare_table = malloc(table_capacity * sizeof(StringBlock*));
+    table_live = 0;
+    table_used = 0;
+
+    memset(free_lists, 0, sizeof(free_lists));
+    chunk = NULL;
+    chunk_used = 0;
+
+    retired = NULL;
+    epoch = 0;
+}
+
+void _fa_intern_teardown() {
+    // Only large blocks own memory, everything else goes away with the chunks. Retired blocks are still in the table.
+    for (size_t position = 0; position < table_capacity; position++) {
+        if (table[position] != NULL && table[position] != TOMBSTONE && table[position]->size_class == LARGE_CLASS) {
+            free(table[position]);
+        }
+    }
+    retired = NULL;
+
+    free(table);
+    free(spare_table);
+    table = NULL;
+    spare_table = NULL;
+    table_capacity = 0;
+
+    while (chunk != NULL) {
+        char* previous;
+        memcpy(&previous, chunk, sizeof(char*));
+        free(chunk);
+        chunk = previous;
+    }
+    memset(free_lists, 0, sizeof(free_lists));
+}
+
+const char* fa_intern_acquire(const char* string, size_t length) {
+    unsigned long hash = fa_util_hash_bytes(string, length);
+
+    size_t mask = table_capacity - 1;
+    for (size_t position = hash & mask; table[position] != NULL; position = (position + 1) & mask) {
+        StringBlock* block = table[position];
+        if (block != TOMBSTONE
+            && block->hash == hash
+            && block->length == length
+            && memcmp(block_string(block), string, length) == 0) {
+            block->references++;
+            return block_string(block);
+        }
+    }
+
+    StringBlock* block = allocate_block(length);
+    block->next = NULL;
+    block->hash = hash;
+    block->length = length;
+    block->references = 1;
+    block->retired = 0;
+    memcpy(block_string(block), string, length);
+    block_string(block)[length] = '\0';
+
+    // Keep live entries and tombstones together under 3/4 of the table, growing only if live entries need the room
+    if ((table_used + 1) * 4 > table_capacity * 3) {
+        size_t capacity = table_capacity;
+        while ((table_live + 1) * 2 > capacity) {
+            capacity *= 2;
+        }
+        table_rebuild(capacity);
+    }
+    table_insert(table, table_capacity, block);
+    table_live++;
+    table_used++;
+
+    return block_string(block);
+}
+
+void fa_intern_release(const char* string) {
+    StringBlock* block = string_block(string);
+    if (--block->references > 0) {
+        return;
+    }
+
+    block->released_epoch = epoch;
+    if (!block->retired) {
+        block->retired = 1;
+        block->next = retired;
+        retired = block;
+    }
+}
+
+void fa_intern_reclaim() {
+    epoch++;
+
+    StringBlock** link = &retired;
+    while (*link != NULL) {
+        StringBlock* block = *link;
+        if (block->references > 0) {
+            // Revived since it was retired
+            block->retired = 0;
+            *link = block->next;
+        } else if (epoch - block->released_epoch >= 2) {
+            size_t mask = table_capacity - 1;
+            for (size_t position = block->hash & mask; table[position] != NULL; position = (position + 1) & mask) {
+                if (table[position] == block) {
+                    table[position] = TOMBSTONE;
+                    table_live--;
+                    break;
+                }
+            }
+            *link = block->next;
+            recycle_block(block);
+        } else {
+            link = &block->next;
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,42 @@
+/**
+ * @file intern.h
+ * @author ItsHighNoon
+ * @date 10-17-2026
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ * Reference counted string interning backed by a pooled arena. Acquiring a string which is already interned only bumps
+ * a reference count, and released strings are recycled through size class free lists, so once the pool has warmed up
+ * no calls reach the general purpose allocator.
+ *
+ * Not thread safe, callers are expected to serialize access themselves. Released strings stay readable until the
+ * second call to fa_intern_reclaim, so lock-free readers elsewhere have a grace period to finish with them.
+ */
+
+#pragma once
+
+#include <stddef.h>
+
+void _fa_intern_init();
+
+void _fa_intern_teardown();
+
+/**
+ * Get an interned copy of a string, adding a reference to it.
+ * @param string The string to intern. Does not need to be null terminated.
+ * @param length The length of string in bytes.
+ * @return A pointer to a null terminated copy of string, shared with everyone else who interned the same contents.
+ */
+const char* fa_intern_acquire(const char* string, size_t length);
+
+/**
+ * Drop a reference to an interned string. When the last reference is gone it is retired, and recycled by a later call
+ * to fa_intern_reclaim.
+ * @param string A pointer returned by fa_intern_acquire.
+ */
+void fa_intern_release(const char* string);
+
+/**
+ * Recycle strings which were retired before the previous call.
+ */
+void fa_intern_reclaim();
\ No newline at end of file
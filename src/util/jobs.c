@@ -0,0 +1,390 @@
+/**
+ * @file jobs.c
+ * @author ItsHighNoon
+ * @date 10-17-2026
+ * 
+ * @copyright Copyright (c) 2026
+ */
+
+#include "jobs.h"
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdalign.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "util/arena.h"
+#include "util/option_names.h"
+#include "util/options.h"
+
+#define DEQUE_MASK (FA_JOBS_MAX_PENDING - 1)
+#define MAX_THREADS 256
+#define SPINS_BEFORE_SLEEP 64
+#define CACHE_LINE 64
+
+struct FA_JobStruct {
+    FA_JobFunction function;
+    void* data;
+    FA_JobCounter* counter;
+    // Links parked jobs on their dependency, and free slots once the job is done
+    struct FA_JobStruct* next_waiter;
+    int owner;
+};
+
+/*
+ * Chase-Lev deque. The owner pushes and pops at the bottom, everyone else steals from the top, and only the last job
+ * is contended.
+ */
+typedef struct {
+    alignas(CACHE_LINE) atomic_long top;
+    alignas(CACHE_LINE) atomic_long bottom;
+    _Atomic(FA_Job*) jobs[FA_JOBS_MAX_PENDING];
+} Deque;
+
+/*
+ * Jobs are allocated from the pool of the submitting thread and go back to it once they have run, which may happen on
+ * another thread. Those are pushed onto returned_jobs, and the owner takes the whole list at once when free_jobs runs
+ * dry, so it never pops a single job another thread could be pushing at the same time.
+ */
+typedef struct {
+    Deque deque;
+    FA_Job pool[FA_JOBS_MAX_PENDING];
+    FA_Job* free_jobs;
+    alignas(CACHE_LINE) _Atomic(FA_Job*) returned_jobs;
+    unsigned int steal_seed;
+    pthread_t thread;
+} Worker;
+
+static Worker* workers;
+static int thread_count;
+static _Thread_local int thread_index = -1;
+
+static atomic_int quit;
+
+/*
+ * Idle workers sleep on wake_cond. Every push bumps wake_epoch, and a worker only goes to sleep if the epoch has not
+ * changed since it last found nothing to do, so a push can never slip in between the check and the wait.
+ */
+static pthread_mutex_t wake_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t wake_cond = PTHREAD_COND_INITIALIZER;
+static atomic_uint wake_epoch;
+static atomic_int sleepers;
+
+static int deque_push(Deque* deque, FA_Job* job) {
+    long bottom = atomic_load_explicit(&deque->bottom, memory_order_relaxed);
+    long top = atomic_load_explicit(&deque->top, memory_order_acquire);
+    if (bottom - top >= FA_JOBS_MAX_PENDING) {
+        return -1;
+    }
+
+    atomic_store_explicit(&deque->jobs[bottom & DEQUE_MASK], job, memory_order_release);
+    atomic_thread_fence(memory_order_release);
+    atomic_store_explicit(&deque->bottom, bottom + 1, memory_order_relaxed);
+    return 0;
+}
+
+static FA_Job* deque_pop(Deque* deque) {
+    long bottom = atomic_load_explicit(&deque->bottom, memory_order_relaxed) - 1;
+    atomic_store_explicit(&deque->bottom, bottom, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+    long top = atomic_load_explicit(&deque->top, memory_order_relaxed);
+
+    if (top > bottom) {
+        atomic_store_explicit(&deque->bottom, bottom + 1, memory_order_relaxed);
+        return NULL;
+    }
+
+    FA_Job* job = atomic_load_explicit(&deque->jobs[bottom & DEQUE_MASK], memory_order_relaxed);
+    if (top == bottom) {
+        // Last job, race any thieves for it
+        if (!atomic_compare_exchange_strong_explicit(&deque->top, &top, top + 1, memory_order_seq_cst,
+                                                     memory_order_relaxed)) {
+            job = NULL;
+        }
+        atomic_store_explicit(&deque->bottom, bottom + 1, memory_order_relaxed);
+    }
+    return job;
+}
+
+static FA_Job* deque_steal(Deque* deque) {
+    long top = atomic_load_explicit(&deque->top, memory_order_acquire);
+    atomic_thread_fence(memory_order_seq_cst);
+    long bottom = atomic_load_explicit(&deque->bottom, memory_order_acquire);
+    if (top >= bottom) {
+        return NULL;
+    }
+
+    FA_Job* job = atomic_load_explicit(&deque->jobs[top & DEQUE_MASK], memory_order_acquire);
+    if (!atomic_compare_exchange_strong_explicit(&deque->top, &top, top + 1, memory_order_seq_cst,
+                                                 memory_order_relaxed)) {
+        return NULL;
+    }
+    return job;
+}
+
+static void wake_workers() {
+    atomic_fetch_add(&wake_epoch, 1);
+    if (atomic_load(&sleepers) > 0) {
+        pthread_mutex_lock(&wake_lock);
+        pthread_cond_broadcast(&wake_cond);
+        pthread_mutex_unlock(&wake_lock);
+    }
+}
+
+static void execute(FA_Job* job);
+
+static void submit(FA_Job* job) {
+    if (deque_push(&workers[thread_index].deque, job) != 0) {
+        // Too much in flight already
+        execute(job);
+        return;
+    }
+    wake_workers();
+}
+
+static void counter_lock(FA_JobCounter* counter) {
+    int expected = 0;
+    while (!atomic_compare_exchange_weak_explicit(&counter->lock, &expected, 1, memory_order_acquire,
+                                                  memory_order_relaxed)) {
+        expected = 0;
+        sched_yield();
+    }
+}
+
+static void counter_unlock(FA_JobCounter* counter) {
+    atomic_store_explicit(&counter->lock, 0, memory_order_release);
+}
+
+static void release_job(FA_Job* job) {
+    Worker* owner = &workers[job->owner];
+    if (job->owner == thread_index) {
+        job->next_waiter = owner->free_jobs;
+        owner->free_jobs = job;
+        return;
+    }
+
+    FA_Job* head = atomic_load_explicit(&owner->returned_jobs, memory_order_relaxed);
+    do {
+        job->next_waiter = head;
+    } while (!atomic_compare_exchange_weak_explicit(&owner->returned_jobs, &head, job, memory_order_release,
+                                                    memory_order_relaxed));
+}
+
+static void execute(FA_Job* job) {
+    job->function(job->data);
+
+    FA_JobCounter* counter = job->counter;
+    release_job(job);
+    if (counter == NULL) {
+        return;
+    }
+
+    /*
+     * Decrement under the lock, so fa_jobs_run_after never parks a job on a counter which already reached zero, and
+     * fa_jobs_wait does not return while the counter is still being touched here.
+     */
+    FA_Job* waiter = NULL;
+    counter_lock(counter);
+    if (atomic_fetch_sub_explicit(&counter->count, 1, memory_order_acq_rel) == 1) {
+        waiter = counter->waiters;
+        counter->waiters = NULL;
+    }
+    counter_unlock(counter);
+
+    while (waiter != NULL) {
+        FA_Job* next = waiter->next_waiter;
+        submit(waiter);
+        waiter = next;
+    }
+}
+
+// Returns NULL once every slot is queued, running or parked, the caller runs the job itself then
+static FA_Job* allocate_job(FA_JobFunction function, void* data, FA_JobCounter* counter) {
+    Worker* worker = &workers[thread_index];
+    if (worker->free_jobs == NULL) {
+        worker->free_jobs = atomic_exchange_explicit(&worker->returned_jobs, NULL, memory_order_acquire);
+        if (worker->free_jobs == NULL) {
+            return NULL;
+        }
+    }
+
+    FA_Job* job = worker->free_jobs;
+    worker->free_jobs = job->next_waiter;
+    job->function = function;
+    job->data = data;
+    job->counter = counter;
+    job->next_waiter = NULL;
+    if (counter != NULL) {
+        atomic_fetch_add_explicit(&counter->count, 1, memory_order_relaxed);
+    }
+    return job;
+}
+
+static FA_Job* find_job() {
+    Worker* self = &workers[thread_index];
+    FA_Job* job = deque_pop(&self->deque);
+    if (job != NULL || thread_count == 1) {
+        return job;
+    }
+
+    // Start stealing at a random victim so thieves spread out
+    self->steal_seed = self->steal_seed * 1103515245 + 12345;
+    int start = (self->steal_seed >> 16) % thread_count;
+    for (int offset = 0; offset < thread_count; offset++) {
+        int victim = (start + offset) % thread_count;
+        if (victim == thread_index) {
+            continue;
+        }
+        job = deque_steal(&workers[victim].deque);
+        if (job != NULL) {
+            return job;
+        }
+    }
+    return NULL;
+}
+
+static void* worker_main(void* arg) {
+    thread_index = (int)(long)arg;
+
+    int idle_spins = 0;
+    unsigned int epoch = atomic_load(&wake_epoch);
+    while (!atomic_load_explicit(&quit, memory_order_acquire)) {
+        FA_Job* job = find_job();
+        if (job != NULL) {
+            execute(job);
+            idle_spins = 0;
+            epoch = atomic_load(&wake_epoch);
+            continue;
+        }
+
+        if (++idle_spins < SPINS_BEFORE_SLEEP) {
+            sched_yield();
+            continue;
+        }
+
+        pthread_mutex_lock(&wake_lock);
+        atomic_fetch_add(&sleepers, 1);
+        while (atomic_load(&wake_epoch) == epoch && !atomic_load(&quit)) {
+            pthread_cond_wait(&wake_cond, &wake_lock);
+        }
+        atomic_fetch_sub(&sleepers, 1);
+        pthread_mutex_unlock(&wake_lock);
+        idle_spins = 0;
+        epoch = atomic_load(&wake_epoch);
+    }
+
+    _fa_arena_release_scratch();
+    return NULL;
+}
+
+void _fa_jobs_init() {
+    FA_OptionValue threads_value = fa_options_get_hashed(FA_OPTION_NAME_JOBS_THREADS);
+    if (threads_value.type == FA_OPTION_INT && threads_value.int_value > 0) {
+        thread_count = threads_value.int_value;
+    } else {
+        long cores = sysconf(_SC_NPROCESSORS_ONLN);
+        thread_count = cores > 0 ? (int)cores : 1;
+    }
+    if (thread_count > MAX_THREADS) {
+        thread_count = MAX_THREADS;
+    }
+
+    workers = aligned_alloc(alignof(Worker), thread_count * sizeof(Worker));
+    for (int worker_idx = 0; worker_idx < thread_count; worker_idx++) {
+        atomic_init(&workers[worker_idx].deque.top, 0);
+        atomic_init(&workers[worker_idx].deque.bottom, 0);
+        workers[worker_idx].free_jobs = NULL;
+        for (int job_idx = FA_JOBS_MAX_PENDING - 1; job_idx >= 0; job_idx--) {
+            workers[worker_idx].pool[job_idx].owner = worker_idx;
+            workers[worker_idx].pool[job_idx].next_waiter = workers[worker_idx].free_jobs;
+            workers[worker_idx].free_jobs = &workers[worker_idx].pool[job_idx];
+        }
+        atomic_init(&workers[worker_idx].returned_jobs, NULL);
+        workers[worker_idx].steal_seed = worker_idx + 1;
+    }
+
+    atomic_store(&quit, 0);
+    thread_index = 0;
+    for (int worker_idx = 1; worker_idx < thread_count; worker_idx++) {
+        pthread_create(&workers[worker_idx].thread, NULL, worker_main, (void*)(long)worker_idx);
+    }
+}
+
+void _fa_jobs_teardown() {
+    pthread_mutex_lock(&wake_lock);
+    atomic_store_explicit(&quit, 1, memory_order_release);
+    pthread_cond_broadcast(&wake_cond);
+    pthread_mutex_unlock(&wake_lock);
+
+    for (int worker_idx = 1; worker_idx < thread_count; worker_idx++) {
+        pthread_join(workers[worker_idx].thread, NULL);
+    }
+
+    free(workers);
+    workers = NULL;
+    thread_count = 0;
+    thread_index = -1;
+}
+
+static int deque_full(Deque* deque) {
+    long bottom = atomic_load_explicit(&deque->bottom, memory_order_relaxed);
+    long top = atomic_load_explicit(&deque->top, memory_order_acquire);
+    return bottom - top >= FA_JOBS_MAX_PENDING;
+}
+
+void fa_jobs_run(FA_JobFunction function, void* data, FA_JobCounter* counter) {
+    // Only the owner pushes, so a deque with room now still has room when submit pushes
+    FA_Job* job = NULL;
+    if (!deque_full(&workers[thread_index].deque)) {
+        job = allocate_job(function, data, counter);
+    }
+    if (job == NULL) {
+        // Too much in flight already
+        function(data);
+        return;
+    }
+    submit(job);
+}
+
+void fa_jobs_run_after(FA_JobCounter* dependency, FA_JobFunction function, void* data, FA_JobCounter* counter) {
+    FA_Job* job = allocate_job(function, data, counter);
+    if (job == NULL) {
+        // Nowhere to park it, so wait out the dependency here instead
+        fa_jobs_wait(dependency);
+        function(data);
+        return;
+    }
+
+    counter_lock(dependency);
+    if (atomic_load_explicit(&dependency->count, memory_order_acquire) != 0) {
+        job->next_waiter = dependency->waiters;
+        dependency->waiters = job;
+        job = NULL;
+    }
+    counter_unlock(dependency);
+
+    if (job != NULL) {
+        submit(job);
+    }
+}
+
+void fa_jobs_wait(FA_JobCounter* counter) {
+    while (atomic_load_explicit(&counter->count, memory_order_acquire) != 0
+           || atomic_load_explicit(&counter->lock, memory_order_acquire) != 0) {
+        FA_Job* job = find_job();
+        if (job != NULL) {
+            execute(job);
+        } else {
+            sched_yield();
+        }
+    }
+}
+
+int fa_jobs_thread_count() {
+    return thread_count;
+}
+
+int fa_jobs_thread_index() {
+    return thread_index;
+}
\ No newline at end of file
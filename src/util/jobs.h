@@ -0,0 +1,91 @@
+/**
+ * @file jobs.h
+ * @author ItsHighNoon
+ * @date 10-17-2026
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ * Work-stealing job system. The main thread runs jobs next to one worker per remaining core, and the jobs.threads
+ * option sets the total number of threads, main thread included. Every thread has a deque of its own jobs which the
+ * others steal from when they run dry.
+ *
+ * Jobs report completion through counters. Waiting on a counter runs other jobs in the meantime, so the main thread
+ * helps instead of blocking:
+ *
+ *     FA_JobCounter counter = {0};
+ *     for (int chunk_idx = 0; chunk_idx < chunk_count; chunk_idx++) {
+ *         fa_jobs_run(cull_chunk, &chunks[chunk_idx], &counter);
+ *     }
+ *     fa_jobs_run_after(&counter, build_batches, batches, &done);
+ *     fa_jobs_wait(&done);
+ *
+ * Jobs may only be submitted or waited for on the main thread or from inside other jobs. Each thread can have
+ * FA_JOBS_MAX_PENDING jobs in flight at once, submitting more runs them immediately on the submitting thread, after
+ * waiting for the dependency in the case of fa_jobs_run_after.
+ */
+
+#pragma once
+
+#include <stdatomic.h>
+
+#define FA_JOBS_MAX_PENDING 4096
+
+typedef void (*FA_JobFunction)(void* data);
+
+typedef struct FA_JobStruct FA_Job;
+
+/**
+ * Counts the jobs which still have to finish. Zero initialize before use, and only reuse once it is back at zero.
+ */
+typedef struct {
+    atomic_int count;
+    // Jobs started by fa_jobs_run_after once the count drops to zero, guarded by lock
+    atomic_int lock;
+    FA_Job* waiters;
+} FA_JobCounter;
+
+/**
+ * Start the workers. jobs.threads is the number of threads running jobs including the main thread, so one less
+ * worker is started. If it is not set to a positive int, there is one thread per core.
+ */
+void _fa_jobs_init();
+
+/**
+ * Stop the workers. Wait for every outstanding counter first, queued jobs are dropped.
+ */
+void _fa_jobs_teardown();
+
+/**
+ * Queue a job.
+ * @param function The function to run.
+ * @param data Passed to function.
+ * @param counter Incremented now and decremented once the job has finished. May be NULL.
+ */
+void fa_jobs_run(FA_JobFunction function, void* data, FA_JobCounter* counter);
+
+/**
+ * Queue a job once all jobs counted by another counter have finished.
+ * @param dependency The counter to wait for.
+ * @param function The function to run.
+ * @param data Passed to function.
+ * @param counter Incremented now and decremented once the job has finished. May be NULL.
+ */
+void fa_jobs_run_after(FA_JobCounter* dependency, FA_JobFunction function, void* data, FA_JobCounter* counter);
+
+/**
+ * Run jobs until a counter drops to zero.
+ * @param counter The counter to wait for.
+ */
+void fa_jobs_wait(FA_JobCounter* counter);
+
+/**
+ * Get the number of threads running jobs, including the main thread.
+ * @return The number of threads.
+ */
+int fa_jobs_thread_count();
+
+/**
+ * Get the index of the calling thread, for indexing per-thread data.
+ * @return 0 on the main thread, 1 up to fa_jobs_thread_count() - 1 on workers, -1 anywhere else.
+ */
+int fa_jobs_thread_index();
\ No newline at end of file
@@ -8,192 +8,847 @@
 
 #include "options.h"
 
+#include <pthread.h>
+#include <stdatomic.h>
 #include <stdlib.h>
 #include <string.h>
 
+#include "os/file.h"
+#include "util/intern.h"
 #include "util/util.h"
 
-#define HASH_BUCKETS 32
+#define INITIAL_INDEX_CAPACITY 64
+#define NAME_POOL_CHUNK 4096
 
-typedef struct HashTableEntryStruct {
-    char name[FA_OPTION_MAX_LENGTH];
+// Slots live in fixed pages so they never move while a reader is looking at them
+#define SLOT_PAGE_BITS 8
+#define SLOT_PAGE_SIZE (1 << SLOT_PAGE_BITS)
+#define SLOT_PAGES 1024
+
+// "FAOS" in a little endian file. Bump the version whenever the layout or fa_util_hash changes.
+#define SNAPSHOT_MAGIC 0x534f4146
+#define SNAPSHOT_VERSION 3
+
+// Fibonacci hashing, spreads weak low bits across the whole index
+#define INDEX_SCRAMBLE 11400714819323198485ull
+
+// A value is copied in and out of its slot as whole words so readers never see a torn value
+#define VALUE_WORDS ((sizeof(FA_OptionValue) + sizeof(unsigned long long) - 1) / sizeof(unsigned long long))
+
+/*
+ * Whoever subscribed with a given callback and user data. A subscriber is marked dirty at most once however many of
+ * its options change, and is called back once by _fa_options_dispatch.
+ */
+typedef struct SubscriberStruct {
+    FA_OptionCallback callback;
+    void* user_data;
+    int dirty;
+    struct SubscriberStruct* next_dirty;
+    struct SubscriberStruct* next;
+} Subscriber;
+
+typedef struct SubscriptionStruct {
+    Subscriber* subscriber;
+    struct SubscriptionStruct* next;
+} Subscription;
+
+typedef struct {
+    const char* name;
+
+    // Only touched with write_lock held
+    Subscription* subscriptions;
+
+    // Seqlock. Odd while a writer is in the middle of an update. Half of it is the generation.
+    atomic_uint sequence;
+    _Atomic unsigned long long value_words[VALUE_WORDS];
+} OptionSlot;
+
+typedef struct {
+    _Atomic unsigned long hash;
+    // Written last when inserting, so a valid handle means the hash is valid too
+    atomic_int handle;
+} IndexEntry;
+
+typedef struct IndexTableStruct {
+    unsigned long capacity;
+    int shift;
+    struct IndexTableStruct* retired_next;
+    IndexEntry entries[];
+} IndexTable;
+
+/*
+ * Open addressing with linear probing. Options are never removed from the index, so there are no tombstones. Readers
+ * may still be probing a table after it has been replaced, so replaced tables are kept until teardown. Because the
+ * table doubles each time, they never add up to more than the live table.
+ */
+static _Atomic(IndexTable*) index_table;
+static IndexTable* retired_tables;
+
+// Slots are never removed, so a slot number is a stable handle
+static _Atomic(OptionSlot*) slot_pages[SLOT_PAGES];
+static atomic_int slots_len;
+
+// Names are packed into chunks which never move. The first bytes of each chunk point to the previous chunk.
+static char* name_pool;
+static size_t name_pool_used;
+static size_t name_pool_size;
+
+/*
+ * A snapshot file is a header, an array of entries and then one blob holding every name and string value, each null
+ * terminated. Everything is stored exactly as it is used, so loading is a bounds check followed by one pass over the
+ * entries. Names and strings are used in place, the mapping is kept until teardown.
+ */
+typedef struct {
+    unsigned int magic;
+    unsigned int version;
+    unsigned int count;
+    unsigned int strings_size;
+} SnapshotHeader;
+
+typedef struct {
+    unsigned long long hash;
+    unsigned int name_offset;
+    int type;
+    union {
+        int int_value;
+        float float_value;
+        unsigned int string_offset;
+    };
+    int string_length;
+} SnapshotEntry;
+
+static const char* snapshot_data;
+static size_t snapshot_size;
+static char* snapshot_path;
+
+static Subscriber* subscribers;
+static Subscriber* dirty_subscribers;
+// The dirty list taken by _fa_options_dispatch, which writers may start relinking as soon as it lets go of the lock
+static Subscriber** dispatching;
+static int dispatching_capacity;
+
+// Serializes every writer. Readers never take it.
+static pthread_mutex_t write_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static unsigned long home_position(IndexTable* table, unsigned long hash) {
+    return (unsigned long)(((unsigned long long)hash * INDEX_SCRAMBLE) >> table->shift);
+}
+
+static const char* pool_name(const char* name, size_t length) {
+    if (name_pool == NULL || name_pool_used + length + 1 > name_pool_size) {
+        size_t chunk_size = NAME_POOL_CHUNK;
+        if (sizeof(char*) + length + 1 > chunk_size) {
+            chunk_size = sizeof(char*) + length + 1;
+        }
+        char* chunk = malloc(chunk_size);
+        memcpy(chunk, &name_pool, sizeof(char*));
+        name_pool = chunk;
+        name_pool_used = sizeof(char*);
+        name_pool_size = chunk_size;
+    }
+
+    char* pooled = name_pool + name_pool_used;
+    memcpy(pooled, name, length + 1);
+    name_pool_used += length + 1;
+    return pooled;
+}
+
+/*
+ * Replaced strings cannot be recycled right away because readers on other threads may still hold string_value. The
+ * intern pool keeps them for one full frame after their last reference is dropped, see _fa_options_reclaim. Inline
+ * strings need no cleanup, and strings pointing into the snapshot mapping were never interned.
+ */
+static void release_string(FA_OptionValue value) {
+    if (value.type != FA_OPTION_STRING || value.string_length < FA_OPTION_INLINE_STRING_LENGTH) {
+        return;
+    }
+    if (snapshot_data != NULL && value.string_value >= snapshot_data && value.string_value < snapshot_data + snapshot_size) {
+        return;
+    }
+    fa_intern_release(value.string_value);
+}
+
+static void index_insert(IndexTable* table, unsigned long hash, FA_OptionHandle handle) {
+    unsigned long mask = table->capacity - 1;
+    unsigned long position = home_position(table, hash);
+    while (atomic_load_explicit(&table->entries[position].handle, memory_order_relaxed) != FA_OPTION_INVALID_HANDLE) {
+        position = (position + 1) & mask;
+    }
+    atomic_store_explicit(&table->entries[position].hash, hash, memory_order_relaxed);
+    atomic_store_explicit(&table->entries[position].handle, handle, memory_order_release);
+}
+
+static IndexTable* index_create(unsigned long capacity) {
+    IndexTable* table = malloc(sizeof(IndexTable) + capacity * sizeof(IndexEntry));
+    table->capacity = capacity;
+    table->shift = 64;
+    while (capacity > 1) {
+        capacity >>= 1;
+        table->shift--;
+    }
+    table->retired_next = NULL;
+
+    for (unsigned long position = 0; position < table->capacity; position++) {
+        atomic_init(&table->entries[position].hash, 0);
+        atomic_init(&table->entries[position].handle, FA_OPTION_INVALID_HANDLE);
+    }
+    return table;
+}
+
+// Only called with write_lock held. Makes room for count options while keeping the load factor under 3/4.
+static void index_reserve(unsigned long count) {
+    IndexTable* old_table = atomic_load_explicit(&index_table, memory_order_relaxed);
+    unsigned long capacity = old_table->capacity;
+    while (count * 4 > capacity * 3) {
+        capacity *= 2;
+    }
+    if (capacity == old_table->capacity) {
+        return;
+    }
+
+    IndexTable* new_table = index_create(capacity);
+
+    for (unsigned long position = 0; position < old_table->capacity; position++) {
+        FA_OptionHandle handle = atomic_load_explicit(&old_table->entries[position].handle, memory_order_relaxed);
+        if (handle != FA_OPTION_INVALID_HANDLE) {
+            unsigned long hash = atomic_load_explicit(&old_table->entries[position].hash, memory_order_relaxed);
+            index_insert(new_table, hash, handle);
+        }
+    }
+
+    atomic_store_explicit(&index_table, new_table, memory_order_release);
+    old_table->retired_next = retired_tables;
+    retired_tables = old_table;
+}
+
+static OptionSlot* slot_for(FA_OptionHandle handle) {
+    if (handle < 0 || handle >= atomic_load_explicit(&slots_len, memory_order_acquire)) {
+        return NULL;
+    }
+    OptionSlot* page = atomic_load_explicit(&slot_pages[handle >> SLOT_PAGE_BITS], memory_order_relaxed);
+    return &page[handle & (SLOT_PAGE_SIZE - 1)];
+}
+
+static FA_OptionHandle find(const char* name, unsigned long hash) {
+    IndexTable* table = atomic_load_explicit(&index_table, memory_order_acquire);
+    unsigned long mask = table->capacity - 1;
+    for (unsigned long position = home_position(table, hash);; position = (position + 1) & mask) {
+        FA_OptionHandle handle = atomic_load_explicit(&table->entries[position].handle, memory_order_acquire);
+        if (handle == FA_OPTION_INVALID_HANDLE) {
+            return FA_OPTION_INVALID_HANDLE;
+        }
+        if (atomic_load_explicit(&table->entries[position].hash, memory_order_relaxed) == hash
+            && strcmp(name, slot_for(handle)->name) == 0) {
+            return handle;
+        }
+    }
+}
+
+static FA_OptionValue words_to_value(const unsigned long long* words) {
     FA_OptionValue value;
-    struct HashTableEntryStruct* next;
-    struct HashTableEntryStruct* prev;
-} HashTableEntry;
+    memcpy(&value, words, sizeof(value));
+    return value;
+}
+
+static FA_OptionValue read_value(OptionSlot* slot) {
+    unsigned long long words[VALUE_WORDS];
+    unsigned int sequence;
+    do {
+        sequence = atomic_load_explicit(&slot->sequence, memory_order_acquire);
+        for (int word_idx = 0; word_idx < VALUE_WORDS; word_idx++) {
+            words[word_idx] = atomic_load_explicit(&slot->value_words[word_idx], memory_order_relaxed);
+        }
+        atomic_thread_fence(memory_order_acquire);
+    } while ((sequence & 1) || sequence != atomic_load_explicit(&slot->sequence, memory_order_relaxed));
+
+    return words_to_value(words);
+}
+
+// Only called with write_lock held, so the value can be read without going through the seqlock
+static FA_OptionValue current_value(OptionSlot* slot) {
+    unsigned long long words[VALUE_WORDS];
+    for (int word_idx = 0; word_idx < VALUE_WORDS; word_idx++) {
+        words[word_idx] = atomic_load_explicit(&slot->value_words[word_idx], memory_order_relaxed);
+    }
+    return words_to_value(words);
+}
 
-static HashTableEntry* hash_table[HASH_BUCKETS];
+// Only called with write_lock held. Retires the string the slot used to hold, if any.
+static void write_value(OptionSlot* slot, FA_OptionValue value) {
+    FA_OptionValue old_value = current_value(slot);
 
-static HashTableEntry* find(const char* name, int bucket) {
-    if (bucket == -1) {
-        bucket = (fa_util_hash(name) % HASH_BUCKETS);
+    unsigned long long words[VALUE_WORDS];
+    memset(words, 0, sizeof(words));
+    memcpy(words, &value, sizeof(value));
+
+    unsigned int sequence = atomic_load_explicit(&slot->sequence, memory_order_relaxed);
+    atomic_store_explicit(&slot->sequence, sequence + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    for (int word_idx = 0; word_idx < VALUE_WORDS; word_idx++) {
+        atomic_store_explicit(&slot->value_words[word_idx], words[word_idx], memory_order_relaxed);
     }
-    
-    for (HashTableEntry* entry = hash_table[bucket]; entry != NULL; entry = entry->next) {
-        if (strcmp(name, entry->name) == 0) {
-            return entry;
+    atomic_store_explicit(&slot->sequence, sequence + 2, memory_order_release);
+
+    release_string(old_value);
+
+    for (Subscription* subscription = slot->subscriptions; subscription != NULL; subscription = subscription->next) {
+        Subscriber* subscriber = subscription->subscriber;
+        if (!subscriber->dirty) {
+            subscriber->dirty = 1;
+            subscriber->next_dirty = dirty_subscribers;
+            dirty_subscribers = subscriber;
         }
     }
+}
 
+static Subscriber* find_subscriber(FA_OptionCallback callback, void* user_data) {
+    for (Subscriber* subscriber = subscribers; subscriber != NULL; subscriber = subscriber->next) {
+        if (subscriber->callback == callback && subscriber->user_data == user_data) {
+            return subscriber;
+        }
+    }
     return NULL;
 }
 
+static void free_subscriptions(OptionSlot* slot) {
+    while (slot->subscriptions != NULL) {
+        Subscription* next = slot->subscriptions->next;
+        free(slot->subscriptions);
+        slot->subscriptions = next;
+    }
+}
+
+static FA_OptionValue make_value(int type) {
+    FA_OptionValue value;
+    memset(&value, 0, sizeof(value));
+    value.type = type;
+    return value;
+}
+
+// Only called with write_lock held, after checking the name is not in the index yet
+static FA_OptionHandle add_slot(const char* pooled_name, unsigned long hash) {
+    FA_OptionHandle handle = atomic_load_explicit(&slots_len, memory_order_relaxed);
+    if (handle >= SLOT_PAGES * SLOT_PAGE_SIZE) {
+        return FA_OPTION_INVALID_HANDLE;
+    }
+
+    // Fill in the new slot before anyone can find it
+    OptionSlot* page = atomic_load_explicit(&slot_pages[handle >> SLOT_PAGE_BITS], memory_order_relaxed);
+    if (page == NULL) {
+        page = malloc(SLOT_PAGE_SIZE * sizeof(OptionSlot));
+        atomic_store_explicit(&slot_pages[handle >> SLOT_PAGE_BITS], page, memory_order_relaxed);
+    }
+    OptionSlot* slot = &page[handle & (SLOT_PAGE_SIZE - 1)];
+    slot->name = pooled_name;
+    slot->subscriptions = NULL;
+    atomic_init(&slot->sequence, 0);
+    unsigned long long words[VALUE_WORDS];
+    memset(words, 0, sizeof(words));
+    FA_OptionValue unset = make_value(FA_OPTION_UNSET);
+    memcpy(words, &unset, sizeof(unset));
+    for (int word_idx = 0; word_idx < VALUE_WORDS; word_idx++) {
+        atomic_init(&slot->value_words[word_idx], words[word_idx]);
+    }
+    atomic_store_explicit(&slots_len, handle + 1, memory_order_release);
+
+    index_reserve(handle + 1);
+    index_insert(atomic_load_explicit(&index_table, memory_order_relaxed), hash, handle);
+    return handle;
+}
+
 void _fa_options_init() {
-    memset(hash_table, 0, sizeof(hash_table));
+    atomic_store(&index_table, index_create(INITIAL_INDEX_CAPACITY));
+    retired_tables = NULL;
+
+    for (int page_idx = 0; page_idx < SLOT_PAGES; page_idx++) {
+        atomic_store(&slot_pages[page_idx], NULL);
+    }
+    atomic_store(&slots_len, 0);
+
+    name_pool = NULL;
+    name_pool_used = 0;
+    name_pool_size = 0;
+
+    _fa_intern_init();
+
+    subscribers = NULL;
+    dirty_subscribers = NULL;
+
+    snapshot_data = NULL;
+    snapshot_size = 0;
+    snapshot_path = NULL;
 }
 
 void _fa_options_teardown() {
-    for (int bucket = 0; bucket < HASH_BUCKETS; bucket++) {
-        HashTableEntry* hash_entry = hash_table[bucket];
-        while (hash_entry != NULL) {
-            HashTableEntry* next = hash_entry->next;
-            if (hash_entry->value.type == FA_OPTION_STRING) {
-                free(hash_entry->value.string_value);
-            }
-            free(hash_entry);
-            hash_entry = next;
+    if (snapshot_path != NULL) {
+        fa_options_save_snapshot(snapshot_path);
+        free(snapshot_path);
+        snapshot_path = NULL;
+    }
+
+    int len = atomic_load(&slots_len);
+    for (int slot_idx = 0; slot_idx < len; slot_idx++) {
+        free_subscriptions(slot_for(slot_idx));
+    }
+    atomic_store(&slots_len, 0);
+    for (int page_idx = 0; page_idx < SLOT_PAGES; page_idx++) {
+        free(atomic_load(&slot_pages[page_idx]));
+        atomic_store(&slot_pages[page_idx], NULL);
+    }
+
+    // Every string which is not inline or in the snapshot is in the intern pool
+    _fa_intern_teardown();
+
+    if (snapshot_data != NULL) {
+        _fa_os_unmap_file(snapshot_data, snapshot_size);
+        snapshot_data = NULL;
+        snapshot_size = 0;
+    }
+
+    free(atomic_load(&index_table));
+    atomic_store(&index_table, NULL);
+    while (retired_tables != NULL) {
+        IndexTable* next = retired_tables->retired_next;
+        free(retired_tables);
+        retired_tables = next;
+    }
+
+    while (name_pool != NULL) {
+        char* previous;
+        memcpy(&previous, name_pool, sizeof(char*));
+        free(name_pool);
+        name_pool = previous;
+    }
+
+    while (subscribers != NULL) {
+        Subscriber* next = subscribers->next;
+        free(subscribers);
+        subscribers = next;
+    }
+    dirty_subscribers = NULL;
+    free(dispatching);
+    dispatching = NULL;
+    dispatching_capacity = 0;
+}
+
+void _fa_options_reclaim() {
+    pthread_mutex_lock(&write_lock);
+    fa_intern_reclaim();
+    pthread_mutex_unlock(&write_lock);
+}
+
+void _fa_options_dispatch() {
+    pthread_mutex_lock(&write_lock);
+    int dispatching_len = 0;
+    for (Subscriber* subscriber = dirty_subscribers; subscriber != NULL; subscriber = subscriber->next_dirty) {
+        if (dispatching_len == dispatching_capacity) {
+            dispatching_capacity = dispatching_capacity > 0 ? dispatching_capacity * 2 : 16;
+            dispatching = realloc(dispatching, dispatching_capacity * sizeof(Subscriber*));
+        }
+        dispatching[dispatching_len++] = subscriber;
+        subscriber->dirty = 0;
+    }
+    dirty_subscribers = NULL;
+    pthread_mutex_unlock(&write_lock);
+
+    /*
+     * Callbacks run without the lock so they can read and write options. Anything they change is dispatched next
+     * frame. Subscribers are only freed at teardown, so they stay valid even if a callback unsubscribes, and the
+     * callback is read under the lock so unsubscribing from another thread never races with the call.
+     */
+    for (int dispatching_idx = 0; dispatching_idx < dispatching_len; dispatching_idx++) {
+        pthread_mutex_lock(&write_lock);
+        FA_OptionCallback callback = dispatching[dispatching_idx]->callback;
+        void* user_data = dispatching[dispatching_idx]->user_data;
+        pthread_mutex_unlock(&write_lock);
+        if (callback != NULL) {
+            callback(user_data);
         }
     }
 }
 
-int fa_options_set_int(const char* name, int value) {
-    if (strlen(name) >= FA_OPTION_MAX_LENGTH) {
+int fa_options_subscribe(FA_OptionHandle handle, FA_OptionCallback callback, void* user_data) {
+    OptionSlot* slot = slot_for(handle);
+    if (slot == NULL || callback == NULL) {
         return 1;
     }
-    int bucket = (fa_util_hash(name) % HASH_BUCKETS);
-    
-    HashTableEntry* old_entry = find(name, bucket);
 
-    if (old_entry != NULL) {
-        // Already in the hash table, just set it
-        if (old_entry->value.type == FA_OPTION_STRING) {
-            free(old_entry->value.string_value);
-        }
-        old_entry->value.type = FA_OPTION_INT;
-        old_entry->value.int_value = value;
-    } else {
-        // Not in the hash table, make a new entry
-        HashTableEntry* new_entry = malloc(sizeof(HashTableEntry));
-        new_entry->value.type = FA_OPTION_INT;
-        new_entry->value.int_value = value;
-        strcpy(new_entry->name, name);
+    pthread_mutex_lock(&write_lock);
+    Subscriber* subscriber = find_subscriber(callback, user_data);
+    if (subscriber == NULL) {
+        subscriber = malloc(sizeof(Subscriber));
+        subscriber->callback = callback;
+        subscriber->user_data = user_data;
+        subscriber->dirty = 0;
+        subscriber->next_dirty = NULL;
+        subscriber->next = subscribers;
+        subscribers = subscriber;
+    }
 
-        new_entry->next = hash_table[bucket];
-        new_entry->prev = NULL;
-        hash_table[bucket] = new_entry;
-        if (new_entry->next != NULL) {
-            new_entry->next->prev = new_entry;
-        }
+    int already_subscribed = 0;
+    for (Subscription* subscription = slot->subscriptions; subscription != NULL; subscription = subscription->next) {
+        already_subscribed = already_subscribed || subscription->subscriber == subscriber;
+    }
+    if (!already_subscribed) {
+        Subscription* subscription = malloc(sizeof(Subscription));
+        subscription->subscriber = subscriber;
+        subscription->next = slot->subscriptions;
+        slot->subscriptions = subscription;
     }
+    pthread_mutex_unlock(&write_lock);
 
     return 0;
 }
 
-int fa_options_set_float(const char* name, float value) {
-    if (strlen(name) >= FA_OPTION_MAX_LENGTH) {
+void fa_options_unsubscribe(FA_OptionCallback callback, void* user_data) {
+    pthread_mutex_lock(&write_lock);
+    Subscriber* subscriber = find_subscriber(callback, user_data);
+    if (subscriber != NULL) {
+        int len = atomic_load_explicit(&slots_len, memory_order_relaxed);
+        for (int slot_idx = 0; slot_idx < len; slot_idx++) {
+            Subscription** link = &slot_for(slot_idx)->subscriptions;
+            while (*link != NULL) {
+                if ((*link)->subscriber == subscriber) {
+                    Subscription* removed = *link;
+                    *link = removed->next;
+                    free(removed);
+                } else {
+                    link = &(*link)->next;
+                }
+            }
+        }
+
+        // Keep the subscriber around in case it is already queued for dispatch, it will just do nothing
+        subscriber->callback = NULL;
+        subscriber->user_data = NULL;
+    }
+    pthread_mutex_unlock(&write_lock);
+}
+
+const char* fa_options_string(const FA_OptionValue* value) {
+    if (value->type != FA_OPTION_STRING) {
+        return NULL;
+    }
+    if (value->string_length < FA_OPTION_INLINE_STRING_LENGTH) {
+        return value->string_inline;
+    }
+    return value->string_value;
+}
+
+FA_OptionHandle fa_options_register(const char* name) {
+    return fa_options_register_hashed(name, fa_util_hash(name));
+}
+
+FA_OptionHandle fa_options_register_hashed(const char* name, unsigned long hash) {
+    size_t length = strlen(name);
+    if (length >= FA_OPTION_MAX_LENGTH) {
+        return FA_OPTION_INVALID_HANDLE;
+    }
+
+    FA_OptionHandle handle = find(name, hash);
+    if (handle != FA_OPTION_INVALID_HANDLE) {
+        return handle;
+    }
+
+    pthread_mutex_lock(&write_lock);
+
+    // Someone else may have registered it while we were waiting
+    handle = find(name, hash);
+    if (handle == FA_OPTION_INVALID_HANDLE) {
+        handle = add_slot(pool_name(name, length), hash);
+    }
+
+    pthread_mutex_unlock(&write_lock);
+    return handle;
+}
+
+FA_OptionHandle fa_options_lookup(const char* name) {
+    return find(name, fa_util_hash(name));
+}
+
+FA_OptionHandle fa_options_lookup_hashed(const char* name, unsigned long hash) {
+    return find(name, hash);
+}
+
+int fa_options_handle_set_int(FA_OptionHandle handle, int value) {
+    OptionSlot* slot = slot_for(handle);
+    if (slot == NULL) {
         return 1;
     }
-    int bucket = (fa_util_hash(name) % HASH_BUCKETS);
-    
-    HashTableEntry* old_entry = find(name, bucket);
 
-    if (old_entry != NULL) {
-        // Already in the hash table, just set it
-        if (old_entry->value.type == FA_OPTION_STRING) {
-            free(old_entry->value.string_value);
-        }
-        old_entry->value.type = FA_OPTION_FLOAT;
-        old_entry->value.float_value = value;
-    } else {
-        // Not in the hash table, make a new entry
-        HashTableEntry* new_entry = malloc(sizeof(HashTableEntry));
-        new_entry->value.type = FA_OPTION_INT;
-        new_entry->value.float_value = value;
-        strcpy(new_entry->name, name);
+    pthread_mutex_lock(&write_lock);
+    FA_OptionValue old_value = current_value(slot);
+    if (old_value.type != FA_OPTION_INT || old_value.int_value != value) {
+        FA_OptionValue new_value = make_value(FA_OPTION_INT);
+        new_value.int_value = value;
+        write_value(slot, new_value);
+    }
+    pthread_mutex_unlock(&write_lock);
 
-        new_entry->next = hash_table[bucket];
-        new_entry->prev = NULL;
-        hash_table[bucket] = new_entry;
-        if (new_entry->next != NULL) {
-            new_entry->next->prev = new_entry;
-        }
+    return 0;
+}
+
+int fa_options_handle_set_float(FA_OptionHandle handle, float value) {
+    OptionSlot* slot = slot_for(handle);
+    if (slot == NULL) {
+        return 1;
+    }
+
+    pthread_mutex_lock(&write_lock);
+    FA_OptionValue old_value = current_value(slot);
+    if (old_value.type != FA_OPTION_FLOAT || old_value.float_value != value) {
+        FA_OptionValue new_value = make_value(FA_OPTION_FLOAT);
+        new_value.float_value = value;
+        write_value(slot, new_value);
     }
+    pthread_mutex_unlock(&write_lock);
 
     return 0;
 }
 
-int fa_options_set_string(const char* name, const char* value) {
-    if (strlen(name) >= FA_OPTION_MAX_LENGTH) {
+int fa_options_handle_set_string(FA_OptionHandle handle, const char* value) {
+    OptionSlot* slot = slot_for(handle);
+    if (slot == NULL) {
         return 1;
     }
-    int bucket = (fa_util_hash(name) % HASH_BUCKETS);
-    
-    HashTableEntry* old_entry = find(name, bucket);
 
-    if (old_entry != NULL) {
-        // Already in the hash table, just set it
-        if (old_entry->value.type == FA_OPTION_STRING) {
-            free(old_entry->value.string_value);
+    pthread_mutex_lock(&write_lock);
+    FA_OptionValue old_value = current_value(slot);
+    if (old_value.type != FA_OPTION_STRING || strcmp(fa_options_string(&old_value), value) != 0) {
+        FA_OptionValue new_value = make_value(FA_OPTION_STRING);
+        new_value.string_length = strlen(value);
+        if (new_value.string_length < FA_OPTION_INLINE_STRING_LENGTH) {
+            memcpy(new_value.string_inline, value, new_value.string_length + 1);
+        } else {
+            new_value.string_value = fa_intern_acquire(value, new_value.string_length);
         }
-        old_entry->value.type = FA_OPTION_STRING;
-        old_entry->value.string_value = malloc(strlen(value) + 1);
-        strcpy(old_entry->value.string_value, value);
-    } else {
-        // Not in the hash table, make a new entry
-        HashTableEntry* new_entry = malloc(sizeof(HashTableEntry));
-        new_entry->value.type = FA_OPTION_STRING;
-        new_entry->value.string_value = malloc(strlen(value) + 1);
-        strcpy(new_entry->value.string_value, value);
-        strcpy(new_entry->name, name);
+        write_value(slot, new_value);
+    }
+    pthread_mutex_unlock(&write_lock);
 
-        new_entry->next = hash_table[bucket];
-        new_entry->prev = NULL;
-        hash_table[bucket] = new_entry;
-        if (new_entry->next != NULL) {
-            new_entry->next->prev = new_entry;
-        }
+    return 0;
+}
+
+int fa_options_handle_unset(FA_OptionHandle handle) {
+    OptionSlot* slot = slot_for(handle);
+    if (slot == NULL) {
+        return 1;
     }
 
+    pthread_mutex_lock(&write_lock);
+    if (current_value(slot).type != FA_OPTION_UNSET) {
+        write_value(slot, make_value(FA_OPTION_UNSET));
+    }
+    pthread_mutex_unlock(&write_lock);
+
     return 0;
 }
 
+FA_OptionValue fa_options_handle_get(FA_OptionHandle handle) {
+    OptionSlot* slot = slot_for(handle);
+    if (slot == NULL) {
+        return make_value(FA_OPTION_UNSET);
+    }
+    return read_value(slot);
+}
+
+unsigned int fa_options_handle_generation(FA_OptionHandle handle) {
+    OptionSlot* slot = slot_for(handle);
+    if (slot == NULL) {
+        return 0;
+    }
+    return atomic_load_explicit(&slot->sequence, memory_order_acquire) >> 1;
+}
+
+int fa_options_set_int(const char* name, int value) {
+    return fa_options_handle_set_int(fa_options_register(name), value);
+}
+
+int fa_options_set_float(const char* name, float value) {
+    return fa_options_handle_set_float(fa_options_register(name), value);
+}
+
+int fa_options_set_string(const char* name, const char* value) {
+    return fa_options_handle_set_string(fa_options_register(name), value);
+}
+
 int fa_options_unset(const char* name) {
     if (strlen(name) >= FA_OPTION_MAX_LENGTH) {
         return 1;
     }
-    int bucket = (fa_util_hash(name) % HASH_BUCKETS);
-    
-    HashTableEntry* entry = find(name, bucket);
 
-    if (entry != NULL) {
-        if (entry->value.type == FA_OPTION_STRING) {
-            free(entry->value.string_value);
+    // Options that were never registered are already unset
+    FA_OptionHandle handle = fa_options_lookup(name);
+    if (handle != FA_OPTION_INVALID_HANDLE) {
+        fa_options_handle_unset(handle);
+    }
+
+    return 0;
+}
+
+FA_OptionValue fa_options_get(const char* name) {
+    return fa_options_handle_get(fa_options_lookup(name));
+}
+
+FA_OptionValue fa_options_get_hashed(const char* name, unsigned long hash) {
+    return fa_options_handle_get(find(name, hash));
+}
+
+int fa_options_load_snapshot(const char* path) {
+    // Remember the path even if loading fails, so the first run creates the snapshot
+    free(snapshot_path);
+    snapshot_path = malloc(strlen(path) + 1);
+    strcpy(snapshot_path, path);
+
+    if (snapshot_data != NULL) {
+        return 1;
+    }
+
+    size_t size;
+    const char* data = _fa_os_map_file(path, &size);
+    if (data == NULL) {
+        return 1;
+    }
+
+    SnapshotHeader header;
+    if (size < sizeof(header)) {
+        _fa_os_unmap_file(data, size);
+        return 1;
+    }
+    memcpy(&header, data, sizeof(header));
+    size_t strings_start = sizeof(header) + (size_t)header.count * sizeof(SnapshotEntry);
+    if (header.magic != SNAPSHOT_MAGIC
+        || header.version != SNAPSHOT_VERSION
+        || header.strings_size == 0
+        || strings_start + header.strings_size != size
+        || data[size - 1] != '\0') {
+        _fa_os_unmap_file(data, size);
+        return 1;
+    }
+
+    const SnapshotEntry* entries = (const SnapshotEntry*)(data + sizeof(header));
+    const char* strings = data + strings_start;
+
+    pthread_mutex_lock(&write_lock);
+    snapshot_data = data;
+    snapshot_size = size;
+    index_reserve(atomic_load_explicit(&slots_len, memory_order_relaxed) + header.count);
+
+    for (unsigned int entry_idx = 0; entry_idx < header.count; entry_idx++) {
+        const SnapshotEntry* entry = &entries[entry_idx];
+        if (entry->name_offset >= header.strings_size
+            || (entry->type == FA_OPTION_STRING
+                && (entry->string_length < 0
+                    || (size_t)entry->string_offset + entry->string_length >= header.strings_size))) {
+            continue;
         }
 
-        // Remove from the hash table
-        if (entry->prev != NULL) {
-            entry->prev->next = entry->next;
-        } else {
-            hash_table[bucket] = entry->next;
+        const char* name = strings + entry->name_offset;
+        FA_OptionHandle handle = find(name, entry->hash);
+        if (handle == FA_OPTION_INVALID_HANDLE) {
+            handle = add_slot(name, entry->hash);
         }
-        if (entry->next != NULL) {
-            entry->next->prev = entry->prev;
+        if (handle == FA_OPTION_INVALID_HANDLE) {
+            break;
         }
 
-        free(entry);
+        FA_OptionValue value = make_value(entry->type);
+        switch (entry->type) {
+        case FA_OPTION_INT:
+            value.int_value = entry->int_value;
+            break;
+        case FA_OPTION_FLOAT:
+            value.float_value = entry->float_value;
+            break;
+        case FA_OPTION_STRING:
+            value.string_length = entry->string_length;
+            if (value.string_length < FA_OPTION_INLINE_STRING_LENGTH) {
+                memcpy(value.string_inline, strings + entry->string_offset, value.string_length + 1);
+            } else {
+                value.string_value = strings + entry->string_offset;
+            }
+            break;
+        default:
+            value.type = FA_OPTION_UNSET;
+            break;
+        }
+        write_value(slot_for(handle), value);
     }
+    pthread_mutex_unlock(&write_lock);
 
     return 0;
 }
 
-FA_OptionValue fa_options_get(const char* name) {
-    HashTableEntry* entry = find(name, -1);
+int fa_options_save_snapshot(const char* path) {
+    pthread_mutex_lock(&write_lock);
+
+    int len = atomic_load_explicit(&slots_len, memory_order_relaxed);
+    unsigned int count = 0;
+    size_t strings_size = 0;
+    for (int slot_idx = 0; slot_idx < len; slot_idx++) {
+        OptionSlot* slot = slot_for(slot_idx);
+        FA_OptionValue value = current_value(slot);
+        if (value.type == FA_OPTION_UNSET) {
+            continue;
+        }
+        count++;
+        strings_size += strlen(slot->name) + 1;
+        if (value.type == FA_OPTION_STRING) {
+            strings_size += value.string_length + 1;
+        }
+    }
+
+    size_t strings_start = sizeof(SnapshotHeader) + (size_t)count * sizeof(SnapshotEntry);
+    size_t size = strings_start + strings_size;
+    char* data = malloc(size);
+
+    SnapshotHeader header;
+    header.magic = SNAPSHOT_MAGIC;
+    header.version = SNAPSHOT_VERSION;
+    header.count = count;
+    header.strings_size = strings_size;
+    memcpy(data, &header, sizeof(header));
+
+    SnapshotEntry* entries = (SnapshotEntry*)(data + sizeof(header));
+    char* strings = data + strings_start;
+    size_t strings_used = 0;
+    unsigned int entry_idx = 0;
+    for (int slot_idx = 0; slot_idx < len; slot_idx++) {
+        OptionSlot* slot = slot_for(slot_idx);
+        FA_OptionValue value = current_value(slot);
+        if (value.type == FA_OPTION_UNSET) {
+            continue;
+        }
+
+        SnapshotEntry* entry = &entries[entry_idx++];
+        memset(entry, 0, sizeof(SnapshotEntry));
+        entry->hash = fa_util_hash(slot->name);
+        entry->type = value.type;
+
+        size_t name_size = strlen(slot->name) + 1;
+        entry->name_offset = strings_used;
+        memcpy(strings + strings_used, slot->name, name_size);
+        strings_used += name_size;
+
+        if (value.type == FA_OPTION_INT) {
+            entry->int_value = value.int_value;
+        } else if (value.type == FA_OPTION_FLOAT) {
+            entry->float_value = value.float_value;
+        } else {
+            entry->string_offset = strings_used;
+            entry->string_length = value.string_length;
+            memcpy(strings + strings_used, fa_options_string(&value), value.string_length + 1);
+            strings_used += value.string_length + 1;
+        }
+    }
+
+    pthread_mutex_unlock(&write_lock);
 
-    if (entry != NULL) {
-        return entry->value;
-    } else {
-        FA_OptionValue dummy;
-        dummy.type = FA_OPTION_UNSET;
-        return dummy;
+    int result = 0;
+    // An empty snapshot would fail validation, there is nothing worth writing anyway
+    if (count > 0) {
+        result = _fa_os_write_file_atomic(path, data, size);
     }
+    free(data);
+    return result;
 }
\ No newline at end of file
@@ -6,6 +6,13 @@
  * @copyright Copyright (c) 2025
  * 
  * Options management, similar to Quake/Source cvars.
+ *
+ * Options can be read from any thread without blocking. Writes are serialized against each other but never block
+ * readers.
+ *
+ * Names listed in util/option_names.txt get a macro in the generated util/option_names.h which expands to the name and
+ * its hash, for use with the *_hashed functions. For example fa_options_get_hashed(FA_OPTION_NAME_WINDOW_WIDTH) finds
+ * window.width without hashing anything at runtime.
  */
 
 #pragma once
@@ -15,9 +22,12 @@
 #define FA_OPTION_FLOAT 2
 #define FA_OPTION_STRING 3
 
-// The maximum length of an option name. Has an impact on memory footprint.
+// The maximum length of an option name. Names are pooled, so this does not affect memory footprint.
 #define FA_OPTION_MAX_LENGTH 224
 
+// Strings shorter than this are stored inside FA_OptionValue itself. Has an impact on memory footprint.
+#define FA_OPTION_INLINE_STRING_LENGTH 16
+
 typedef struct {
     /**
      * One of the following:
@@ -27,6 +37,12 @@ typedef struct {
      * - FA_OPTION_STRING
      */
     int type;
+
+    /**
+     * The length of the value stored here, if type is FA_OPTION_STRING.
+     */
+    int string_length;
+
     union {
         /**
          * The value stored here, if type is FA_OPTION_INT.
@@ -39,16 +55,50 @@ typedef struct {
         float float_value;
 
         /**
-         * A pointer to the value stored here, if type is FA_OPTION_STRING.
+         * A pointer to the value stored here, if type is FA_OPTION_STRING and string_length is at least
+         * FA_OPTION_INLINE_STRING_LENGTH. Stays valid until the end of the frame after the one in which the option is
+         * changed, see _fa_options_reclaim. Prefer fa_options_string, which handles both cases.
          */
-        char* string_value;
+        const char* string_value;
+
+        /**
+         * The value stored here, if type is FA_OPTION_STRING and string_length is less than
+         * FA_OPTION_INLINE_STRING_LENGTH. Null terminated.
+         */
+        char string_inline[FA_OPTION_INLINE_STRING_LENGTH];
     };
 } FA_OptionValue;
 
+/**
+ * A stable reference to an option slot. Resolving a name to a handle hashes the name once; reading or writing through
+ * the handle afterwards is a single array access. Handles stay valid until _fa_options_teardown, even if the option is
+ * unset.
+ */
+typedef int FA_OptionHandle;
+
+#define FA_OPTION_INVALID_HANDLE -1
+
+/**
+ * Called when an option that was subscribed to has changed.
+ * @param user_data The pointer that was passed to fa_options_subscribe.
+ */
+typedef void (*FA_OptionCallback)(void* user_data);
+
 void _fa_options_init();
 
 void _fa_options_teardown();
 
+/**
+ * Recycle strings which were replaced before the previous call. Called once per frame from the main loop, which gives any
+ * reader still holding a string_value at least one frame to finish with it.
+ */
+void _fa_options_reclaim();
+
+/**
+ * Call every subscriber whose options changed since the last dispatch. Called once per frame from the main loop.
+ */
+void _fa_options_dispatch();
+
 /**
  * Set the value of a global option to the specified integer.
  * @param name The name of the option. Assumed to be null terminated.
@@ -68,7 +118,7 @@ int fa_options_set_float(const char* name, float value);
 /**
  * Set the value of a global option to the specified string.
  * @param name The name of the option. Assumed to be null terminated.
- * @param value The desired value of the option. Will be copied to a new location. Assumed to be null terminated.
+ * @param value The desired value of the option. Will be copied inline or interned. Assumed to be null terminated.
  * @return 0 on success, 1 if name is too long.
  */
 int fa_options_set_string(const char* name, const char* value);
@@ -85,4 +135,131 @@ int fa_options_unset(const char* name);
  * @param name The name of the option. Assumed to be null terminated.
  * @return The value of the requested parameter. See FA_Value. Will be FA_OPTION_UNSET if the option is not set or if name is too long.
  */
-FA_OptionValue fa_options_get(const char* name);
\ No newline at end of file
+FA_OptionValue fa_options_get(const char* name);
+
+/**
+ * Same as fa_options_get, with the hash of the name already computed.
+ * @param name The name of the option. Assumed to be null terminated.
+ * @param hash fa_util_hash of name, usually from util/option_names.h.
+ * @return The value of the requested parameter. Will be FA_OPTION_UNSET if the option is not set.
+ */
+FA_OptionValue fa_options_get_hashed(const char* name, unsigned long hash);
+
+/**
+ * Get the string stored in an option value, wherever it is stored.
+ * @param value A value returned by fa_options_get or fa_options_handle_get.
+ * @return A pointer to the string, or NULL if type is not FA_OPTION_STRING. If the string was stored inline, the pointer
+ * is only valid as long as value is.
+ */
+const char* fa_options_string(const FA_OptionValue* value);
+
+/**
+ * Get a handle to a global option, creating an unset slot for it if it does not exist yet.
+ * @param name The name of the option. Assumed to be null terminated.
+ * @return A handle to the option, or FA_OPTION_INVALID_HANDLE if name is too long.
+ */
+FA_OptionHandle fa_options_register(const char* name);
+
+/**
+ * Same as fa_options_register, with the hash of the name already computed.
+ * @param name The name of the option. Assumed to be null terminated.
+ * @param hash fa_util_hash of name, usually from util/option_names.h.
+ * @return A handle to the option, or FA_OPTION_INVALID_HANDLE if name is too long.
+ */
+FA_OptionHandle fa_options_register_hashed(const char* name, unsigned long hash);
+
+/**
+ * Get a handle to a global option without creating it.
+ * @param name The name of the option. Assumed to be null terminated.
+ * @return A handle to the option, or FA_OPTION_INVALID_HANDLE if it was never set or registered.
+ */
+FA_OptionHandle fa_options_lookup(const char* name);
+
+/**
+ * Same as fa_options_lookup, with the hash of the name already computed.
+ * @param name The name of the option. Assumed to be null terminated.
+ * @param hash fa_util_hash of name, usually from util/option_names.h.
+ * @return A handle to the option, or FA_OPTION_INVALID_HANDLE if it was never set or registered.
+ */
+FA_OptionHandle fa_options_lookup_hashed(const char* name, unsigned long hash);
+
+/**
+ * Set the value of the option behind a handle to the specified integer.
+ * @param handle A handle returned by fa_options_register or fa_options_lookup.
+ * @param value The desired value of the option.
+ * @return 0 on success, 1 if handle is invalid.
+ */
+int fa_options_handle_set_int(FA_OptionHandle handle, int value);
+
+/**
+ * Set the value of the option behind a handle to the specified float.
+ * @param handle A handle returned by fa_options_register or fa_options_lookup.
+ * @param value The desired value of the option.
+ * @return 0 on success, 1 if handle is invalid.
+ */
+int fa_options_handle_set_float(FA_OptionHandle handle, float value);
+
+/**
+ * Set the value of the option behind a handle to the specified string.
+ * @param handle A handle returned by fa_options_register or fa_options_lookup.
+ * @param value The desired value of the option. Will be copied inline or interned. Assumed to be null terminated.
+ * @return 0 on success, 1 if handle is invalid.
+ */
+int fa_options_handle_set_string(FA_OptionHandle handle, const char* value);
+
+/**
+ * Reset the option behind a handle to having no value. The handle stays valid.
+ * @param handle A handle returned by fa_options_register or fa_options_lookup.
+ * @return 0 on success, 1 if handle is invalid.
+ */
+int fa_options_handle_unset(FA_OptionHandle handle);
+
+/**
+ * Get the value of the option behind a handle.
+ * @param handle A handle returned by fa_options_register or fa_options_lookup.
+ * @return The value of the option. Will be FA_OPTION_UNSET if the option is not set or if handle is invalid.
+ */
+FA_OptionValue fa_options_handle_get(FA_OptionHandle handle);
+
+/**
+ * Get the generation of the option behind a handle. The generation changes every time the value of the option
+ * changes, so comparing it against a remembered generation tells whether the option needs to be read again.
+ * @param handle A handle returned by fa_options_register or fa_options_lookup.
+ * @return The generation of the option, or 0 if handle is invalid.
+ */
+unsigned int fa_options_handle_generation(FA_OptionHandle handle);
+
+/**
+ * Get called back when an option changes. Changes are batched: however many times the option is set, and however many
+ * of the options subscribed to with the same callback and user data change, the callback runs at most once per frame,
+ * on the main thread.
+ * @param handle A handle returned by fa_options_register or fa_options_lookup.
+ * @param callback The function to call when the option changes.
+ * @param user_data Passed to callback. Together with callback, identifies the subscriber.
+ * @return 0 on success, 1 if handle is invalid or callback is NULL.
+ */
+int fa_options_subscribe(FA_OptionHandle handle, FA_OptionCallback callback, void* user_data);
+
+/**
+ * Stop getting called back for every option subscribed to with this callback and user data. Thread safe, but a call
+ * the main thread is already making is not waited for.
+ * @param callback The callback that was passed to fa_options_subscribe.
+ * @param user_data The user data that was passed to fa_options_subscribe.
+ */
+void fa_options_unsubscribe(FA_OptionCallback callback, void* user_data);
+
+/**
+ * Load every option stored in a snapshot written by fa_options_save_snapshot. The snapshot is mapped into memory and
+ * used in place, so loading does no parsing or allocation per option. Options in the snapshot replace options already
+ * set. The path is remembered even if loading fails, and the snapshot is written back there by _fa_options_teardown.
+ * @param path The path of the snapshot file. Assumed to be null terminated.
+ * @return 0 on success, 1 if the file is missing, invalid, or a snapshot is already loaded.
+ */
+int fa_options_load_snapshot(const char* path);
+
+/**
+ * Write every option that is set to a snapshot file, replacing it atomically.
+ * @param path The path of the snapshot file. Assumed to be null terminated.
+ * @return 0 on success, 1 if the file could not be written.
+ */
+int fa_options_save_snapshot(const char* path);
\ No newline at end of file
@@ -0,0 +1,400 @@
+/**
+ * @file profile.c
+ * @author ItsHighNoon
+ * @date 10-17-2026
+ * 
+ * @copyright Copyright (c) 2026
+ */
+
+#include "profile.h"
+
+#include <pthread.h>
+#include <stdalign.h>
+#include <stdarg.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "os/file.h"
+#include "util/jobs.h"
+#include "util/option_names.h"
+#include "util/options.h"
+#include "util/util.h"
+
+#define CAPTURE_PATH "profile_trace.json"
+// Must be a power of two
+#define EVENTS_PER_THREAD 16384
+#define EVENTS_MASK (EVENTS_PER_THREAD - 1)
+#define MAX_DEPTH 32
+// Must be a power of two
+#define MAX_ZONES 256
+#define CACHE_LINE 64
+// Trace tracks for threads that are not job threads, and for the GPU
+#define OTHER_TRACK_BASE 1000
+#define GPU_TRACK 2000
+
+struct ProfileEvent {
+    const char* name;
+    double start;
+    double end;
+};
+
+/*
+ * Finished zones of one thread. The thread appends and the main thread consumes once per frame, so it is a single
+ * producer single consumer ring, and a thread which records more than fits in one frame loses the excess.
+ */
+typedef struct ThreadEvents {
+    struct ProfileEvent events[EVENTS_PER_THREAD];
+    alignas(CACHE_LINE) atomic_long written;
+    alignas(CACHE_LINE) atomic_long read;
+    int track;
+    const char* open_names[MAX_DEPTH];
+    double open_starts[MAX_DEPTH];
+    int depth;
+    struct ThreadEvents* next;
+} ThreadEvents;
+
+struct Zone {
+    const char* name;
+    int gpu;
+    int calls;
+    double frame_total;
+    double history[FA_PROFILE_HISTORY];
+};
+
+struct CapturedEvent {
+    const char* name;
+    double start;
+    double end;
+    int track;
+};
+
+static pthread_mutex_t threads_lock = PTHREAD_MUTEX_INITIALIZER;
+static ThreadEvents* threads;
+static _Thread_local ThreadEvents* thread_events;
+static ThreadEvents* gpu_events;
+static int other_tracks;
+static atomic_long dropped_events;
+
+static struct Zone zones[MAX_ZONES];
+// Indices into zones by the address of the name, open addressing, -1 if empty
+static int zone_table[MAX_ZONES * 2];
+static int zones_len;
+static long frame_count;
+
+static struct CapturedEvent* captured;
+static long captured_len;
+static long captured_capacity;
+static int capture_frames_left;
+static int capture_frames_requested;
+static double capture_start;
+
+static ThreadEvents* create_events(int track) {
+    ThreadEvents* events = aligned_alloc(alignof(ThreadEvents), sizeof(ThreadEvents));
+    memset(events, 0, sizeof(ThreadEvents));
+    events->track = track;
+
+    pthread_mutex_lock(&threads_lock);
+    events->next = threads;
+    threads = events;
+    pthread_mutex_unlock(&threads_lock);
+    return events;
+}
+
+static void push_event(ThreadEvents* events, const char* name, double start, double end) {
+    long written = atomic_load_explicit(&events->written, memory_order_relaxed);
+    // A stale value only drops a few more events
+    if (written - atomic_load_explicit(&events->read, memory_order_acquire) >= EVENTS_PER_THREAD) {
+        atomic_fetch_add_explicit(&dropped_events, 1, memory_order_relaxed);
+        return;
+    }
+
+    struct ProfileEvent* event = &events->events[written & EVENTS_MASK];
+    event->name = name;
+    event->start = start;
+    event->end = end;
+    atomic_store_explicit(&events->written, written + 1, memory_order_release);
+}
+
+static struct Zone* find_zone(const char* name, int gpu) {
+    unsigned long slot = ((unsigned long)name >> 3) * 0x9e3779b97f4a7c15ul;
+    for (int probe_idx = 0; probe_idx < MAX_ZONES * 2; probe_idx++) {
+        int* entry = &zone_table[(slot + probe_idx) & (MAX_ZONES * 2 - 1)];
+        if (*entry < 0) {
+            if (zones_len == MAX_ZONES) {
+                return NULL;
+            }
+            *entry = zones_len;
+            memset(&zones[zones_len], 0, sizeof(struct Zone));
+            zones[zones_len].name = name;
+            zones[zones_len].gpu = gpu;
+            return &zones[zones_len++];
+        }
+        if (zones[*entry].name == name && zones[*entry].gpu == gpu) {
+            return &zones[*entry];
+        }
+    }
+    return NULL;
+}
+
+static void capture_event(const struct ProfileEvent* event, int track) {
+    if (captured_len == captured_capacity) {
+        captured_capacity = captured_capacity > 0 ? captured_capacity * 2 : 4096;
+        captured = realloc(captured, captured_capacity * sizeof(struct CapturedEvent));
+    }
+
+    struct CapturedEvent* capture = &captured[captured_len++];
+    capture->name = event->name;
+    capture->start = event->start;
+    capture->end = event->end;
+    capture->track = track;
+}
+
+static void collect(ThreadEvents* events) {
+    long written = atomic_load_explicit(&events->written, memory_order_acquire);
+    long read = atomic_load_explicit(&events->read, memory_order_relaxed);
+    for (long event_idx = read; event_idx < written; event_idx++) {
+        struct ProfileEvent* event = &events->events[event_idx & EVENTS_MASK];
+        struct Zone* zone = find_zone(event->name, events == gpu_events);
+        if (zone != NULL) {
+            zone->calls++;
+            zone->frame_total += event->end - event->start;
+        }
+        if (capture_frames_left > 0) {
+            capture_event(event, events->track);
+        }
+    }
+    atomic_store_explicit(&events->read, written, memory_order_release);
+}
+
+static const char* track_name(int track, char* buffer, size_t size) {
+    if (track == GPU_TRACK) {
+        return "GPU";
+    } else if (track == 0) {
+        return "Main thread";
+    } else if (track < OTHER_TRACK_BASE) {
+        snprintf(buffer, size, "Worker %d", track);
+    } else {
+        snprintf(buffer, size, "Thread %d", track - OTHER_TRACK_BASE);
+    }
+    return buffer;
+}
+
+struct TraceWriter {
+    char* data;
+    size_t len;
+    size_t capacity;
+};
+
+static void trace_printf(struct TraceWriter* writer, const char* format, ...) {
+    for (;;) {
+        va_list args;
+        va_start(args, format);
+        int written = vsnprintf(writer->data + writer->len, writer->capacity - writer->len, format, args);
+        va_end(args);
+        if (written >= 0 && writer->len + written < writer->capacity) {
+            writer->len += written;
+            return;
+        }
+        writer->capacity = writer->capacity > 0 ? writer->capacity * 2 : 65536;
+        writer->data = realloc(writer->data, writer->capacity);
+    }
+}
+
+// Zone names are code, but keep the file valid if one has a quote in it
+static void trace_name(struct TraceWriter* writer, const char* name) {
+    for (const char* c = name; *c != '\0'; c++) {
+        if (*c == '"' || *c == '\\') {
+            trace_printf(writer, "\\%c", *c);
+        } else if ((unsigned char)*c >= 0x20) {
+            trace_printf(writer, "%c", *c);
+        }
+    }
+}
+
+static void write_capture() {
+    struct TraceWriter writer;
+    memset(&writer, 0, sizeof(writer));
+    trace_printf(&writer, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+
+    int tracks_seen[MAX_ZONES];
+    int tracks_seen_len = 0;
+    for (long event_idx = 0; event_idx < captured_len; event_idx++) {
+        struct CapturedEvent* event = &captured[event_idx];
+
+        int seen = 0;
+        for (int track_idx = 0; track_idx < tracks_seen_len; track_idx++) {
+            seen = seen || tracks_seen[track_idx] == event->track;
+        }
+        if (seen == 0 && tracks_seen_len < MAX_ZONES) {
+            char buffer[32];
+            tracks_seen[tracks_seen_len++] = event->track;
+            trace_printf(&writer, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"%s\"}},\n",
+                         event->track, track_name(event->track, buffer, sizeof(buffer)));
+        }
+
+        trace_printf(&writer, "{\"name\":\"");
+        trace_name(&writer, event->name);
+        trace_printf(&writer, "\",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%d}%s\n",
+                     event->track == GPU_TRACK ? "gpu" : "cpu", (event->start - capture_start) * 1e6,
+                     (event->end - event->start) * 1e6, event->track, event_idx + 1 < captured_len ? "," : "");
+    }
+    trace_printf(&writer, "]}\n");
+
+    if (_fa_os_write_file_atomic(CAPTURE_PATH, writer.data, writer.len) != 0) {
+        printf("Failed to write %s :(\n", CAPTURE_PATH);
+    } else {
+        printf("Wrote %ld profile events to %s\n", captured_len, CAPTURE_PATH);
+    }
+    free(writer.data);
+}
+
+static void on_capture_frames_changed(void* user_data) {
+    FA_OptionValue frames_value = fa_options_get_hashed(FA_OPTION_NAME_PROFILE_CAPTURE_FRAMES);
+    if (capture_frames_left > 0 || frames_value.type != FA_OPTION_INT || frames_value.int_value <= 0) {
+        return;
+    }
+
+    // Starts at the next frame, so every captured frame is whole
+    capture_frames_requested = frames_value.int_value;
+}
+
+void _fa_profile_init() {
+    memset(zone_table, 0xff, sizeof(zone_table));
+    zones_len = 0;
+    frame_count = 0;
+    other_tracks = 0;
+    capture_frames_left = 0;
+    capture_frames_requested = 0;
+    gpu_events = create_events(GPU_TRACK);
+
+    FA_OptionValue frames_value = fa_options_get_hashed(FA_OPTION_NAME_PROFILE_CAPTURE_FRAMES);
+    if (frames_value.type != FA_OPTION_INT) {
+        fa_options_set_int("profile.capture_frames", 0);
+    }
+    on_capture_frames_changed(NULL);
+    fa_options_subscribe(fa_options_register_hashed(FA_OPTION_NAME_PROFILE_CAPTURE_FRAMES), on_capture_frames_changed,
+                         NULL);
+}
+
+void _fa_profile_teardown() {
+    fa_options_unsubscribe(on_capture_frames_changed, NULL);
+    if (capture_frames_left > 0) {
+        write_capture();
+        capture_frames_left = 0;
+    }
+    free(captured);
+    captured = NULL;
+    captured_capacity = 0;
+
+    // Every other thread which recorded zones has exited by now
+    pthread_mutex_lock(&threads_lock);
+    while (threads != NULL) {
+        ThreadEvents* next = threads->next;
+        free(threads);
+        threads = next;
+    }
+    pthread_mutex_unlock(&threads_lock);
+    thread_events = NULL;
+    gpu_events = NULL;
+}
+
+void _fa_profile_new_frame() {
+    for (int zone_idx = 0; zone_idx < zones_len; zone_idx++) {
+        zones[zone_idx].calls = 0;
+        zones[zone_idx].frame_total = 0.0;
+    }
+
+    pthread_mutex_lock(&threads_lock);
+    for (ThreadEvents* events = threads; events != NULL; events = events->next) {
+        collect(events);
+    }
+    pthread_mutex_unlock(&threads_lock);
+
+    for (int zone_idx = 0; zone_idx < zones_len; zone_idx++) {
+        zones[zone_idx].history[frame_count % FA_PROFILE_HISTORY] = zones[zone_idx].frame_total;
+    }
+    frame_count++;
+
+    if (capture_frames_left > 0) {
+        capture_frames_left--;
+        if (capture_frames_left == 0) {
+            write_capture();
+            long dropped = atomic_exchange(&dropped_events, 0);
+            if (dropped > 0) {
+                printf("Dropped %ld profile events, zones were too short or too many\n", dropped);
+            }
+            fa_options_set_int("profile.capture_frames", 0);
+        }
+    }
+
+    if (capture_frames_requested > 0) {
+        capture_frames_left = capture_frames_requested;
+        capture_frames_requested = 0;
+        capture_start = fa_util_time();
+        captured_len = 0;
+    }
+}
+
+void _fa_profile_add_gpu_zone(const char* name, double start, double end) {
+    push_event(gpu_events, name, start, end);
+}
+
+void fa_profile_begin(const char* name) {
+    ThreadEvents* events = thread_events;
+    if (events == NULL) {
+        int track = fa_jobs_thread_index();
+        if (track < 0) {
+            pthread_mutex_lock(&threads_lock);
+            track = OTHER_TRACK_BASE + other_tracks++;
+            pthread_mutex_unlock(&threads_lock);
+        }
+        events = create_events(track);
+        thread_events = events;
+    }
+
+    if (events->depth < MAX_DEPTH) {
+        events->open_names[events->depth] = name;
+        events->open_starts[events->depth] = fa_util_time();
+    }
+    events->depth++;
+}
+
+void fa_profile_end() {
+    ThreadEvents* events = thread_events;
+    events->depth--;
+    if (events->depth < MAX_DEPTH) {
+        push_event(events, events->open_names[events->depth], events->open_starts[events->depth], fa_util_time());
+    }
+}
+
+int fa_profile_zone_count() {
+    return zones_len;
+}
+
+void fa_profile_stats(int zone, FA_ProfileStats* stats) {
+    struct Zone* source = &zones[zone];
+    int frames = frame_count < FA_PROFILE_HISTORY ? (int)frame_count : FA_PROFILE_HISTORY;
+
+    stats->name = source->name;
+    stats->gpu = source->gpu;
+    stats->last = frame_count > 0 ? source->history[(frame_count - 1) % FA_PROFILE_HISTORY] : 0.0;
+    stats->calls = source->calls;
+    stats->average = 0.0;
+    stats->min = frames > 0 ? source->history[0] : 0.0;
+    stats->max = 0.0;
+    for (int frame_idx = 0; frame_idx < frames; frame_idx++) {
+        double time = source->history[frame_idx];
+        stats->average += time;
+        if (time < stats->min) {
+            stats->min = time;
+        }
+        if (time > stats->max) {
+            stats->max = time;
+        }
+    }
+    if (frames > 0) {
+        stats->average /= frames;
+    }
+}
\ No newline at end of file
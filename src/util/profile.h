@@ -0,0 +1,78 @@
+/**
+ * @file profile.h
+ * @author ItsHighNoon
+ * @date 10-17-2026
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ * Frame profiler. Zones are timed on any thread and collected once per frame into rolling statistics, and the GPU
+ * timings from render/vk/profile.h end up here too, converted to CPU time.
+ *
+ *     fa_profile_begin("physics");
+ *     step_physics();
+ *     fa_profile_end();
+ *
+ * Zones are told apart by the address of their name, so names should be string literals. Setting profile.capture_frames
+ * to N records every zone of the next N frames and writes them to profile_trace.json, which opens in Perfetto or
+ * chrome://tracing. The option goes back to 0 once the file is written.
+ */
+
+#pragma once
+
+// Frames the rolling statistics cover
+#define FA_PROFILE_HISTORY 64
+
+typedef struct FA_ProfileStats {
+    const char* name;
+    // Nonzero for zones timed on the GPU
+    int gpu;
+    // Time spent in the zone per frame, in seconds, over the last FA_PROFILE_HISTORY frames
+    double average;
+    double min;
+    double max;
+    // Time spent in the zone during the last frame
+    double last;
+    // Times the zone was entered during the last frame
+    int calls;
+} FA_ProfileStats;
+
+void _fa_profile_init();
+
+void _fa_profile_teardown();
+
+/**
+ * Collect the zones of the frame that just ended. Call on the main thread at the start of every frame.
+ */
+void _fa_profile_new_frame();
+
+/**
+ * Add a zone timed somewhere other than the CPU, such as the GPU. Call on the main thread.
+ * @param name The name of the zone.
+ * @param start When the zone started, in the timescale of fa_util_time.
+ * @param end When the zone ended, in the timescale of fa_util_time.
+ */
+void _fa_profile_add_gpu_zone(const char* name, double start, double end);
+
+/**
+ * Start timing a zone on the calling thread. Zones nest, and each must be ended on the thread that started it.
+ * @param name The name of the zone. Must stay valid until the profiler is torn down.
+ */
+void fa_profile_begin(const char* name);
+
+/**
+ * Stop timing the innermost zone of the calling thread.
+ */
+void fa_profile_end();
+
+/**
+ * Get the number of different zones seen so far.
+ * @return The number of zones, for iterating with fa_profile_stats.
+ */
+int fa_profile_zone_count();
+
+/**
+ * Get the statistics of a zone.
+ * @param zone The index of the zone, less than fa_profile_zone_count().
+ * @param stats Filled in with the statistics.
+ */
+void fa_profile_stats(int zone, FA_ProfileStats* stats);
\ No newline at end of file
@@ -8,11 +8,87 @@
 
 #include "util.h"
 
+#include <errno.h>
+#include <string.h>
+#include <time.h>
+
+// Odd constants with well mixed bits, from wyhash
+#define HASH_SEED 0xa0761d6478bd642full
+#define HASH_MULTIPLIER_A 0xe7037ed1a0b428dbull
+#define HASH_MULTIPLIER_B 0x8ebc6af09c88c6e3ull
+
+// Finalizer from MurmurHash3
+#define HASH_FINAL_A 0xff51afd7ed558ccdull
+#define HASH_FINAL_B 0xc4ceb9fe1a85ec53ull
+
+// Wakeups from sleep usually come within this many seconds of the requested time
+#define SLEEP_SPIN_TIME 0.0005
+
+static unsigned long long load_word(const unsigned char* bytes) {
+    // Compiles to a single unaligned load
+    unsigned long long word;
+    memcpy(&word, bytes, sizeof(word));
+    return word;
+}
+
+static unsigned long long mix_word(unsigned long long hash, unsigned long long word, unsigned long long multiplier) {
+    hash = (hash ^ word) * multiplier;
+    return hash ^ (hash >> 32);
+}
+
 unsigned long fa_util_hash(const char* string) {
-    unsigned long hash = 5381;
-    char c;
-    while ((c = *string++)) {
-        hash = ((hash << 5) + hash) + c;
+    return fa_util_hash_bytes(string, strlen(string));
+}
+
+unsigned long fa_util_hash_bytes(const void* data, size_t length) {
+    const unsigned char* bytes = data;
+    unsigned long long hash_a = HASH_SEED ^ (length * HASH_MULTIPLIER_A);
+    unsigned long long hash_b = HASH_SEED ^ (length * HASH_MULTIPLIER_B);
+
+    // Two independent lanes so the multiplies of consecutive words overlap
+    while (length >= 16) {
+        hash_a = mix_word(hash_a, load_word(bytes), HASH_MULTIPLIER_A);
+        hash_b = mix_word(hash_b, load_word(bytes + 8), HASH_MULTIPLIER_B);
+        bytes += 16;
+        length -= 16;
+    }
+    if (length >= 8) {
+        hash_a = mix_word(hash_a, load_word(bytes), HASH_MULTIPLIER_A);
+        bytes += 8;
+        length -= 8;
+    }
+    if (length > 0) {
+        unsigned long long tail = 0;
+        memcpy(&tail, bytes, length);
+        hash_b = mix_word(hash_b, tail, HASH_MULTIPLIER_B);
+    }
+
+    unsigned long long hash = hash_a ^ (hash_b * HASH_MULTIPLIER_A);
+    hash ^= hash >> 33;
+    hash *= HASH_FINAL_A;
+    hash ^= hash >> 33;
+    hash *= HASH_FINAL_B;
+    hash ^= hash >> 33;
+    return (unsigned long)hash;
+}
+
+double fa_util_time() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec * 1e-9;
+}
+
+void fa_util_sleep_until(double time) {
+    double sleep_end = time - SLEEP_SPIN_TIME;
+    if (sleep_end > fa_util_time()) {
+        struct timespec wake;
+        wake.tv_sec = (time_t)sleep_end;
+        wake.tv_nsec = (long)((sleep_end - wake.tv_sec) * 1e9);
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &wake, NULL) == EINTR) {
+            // Interrupted by a signal, any other error falls through to the spin
+        }
+    }
+    while (fa_util_time() < time) {
+        // Spin
     }
-    return hash;
 }
\ No newline at end of file
@@ -10,11 +10,40 @@
 
 #pragma once
 
+#include <stddef.h>
+
 /**
  * Hash a string to an unsigned long.
  *
- * https://stackoverflow.com/questions/7666509/hash-function-for-string
+ * Hashes whole words at a time, see fa_util_hash_bytes. The result is the same as hashing the string and its length.
  * @param string A pointer to the string to hash. Assumed to be null terminated.
  * @return The hashed string value.
  */
-unsigned long fa_util_hash(const char* string);
\ No newline at end of file
+unsigned long fa_util_hash(const char* string);
+
+/**
+ * Hash a buffer to an unsigned long.
+ *
+ * Reads 16 bytes per step in two independent multiply-xorshift lanes and finishes with the MurmurHash3 finalizer, so
+ * every bit of the result depends on every input byte and the result can be reduced to a power of two by masking. The
+ * result depends on the endianness of the machine.
+ * @param data A pointer to the bytes to hash.
+ * @param length The number of bytes to hash.
+ * @return The hashed value.
+ */
+unsigned long fa_util_hash_bytes(const void* data, size_t length);
+
+/**
+ * Get a monotonic timestamp.
+ * @return The current time in seconds, relative to an arbitrary point in the past.
+ */
+double fa_util_time();
+
+/**
+ * Block until a point in time.
+ *
+ * Sleeps for most of the wait and spins for the last fraction of a millisecond, since the scheduler may wake the
+ * thread late.
+ * @param time The time to wake up at, in the same timescale as fa_util_time.
+ */
+void fa_util_sleep_until(double time);
\ No newline at end of file